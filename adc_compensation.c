@@ -67,7 +67,7 @@ inline static uint16_t adcScaleVdc(uint16_t raw)
 */
 void MCAF_ADCRead(MCAF_MOTOR_DATA *pmotor)
 {
-    MCAF_ADCCurrentRead(&pmotor->currentMeasure, &pmotor->iabc);
+    MCAF_ADCCurrentRead(&pmotor->currentMeasure, pmotor->phal, &pmotor->iabc);
 
     MCAF_ADCApplyCurrentCompensation(&pmotor->currentCalibration, &pmotor->iabc);
 
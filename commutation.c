@@ -57,6 +57,8 @@
 
 
 #include "commutation/atpll.h"
+#include "commutation/qei.h"
+#include "commutation/hybrid.h"
 
 
 void MCAF_CommutationStep(MCAF_MOTOR_DATA *pmotor)
@@ -79,6 +81,53 @@ void MCAF_CommutationStep(MCAF_MOTOR_DATA *pmotor)
     }
     /* ---- sensorless, angle-tracking phase-locked loop (ATPLL) ---- */
 
+    /* ---- quadrature encoder (QEI) ---- */
+    if (MCAF_EncoderEnabled())
+    {
+        MCAF_ESTIMATOR_QEI_T *pqei = &pestimator->qei;
+        /* reading the count latches the interval timer, so it comes first */
+        const uint16_t count = HAL_QEI_PositionCountGet();
+        MCAF_EstimatorQeiStep(pqei,
+                              count,
+                              HAL_QEI_PositionCaptureGet(),
+                              HAL_QEI_IntervalTimerHoldGet());
+        if (!MCAF_EstimatorQeiIsAligned(pqei) 
+            && (MCAF_StartupGetStatus(&pmotor->startup) == MSST_ACCEL))
+        {
+            /* The align step has just ended, with the rotor d-axis 
+             * pulled onto the current vector. */
+            MCAF_EstimatorQeiAlign(pqei, 
+                pmotor->thetaElectrical + MCAF_StartupGetIdqCmdAngle(&pmotor->startup));
+        }
+        if (MCAF_EstimatorQeiIsActive(pestimator))
+        {
+            if (MCAF_HybridCommutationEnabled())
+            {
+                /* The ATPLL runs alongside the encoder at all times,
+                 * so it has locked by the time it takes over. */
+                MCAF_ESTIMATOR_HYBRID_T *phybrid = &pestimator->hybrid;
+                MCAF_EstimatorHybridStep(phybrid,
+                                         MCAF_EstimatorQeiCommutationAngle(pqei),
+                                         MCAF_EstimatorQeiElectricalFrequency(pqei),
+                                         MCAF_EstimatorAtPllCommutationAngle(&pestimator->atpll),
+                                         MCAF_EstimatorAtPllElectricalFrequency(&pestimator->atpll));
+                pestimator->theta = MCAF_EstimatorHybridCommutationAngle(phybrid);
+                pestimator->omega = MCAF_EstimatorHybridElectricalFrequency(phybrid);
+            }
+            else
+            {
+                pestimator->theta = MCAF_EstimatorQeiCommutationAngle(pqei);
+                pestimator->omega = MCAF_EstimatorQeiElectricalFrequency(pqei);
+            }
+            if (MCAF_StartupInOpenLoopCommutation(&pmotor->startup))
+            {
+                /* no need for open-loop commutation once the angle is known */
+                MCAF_StartupSkipToClosedLoop(&pmotor->startup);
+            }
+        }
+    }
+    /* ---- quadrature encoder (QEI) ---- */
+
     pmotor->startup.thetaElectricalEstimated = pmotor->estimator.theta;
     pmotor->startup.omegaElectricalEstimated = pmotor->estimator.omega;
 
@@ -115,10 +164,24 @@ void MCAF_CommutationStep(MCAF_MOTOR_DATA *pmotor)
     else
     {
         const int16_t motorDirection = UTIL_SignFromHighBit(pmotor->velocityControl.velocityCmd);
+        const MCAF_STARTUP_FSM_STATE startupState = pmotor->startup.state;
         MCAF_StartupTransitioningStep(&pmotor->startup,
             &pmotor->idqCmdRaw, 
             motorDirection
         );
+        if (pmotor->startup.state != startupState)
+        {
+            /* timestamps of these events give the duration of each startup phase */
+            MCAF_EventPublish(pmotor, MCAF_EVENT_STARTUP_PHASE, pmotor->startup.state);
+        }
+        if (startupState == SSM_CATCH && pmotor->startup.state == SSM_COMPLETE)
+        {
+            /* Flying restart: the velocity loop starts from the velocity
+             * the estimator has locked to. During the catch, omegaCmd stays
+             * at zero, so the estimator runs without a feedforward term
+             * rather than with its own output fed back. */
+            pmotor->omegaCmd = pmotor->estimator.omega;
+        }
 
         if (MCAF_StartupInOpenLoopCommutation(&pmotor->startup))
         {
@@ -155,6 +218,20 @@ void MCAF_CommutationStep(MCAF_MOTOR_DATA *pmotor)
 void MCAF_CommutationInit(MCAF_MOTOR_DATA *pmotor)
 {
     MCAF_EstimatorAtPllInit(&pmotor->estimator.atpll, &pmotor->motorParameters);
+    if (MCAF_EncoderEnabled())
+    {
+        /* The estimator needs a free-running position counter;
+         * the capture only changes if the index is connected. */
+        HAL_QEI_Initialize();
+        HAL_QEI_PositionCaptureInit();
+        HAL_QEI_IntervalTimerPrescaleSet(MCAF_QEI_INTERVAL_TIMER_PRESCALE);
+        HAL_QEI_Enable();
+        MCAF_EstimatorQeiInit(&pmotor->estimator.qei,
+                              HAL_QEI_PositionCountGet(),
+                              HAL_QEI_PositionCaptureGet(),
+                              HAL_QEI_IntervalTimerFrequencyGet(MCAF_QEI_INTERVAL_TIMER_PRESCALE));
+        MCAF_EstimatorHybridInit(&pmotor->estimator.hybrid);
+    }
 }
 
 void MCAF_CommutationStartupInit(MCAF_MOTOR_DATA *pmotor)
@@ -179,10 +256,21 @@ void MCAF_CommutationStartupInit(MCAF_MOTOR_DATA *pmotor)
 
     /* Allow estimators to re-initialize on startup */
     MCAF_EstimatorAtPllStartupInit(&pmotor->estimator.atpll);
+    if (MCAF_HybridCommutationEnabled())
+    {
+        MCAF_EstimatorHybridStartupInit(&pmotor->estimator.hybrid);
+    }
 }
 
 void MCAF_CommutationPrepareStallDetectInputs(MCAF_MOTOR_DATA *pmotor)
 {
 #if MCAF_INCLUDE_STALL_DETECT      
+    MCAF_STALL_DETECT_INPUT_T *pinputs = &pmotor->stallDetect.inputs;
+    const MCAF_U_VOLTAGE_DQ_Q14 *pesdq = &pmotor->estimator.atpll.esdq;
+    
+    /* ATPLL back-emf is Q14 */
+    pinputs->esdq.d = UTIL_SatAddS16(pesdq->d, pesdq->d);
+    pinputs->esdq.q = UTIL_SatAddS16(pesdq->q, pesdq->q);
+    pinputs->omegaElectrical = pmotor->omegaElectrical;
 #endif
-}
\ No newline at end of file
+}
\ No newline at end of file
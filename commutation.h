@@ -128,8 +128,8 @@ inline static void MCAF_CommutationStartupReinit(MCAF_MOTOR_DATA *pmotor)
 inline static void MCAF_CommutationRestart(MCAF_MOTOR_DATA *pmotor)
 {
     pmotor->velocityControl.slewRateLimit1     = VELOCITY_SLEWRATE_LIMIT1;
-    pmotor->velocityControl.slewRateLimitAccel = VELOCITY_SLEWRATE_LIMIT_ACCEL;
-    pmotor->velocityControl.slewRateLimitDecel = VELOCITY_SLEWRATE_LIMIT_DECEL;
+    pmotor->velocityControl.slewRateLimitAccel = pmotor->config.velocitySlewRateLimitAccel;
+    pmotor->velocityControl.slewRateLimitDecel = pmotor->config.velocitySlewRateLimitDecel;
     MCAF_CommutationStartupReinit(pmotor);
 }
  
@@ -0,0 +1,106 @@
+/**
+ * hybrid.c
+ * 
+ * Hosts components of hybrid commutation, which crossfades
+ * from the encoder at low velocity to the ATPLL at high velocity
+ * 
+ * Component: commutation
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "util.h"
+#include "parameters/qei_params.h"
+#include "hybrid.h"
+
+void MCAF_EstimatorHybridInit(MCAF_ESTIMATOR_HYBRID_T *phybrid)
+{
+    phybrid->weight = 0;
+    phybrid->thetaDifference = 0;
+    phybrid->thetaElectrical = 0;
+    phybrid->omegaElectrical = 0;
+    MCAF_EstimatorHybridStartupInit(phybrid);
+}
+
+void MCAF_EstimatorHybridStartupInit(MCAF_ESTIMATOR_HYBRID_T *phybrid)
+{
+    phybrid->mismatchCount = 0;
+    phybrid->mismatch = false;
+}
+
+void MCAF_EstimatorHybridStep(MCAF_ESTIMATOR_HYBRID_T *phybrid,
+                              MCAF_U_ANGLE_ELEC thetaEncoder,
+                              MCAF_U_VELOCITY_ELEC omegaEncoder,
+                              MCAF_U_ANGLE_ELEC thetaAtpll,
+                              MCAF_U_VELOCITY_ELEC omegaAtpll)
+{
+    const int16_t velocityAboveLow = UTIL_Abs16(omegaEncoder) - MCAF_HYBRID_VELOCITY_LOW;
+    const int32_t weight = UTIL_mulss(UTIL_LimitMinimumS16(velocityAboveLow, 0),
+                                      MCAF_HYBRID_CROSSFADE_GAIN) >> MCAF_HYBRID_CROSSFADE_GAIN_Q;
+    phybrid->weight = UTIL_LimitS32ToS16(weight, INT16_MAX);
+    
+    /* The angle difference wraps, so the crossfade takes the short way round */
+    const MCAF_U_ANGLE_ELEC thetaDifference = thetaAtpll - thetaEncoder;
+    phybrid->thetaDifference = thetaDifference;
+    phybrid->thetaElectrical = thetaEncoder + UTIL_MulQ15(thetaDifference, phybrid->weight);
+    phybrid->omegaElectrical = omegaEncoder 
+        + UTIL_MulQ15(UTIL_SatSubS16(omegaAtpll, omegaEncoder), phybrid->weight);
+    
+    /* Below the handover, the encoder commutates and the ATPLL
+     * is not expected to be accurate. */
+    if ((phybrid->weight == INT16_MAX)
+        && UTIL_AbsGreaterThan(thetaDifference, MCAF_HYBRID_ANGLE_TOLERANCE))
+    {
+        if (phybrid->mismatchCount < MCAF_HYBRID_MISMATCH_TIME)
+        {
+            ++phybrid->mismatchCount;
+        }
+        else
+        {
+            phybrid->mismatch = true;
+        }
+    }
+    else
+    {
+        phybrid->mismatchCount = 0;
+    }
+}
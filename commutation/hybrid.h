@@ -0,0 +1,142 @@
+/**
+ * hybrid.h
+ * 
+ * Hosts components of hybrid commutation, which crossfades
+ * from the encoder at low velocity to the ATPLL at high velocity
+ * 
+ * Component: commutation
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __HYBRID_H
+#define __HYBRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "units.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * State variables for hybrid commutation
+ */
+typedef struct tagMCAF_ESTIMATOR_HYBRID
+{
+    int16_t weight;                       /** weight of the ATPLL, Q15: 0 = encoder only, INT16_MAX = ATPLL only */
+    MCAF_U_ANGLE_ELEC thetaDifference;    /** ATPLL angle minus encoder angle */
+    uint16_t mismatchCount;               /** steps with thetaDifference beyond tolerance, while the ATPLL commutates */
+    bool mismatch;                        /** whether the ATPLL and encoder angles have been found implausible */
+    MCAF_U_ANGLE_ELEC thetaElectrical;    /** crossfaded angle */
+    MCAF_U_VELOCITY_ELEC omegaElectrical; /** crossfaded velocity */
+} MCAF_ESTIMATOR_HYBRID_T;
+
+/**
+ * Initializes hybrid commutation state variables on reset.
+ * 
+ * @param phybrid hybrid commutation state
+ */
+void MCAF_EstimatorHybridInit(MCAF_ESTIMATOR_HYBRID_T *phybrid);
+
+/**
+ * Initializes hybrid commutation state variables prior to starting motor.
+ * 
+ * @param phybrid hybrid commutation state
+ */
+void MCAF_EstimatorHybridStartupInit(MCAF_ESTIMATOR_HYBRID_T *phybrid);
+
+/**
+ * Executes one step of hybrid commutation.
+ * 
+ * The weight of the ATPLL is determined from the encoder velocity,
+ * which is valid at any velocity.
+ * 
+ * @param phybrid hybrid commutation state
+ * @param thetaEncoder encoder angle
+ * @param omegaEncoder encoder velocity
+ * @param thetaAtpll ATPLL angle
+ * @param omegaAtpll ATPLL velocity
+ */
+void MCAF_EstimatorHybridStep(MCAF_ESTIMATOR_HYBRID_T *phybrid,
+                              MCAF_U_ANGLE_ELEC thetaEncoder,
+                              MCAF_U_VELOCITY_ELEC omegaEncoder,
+                              MCAF_U_ANGLE_ELEC thetaAtpll,
+                              MCAF_U_VELOCITY_ELEC omegaAtpll);
+
+/**
+ * Returns commutation angle
+ * 
+ * @param phybrid hybrid commutation state
+ * @return commutation angle
+ */
+inline static MCAF_U_ANGLE_ELEC MCAF_EstimatorHybridCommutationAngle(const MCAF_ESTIMATOR_HYBRID_T *phybrid)
+{
+    return phybrid->thetaElectrical;
+}
+
+/**
+ * Returns electrical frequency
+ * 
+ * @param phybrid hybrid commutation state
+ * @return electrical frequency
+ */
+inline static MCAF_U_VELOCITY_ELEC MCAF_EstimatorHybridElectricalFrequency(const MCAF_ESTIMATOR_HYBRID_T *phybrid)
+{
+    return phybrid->omegaElectrical;
+}
+
+/**
+ * Returns whether the ATPLL and encoder angles have disagreed
+ * for longer than MCAF_HYBRID_MISMATCH_TIME since startup
+ * 
+ * @param phybrid hybrid commutation state
+ * @return whether a mismatch has been detected
+ */
+inline static bool MCAF_EstimatorHybridMismatchDetected(const MCAF_ESTIMATOR_HYBRID_T *phybrid)
+{
+    return phybrid->mismatch;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HYBRID_H */
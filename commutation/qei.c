@@ -0,0 +1,260 @@
+/**
+ * qei.c
+ * 
+ * Hosts components of the quadrature encoder (QEI) estimator
+ * 
+ * Component: commutation
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "util.h"
+#include "parameters/qei_params.h"
+#include "qei.h"
+
+/** Limit of counts per M/T measurement, which keeps the numerator within 32 bits */
+#define MCAF_QEI_MT_COUNT_MAX 4000
+
+/**
+ * Wraps a position into the range 0 to MCAF_QEI_COUNTS_PER_REV-1.
+ * The input must be within one revolution of that range.
+ * 
+ * @param count position in counts
+ * @return position within the mechanical revolution
+ */
+inline static int16_t wrapCount(int16_t count)
+{
+    if (count >= MCAF_QEI_COUNTS_PER_REV)
+    {
+        return count - MCAF_QEI_COUNTS_PER_REV;
+    }
+    if (count < 0)
+    {
+        return count + MCAF_QEI_COUNTS_PER_REV;
+    }
+    return count;
+}
+
+/**
+ * Converts a position within the mechanical revolution to an electrical angle
+ * 
+ * @param count position within the mechanical revolution
+ * @return electrical angle, relative to the angle at count zero
+ */
+inline static MCAF_U_ANGLE_ELEC countToAngle(int16_t count)
+{
+    return (MCAF_U_ANGLE_ELEC)(UTIL_muluu(count, MCAF_QEI_ANGLE_PER_COUNT) >> 8);
+}
+
+/**
+ * Computes the velocity of a number of counts over a time interval
+ * 
+ * @param pqei QEI estimator state
+ * @param counts number of counts, signed
+ * @param ticks time interval in interval timer ticks
+ * @return velocity, saturated to the Q15 range
+ */
+inline static MCAF_U_VELOCITY_ELEC countsToVelocity(const MCAF_ESTIMATOR_QEI_T *pqei,
+                                                    int16_t counts, uint16_t ticks)
+{
+    const uint16_t magnitude = UTIL_LimitMaximumU16(UTIL_Abs16(counts), MCAF_QEI_MT_COUNT_MAX);
+    const uint32_t numerator = (uint32_t)magnitude * pqei->mtVelocityScale;
+    
+    /* This comparison also covers ticks == 0 */
+    const int16_t omega = (numerator >= UTIL_muluu(ticks, INT16_MAX))
+                        ? INT16_MAX
+                        : (int16_t)__builtin_divud(numerator, ticks);
+    return (counts < 0) ? -omega : omega;
+}
+
+/**
+ * Handles an index pulse.
+ * 
+ * The first index pulse becomes the origin of the position
+ * within the revolution; later ones detect and correct counts
+ * lost or gained through noise on the encoder signals.
+ * 
+ * @param pqei QEI estimator state
+ * @param countAtIndex position within the revolution at the index pulse
+ */
+static void qeiIndexEvent(MCAF_ESTIMATOR_QEI_T *pqei, int16_t countAtIndex)
+{
+    if (!pqei->indexFound)
+    {
+        /* Shift the origin without changing the electrical angle */
+        pqei->thetaOffset += countToAngle(countAtIndex);
+        pqei->countInRevolution = wrapCount(pqei->countInRevolution - countAtIndex);
+        pqei->indexFound = true;
+        if (MCAF_QEI_INDEX_CALIBRATED)
+        {
+            pqei->thetaOffset = MCAF_QEI_INDEX_ANGLE;
+            pqei->aligned = true;
+        }
+    }
+    else
+    {
+        int16_t error = countAtIndex;
+        if (error > MCAF_QEI_COUNTS_PER_REV/2)
+        {
+            error -= MCAF_QEI_COUNTS_PER_REV;
+        }
+        pqei->indexError = error;
+        if (error != 0)
+        {
+            pqei->countInRevolution = wrapCount(pqei->countInRevolution - error);
+            pqei->position -= error;
+            if (UTIL_AbsGreaterThan(error, MCAF_QEI_INDEX_TOLERANCE))
+            {
+                ++pqei->indexErrorCount;
+            }
+        }
+    }
+}
+
+/**
+ * Updates the velocity at the end of an M/T measurement window.
+ * 
+ * The M/T method divides the number of counts by the time between
+ * the last count before the previous update and the last count before
+ * this one, as measured by the interval timer. The result has the 
+ * resolution of the interval timer rather than of one count per window,
+ * which matters at low speed.
+ * 
+ * @param pqei QEI estimator state
+ * @param interval interval timer: ticks from the most recent count to the end of the window
+ */
+static void qeiVelocityUpdate(MCAF_ESTIMATOR_QEI_T *pqei, uint16_t interval)
+{
+    pqei->mtTime += pqei->mtWindowTicks;
+    if (pqei->mtCount != 0)
+    {
+        if (pqei->mtValid)
+        {
+            const uint16_t ticks = pqei->mtTime + pqei->mtTimeSinceCount - interval;
+            pqei->omegaElectrical = countsToVelocity(pqei, pqei->mtCount, ticks);
+        }
+        else
+        {
+            /* The time of the count before this window is not known
+             * after a timeout; count over the window instead. */
+            pqei->omegaElectrical = countsToVelocity(pqei, pqei->mtCount, pqei->mtTime);
+        }
+        pqei->mtCount = 0;
+        pqei->mtTime = 0;
+        pqei->mtTimeSinceCount = interval;
+        pqei->mtValid = true;
+    }
+    else if (pqei->mtTime >= pqei->mtTimeoutTicks)
+    {
+        pqei->omegaElectrical = 0;
+        pqei->mtTime = 0;
+        pqei->mtValid = false;
+    }
+    else if (pqei->mtValid)
+    {
+        /* No count in this window: the velocity cannot be more than 
+         * one count in the time since the last one. */
+        const MCAF_U_VELOCITY_ELEC limit = 
+            countsToVelocity(pqei, 1, pqei->mtTime + pqei->mtTimeSinceCount);
+        pqei->omegaElectrical = UTIL_LimitS16(pqei->omegaElectrical, -limit, limit);
+    }
+}
+
+void MCAF_EstimatorQeiInit(MCAF_ESTIMATOR_QEI_T *pqei, uint16_t count, uint16_t capture,
+                           uint32_t tickFrequency)
+{
+    const uint16_t windowTicks = (uint16_t)(tickFrequency / MCAF_QEI_MT_WINDOW_FREQUENCY);
+    const uint32_t timeoutTicks = (uint32_t)windowTicks * MCAF_QEI_MT_TIMEOUT_WINDOWS;
+    pqei->mtWindowTicks = windowTicks;
+    /* mtTime must not wrap before the timeout is detected */
+    pqei->mtTimeoutTicks = (timeoutTicks > (uint32_t)(UINT16_MAX - windowTicks))
+                         ? (UINT16_MAX - windowTicks) : (uint16_t)timeoutTicks;
+    pqei->mtVelocityScale = ((uint32_t)windowTicks * MCAF_QEI_MT_VELOCITY_PER_WINDOW) >> 8;
+    
+    pqei->countPrevious = count;
+    pqei->capturePrevious = capture;
+    pqei->countInRevolution = 0;
+    pqei->position = 0;
+    pqei->thetaOffset = 0;
+    pqei->aligned = false;
+    pqei->indexFound = false;
+    pqei->mtCount = 0;
+    pqei->mtTime = 0;
+    pqei->mtTimeSinceCount = 0;
+    pqei->mtValid = false;
+    pqei->mtStepCount = 0;
+    pqei->thetaElectrical = 0;
+    pqei->omegaElectrical = 0;
+    pqei->indexError = 0;
+    pqei->indexErrorCount = 0;
+}
+
+void MCAF_EstimatorQeiStep(MCAF_ESTIMATOR_QEI_T *pqei, uint16_t count, uint16_t capture, uint16_t interval)
+{
+    const int16_t delta = (int16_t)(count - pqei->countPrevious);
+    pqei->countPrevious = count;
+    pqei->position += delta;
+    pqei->countInRevolution = wrapCount(pqei->countInRevolution + delta);
+    
+    if (MCAF_QEI_INDEX_PRESENT && (capture != pqei->capturePrevious))
+    {
+        pqei->capturePrevious = capture;
+        const int16_t countsSinceIndex = (int16_t)(count - capture);
+        qeiIndexEvent(pqei, wrapCount(pqei->countInRevolution - countsSinceIndex));
+    }
+    
+    pqei->mtCount += delta;
+    if (++pqei->mtStepCount >= MCAF_QEI_MT_WINDOW)
+    {
+        pqei->mtStepCount = 0;
+        qeiVelocityUpdate(pqei, interval);
+    }
+    
+    pqei->thetaElectrical = countToAngle(pqei->countInRevolution) + pqei->thetaOffset;
+}
+
+void MCAF_EstimatorQeiAlign(MCAF_ESTIMATOR_QEI_T *pqei, MCAF_U_ANGLE_ELEC theta)
+{
+    pqei->thetaOffset = theta - countToAngle(pqei->countInRevolution);
+    pqei->thetaElectrical = theta;
+    pqei->aligned = true;
+}
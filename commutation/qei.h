@@ -0,0 +1,185 @@
+/**
+ * qei.h
+ * 
+ * Hosts components of the quadrature encoder (QEI) estimator
+ * 
+ * Component: commutation
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __QEI_H
+#define __QEI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "units.h"
+#include "parameters/qei_params.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * State variables for the quadrature encoder estimator
+ *
+ * The QEI position counter runs free, and the estimator accumulates
+ * the change in count at each step, so the counter range does not need
+ * to match the number of counts per revolution.
+ *
+ * The electrical angle is known once the estimator is aligned, either
+ * from the rotor angle at the end of the startup align step, or from
+ * the index pulse if its angle has been calibrated.
+ */
+typedef struct tagMCAF_ESTIMATOR_QEI
+{
+    /*
+     * Parameters, derived from the interval timer frequency
+     */
+    uint16_t mtWindowTicks;         /** interval timer ticks per M/T window */
+    uint16_t mtTimeoutTicks;        /** interval timer ticks without a count after which the velocity is zero */
+    uint32_t mtVelocityScale;       /** velocity of one count per interval timer tick */
+    
+    /*
+     * State variables
+     */
+    uint16_t countPrevious;         /** QEI position count at the previous step */
+    uint16_t capturePrevious;       /** QEI index capture at the previous step */
+    int16_t countInRevolution;      /** position within the mechanical revolution, 
+                                        0 to MCAF_QEI_COUNTS_PER_REV-1; zero is the index once it has been found */
+    int32_t position;               /** multi-turn mechanical position, in counts */
+    MCAF_U_ANGLE_ELEC thetaOffset;  /** electrical angle at countInRevolution = 0 */
+    bool aligned;                   /** whether the electrical angle is known */
+    bool indexFound;                /** whether an index pulse has been seen */
+    int16_t mtCount;                /** counts since the last M/T velocity update */
+    uint16_t mtTime;                /** interval timer ticks of the windows since the last M/T velocity update */
+    uint16_t mtTimeSinceCount;      /** time from the last count to the end of the last M/T velocity update */
+    bool mtValid;                   /** whether mtTimeSinceCount refers to a count */
+    uint16_t mtStepCount;           /** steps since the start of the current M/T window */
+    
+    /*
+     * Auxiliary variables
+     */
+    MCAF_U_ANGLE_ELEC thetaElectrical;    /** electrical angle */
+    MCAF_U_VELOCITY_ELEC omegaElectrical; /** M/T velocity */
+    int16_t indexError;             /** count error at the most recent index pulse */
+    uint16_t indexErrorCount;       /** number of index pulses with an error beyond MCAF_QEI_INDEX_TOLERANCE */
+} MCAF_ESTIMATOR_QEI_T;
+
+/**
+ * Initializes QEI estimator state variables on reset.
+ * 
+ * @param pqei QEI estimator state
+ * @param count QEI position count
+ * @param capture QEI index capture
+ * @param tickFrequency QEI interval timer frequency in Hz
+ */
+void MCAF_EstimatorQeiInit(MCAF_ESTIMATOR_QEI_T *pqei, uint16_t count, uint16_t capture,
+                           uint32_t tickFrequency);
+
+/**
+ * Executes one step of the QEI estimator.
+ * 
+ * The interval timer value must be the one latched when 
+ * the position count was read.
+ * 
+ * @param pqei QEI estimator state
+ * @param count QEI position count
+ * @param capture QEI index capture
+ * @param interval QEI interval timer: ticks from the most recent count to the count read
+ */
+void MCAF_EstimatorQeiStep(MCAF_ESTIMATOR_QEI_T *pqei, uint16_t count, uint16_t capture, uint16_t interval);
+
+/**
+ * Aligns the encoder to a known rotor angle.
+ * 
+ * @param pqei QEI estimator state
+ * @param theta present electrical angle of the rotor d-axis
+ */
+void MCAF_EstimatorQeiAlign(MCAF_ESTIMATOR_QEI_T *pqei, MCAF_U_ANGLE_ELEC theta);
+
+/**
+ * Returns whether the electrical angle of the encoder is known
+ * 
+ * @param pqei QEI estimator state
+ * @return whether the encoder is aligned
+ */
+inline static bool MCAF_EstimatorQeiIsAligned(const MCAF_ESTIMATOR_QEI_T *pqei)
+{
+    return pqei->aligned;
+}
+
+/**
+ * Returns commutation angle
+ * 
+ * @param pqei QEI estimator state
+ * @return commutation angle
+ */
+inline static MCAF_U_ANGLE_ELEC MCAF_EstimatorQeiCommutationAngle(const MCAF_ESTIMATOR_QEI_T *pqei)
+{
+    return pqei->thetaElectrical;
+}
+
+/**
+ * Returns electrical frequency
+ * 
+ * @param pqei QEI estimator state
+ * @return electrical frequency
+ */
+inline static MCAF_U_VELOCITY_ELEC MCAF_EstimatorQeiElectricalFrequency(const MCAF_ESTIMATOR_QEI_T *pqei)
+{
+    return pqei->omegaElectrical;
+}
+
+/**
+ * Returns multi-turn mechanical position
+ * 
+ * @param pqei QEI estimator state
+ * @return position in encoder counts
+ */
+inline static int32_t MCAF_EstimatorQeiPosition(const MCAF_ESTIMATOR_QEI_T *pqei)
+{
+    return pqei->position;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __QEI_H */
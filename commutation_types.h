@@ -50,6 +50,9 @@
 #include "units.h"
 #include "commutation/common.h"
 #include "commutation/atpll.h"
+#include "commutation/qei.h"
+#include "commutation/hybrid.h"
+#include "parameters/options.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,12 +72,18 @@ typedef struct tagMCAF_RELATIVE_ANGLE_T
 typedef struct tagMCAF_ESTIMATOR_T
 {
     MCAF_ESTIMATOR_ATPLL_T atpll;  /** sensorless, angle-tracking phase-locked loop (ATPLL) */
+    MCAF_ESTIMATOR_QEI_T  qei;     /** quadrature encoder */
+    MCAF_ESTIMATOR_HYBRID_T hybrid; /** crossfade from encoder to ATPLL */
     MCAF_U_ANGLE_ELEC     theta;                   /** estimated rotor angle (electrical) */
     MCAF_U_VELOCITY_ELEC  omega;                   /** estimated rotor velocity (electrical) */
     MCAF_RELATIVE_ANGLE_T thetaRelativeTo;
 } MCAF_ESTIMATOR_T;
 
 inline static bool MCAF_EstimatorAtPllIsActive(const MCAF_ESTIMATOR_T* pestimator) { return true; }
+inline static bool MCAF_EstimatorQeiIsActive(const MCAF_ESTIMATOR_T* pestimator) 
+{ 
+    return MCAF_EncoderEnabled() && MCAF_EstimatorQeiIsAligned(&pestimator->qei);
+}
 
 #ifdef __cplusplus
 }
@@ -104,16 +104,19 @@ inline static void MCAF_ADCApplyCurrentCompensation(const MCAF_CURRENT_COMPENSAT
 /**
  * Obtains motor phase current information from appropriate sources.
  * @param currentMeasure MCAF current measurement
+ * @param phal ADC resources of the motor
  * @param iabc abc current vector
  */
-inline static void MCAF_ADCCurrentRead(const MCAF_CURRENT_MEASUREMENT *currentMeasure, MCAF_U_CURRENT_ABC *iabc)
+inline static void MCAF_ADCCurrentRead(const MCAF_CURRENT_MEASUREMENT *currentMeasure,
+                                       const HAL_MOTOR_MAP_T *phal,
+                                       MCAF_U_CURRENT_ABC *iabc)
 {
-    iabc->a = HAL_ADC_ValuePhaseACurrent();
-    iabc->b = HAL_ADC_ValuePhaseBCurrent(); 
+    iabc->a = HAL_ADC_ValuePhaseACurrentInstance(phal);
+    iabc->b = HAL_ADC_ValuePhaseBCurrentInstance(phal); 
     
     if (HAL_ADC_IsPhaseCCurrentAvailable())
     {
-        iabc->c = HAL_ADC_ValuePhaseCCurrent();
+        iabc->c = HAL_ADC_ValuePhaseCCurrentInstance(phal);
     }
 }
 
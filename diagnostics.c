@@ -47,6 +47,17 @@
 #include "X2Cscope.h"
 #include "hal.h"
 #include <stdint.h>
+#include "parameters/options.h"
+#include "uart_buffer.h"
+#if MCAF_INCLUDE_TELEMETRY || MCAF_INCLUDE_REMOTE_CONTROL
+#include "system_state.h"
+#endif
+#if MCAF_INCLUDE_TELEMETRY
+#include "telemetry.h"
+#endif
+#if MCAF_INCLUDE_REMOTE_CONTROL
+#include "mcapi_remote.h"
+#endif
 
 #define X2C_DATA __attribute__((section("x2cscope_data_buf")))
 #define X2C_BUFFER_SIZE 4900
@@ -54,6 +65,21 @@
 compilationDate_t compilationDate = {__DATE__, __TIME__};
 
 X2C_DATA static uint8_t X2C_BUFFER[X2C_BUFFER_SIZE];
+
+#if MCAF_INCLUDE_TELEMETRY || MCAF_INCLUDE_REMOTE_CONTROL
+/** motor state variables, accessed directly */
+extern MCAF_MOTOR_DATA motor;
+#endif
+
+#if MCAF_INCLUDE_TELEMETRY
+/** Streaming telemetry state; the host starts streaming by setting telemetry.enable */
+MCAF_TELEMETRY_T telemetry;
+#endif
+
+#if MCAF_INCLUDE_REMOTE_CONTROL
+/** Remote command protocol state, controlling motor #1 */
+MCAPI_REMOTE_T remote;
+#endif
     /*
      * baud rate = 70MHz/16/(1+baudrate_divider) for highspeed = false
      * baud rate = 70MHz/4/(1+baudrate_divider) for highspeed = true
@@ -86,17 +112,48 @@ void X2Cscope_Init(void);
 void MCAF_DiagnosticsInit(void)
 {
     HAL_UART_Initialize();
+    MCAF_UartInit();
     
     X2Cscope_Init();
+#if MCAF_INCLUDE_TELEMETRY
+    MCAF_TelemetryInit(&telemetry);
+    MCAF_TelemetryChannelSet(&telemetry, 0, &motor.idq.d);
+    MCAF_TelemetryChannelSet(&telemetry, 1, &motor.idq.q);
+    MCAF_TelemetryChannelSet(&telemetry, 2, &motor.omegaElectrical);
+    MCAF_TelemetryChannelSet(&telemetry, 3, &motor.vDC);
+#endif
+#if MCAF_INCLUDE_REMOTE_CONTROL
+    MCAPI_RemoteInit(&remote, &motor.apiData);
+#if MCAF_INCLUDE_TELEMETRY
+    MCAPI_RemoteTelemetrySet(&remote, &telemetry.enable);
+#endif
+#endif
 }
 
 void MCAF_DiagnosticsStepMain(void)
 {
+#if MCAF_INCLUDE_REMOTE_CONTROL
+    MCAPI_RemoteScheduleStep(&remote);
+#endif
+#if MCAF_INCLUDE_TELEMETRY
+    if (MCAF_TelemetryIsActive(&telemetry))
+    {
+        MCAF_TelemetryStepMain(&telemetry);
+        return;
+    }
+#endif
+#if MCAF_INCLUDE_REMOTE_CONTROL
+    MCAPI_RemoteCommunicate(&remote);
+#else
     X2Cscope_Communicate();
+#endif
 }
 
 void MCAF_DiagnosticsStepIsr(void)
 {
+#if MCAF_INCLUDE_TELEMETRY
+    MCAF_TelemetryStepIsr(&telemetry);
+#endif
     X2Cscope_Update();
 }
 
@@ -104,22 +161,22 @@ void MCAF_DiagnosticsStepIsr(void)
 
 static void X2Cscope_sendSerial(uint8_t data)
 {
-    HAL_UART_Write(data);
+    MCAF_UartWrite(data);
 }
 
 static uint8_t X2Cscope_receiveSerial()
 {
-    return HAL_UART_Read();
+    return MCAF_UartRead();
 }
 
 static uint8_t X2Cscope_isReceiveDataAvailable()
 {
-    return HAL_UART_IsRxReady();
+    return MCAF_UartIsRxReady();
 }
 
 static uint8_t X2Cscope_isSendReady()
 {
-    return HAL_UART_IsTxReady();
+    return MCAF_UartIsTxReady();
 }
 
 void X2Cscope_Init(void)
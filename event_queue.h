@@ -0,0 +1,139 @@
+/**
+ * event_queue.h
+ * 
+ * Lock-free event queue for passing events from the ADC ISR
+ * to a lower-priority consumer (application timer)
+ * 
+ * Component: event queue
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __EVENT_QUEUE_H
+#define __EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "event_queue_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an event queue. Call only while neither
+ * producer nor consumer is active.
+ * 
+ * @param pqueue event queue
+ */
+inline static void MCAF_EventQueueInit(volatile MCAF_EVENT_QUEUE_T *pqueue)
+{
+    pqueue->head = 0;
+    pqueue->tail = 0;
+    pqueue->overflowCount = 0;
+}
+
+/**
+ * Posts an event to a queue. Call only from the producer context.
+ * 
+ * The entry is written before the head index is advanced,
+ * so the consumer never sees a partially-written event.
+ * If the queue is full, the event is dropped and counted.
+ * 
+ * @param pqueue event queue
+ * @param type event type
+ * @param payload event-specific data
+ * @param timestamp time at which the event occurred
+ * @return true if the event was queued
+ */
+inline static bool MCAF_EventQueuePost(volatile MCAF_EVENT_QUEUE_T *pqueue,
+        MCAF_EVENT_TYPE type, uint16_t payload, uint32_t timestamp)
+{
+    const uint16_t head = pqueue->head;
+    if ((uint16_t)(head - pqueue->tail) >= MCAF_EVENT_QUEUE_LENGTH)
+    {
+        ++pqueue->overflowCount;
+        return false;
+    }
+    volatile MCAF_EVENT_T *pevent = &pqueue->entry[head & (MCAF_EVENT_QUEUE_LENGTH - 1)];
+    pevent->timestamp = timestamp;
+    pevent->type = type;
+    pevent->payload = payload;
+    pqueue->head = head + 1;
+    return true;
+}
+
+/**
+ * Removes the oldest event from a queue. Call only from the consumer context.
+ * 
+ * @param pqueue event queue
+ * @param pevent destination for the event
+ * @return true if an event was available
+ */
+inline static bool MCAF_EventQueuePop(volatile MCAF_EVENT_QUEUE_T *pqueue, MCAF_EVENT_T *pevent)
+{
+    const uint16_t tail = pqueue->tail;
+    if (tail == pqueue->head)
+    {
+        return false;
+    }
+    const volatile MCAF_EVENT_T *pentry = &pqueue->entry[tail & (MCAF_EVENT_QUEUE_LENGTH - 1)];
+    pevent->timestamp = pentry->timestamp;
+    pevent->type = pentry->type;
+    pevent->payload = pentry->payload;
+    pqueue->tail = tail + 1;
+    return true;
+}
+
+/**
+ * Returns whether a queue has any pending events.
+ * 
+ * @param pqueue event queue
+ * @return true if the queue is empty
+ */
+inline static bool MCAF_EventQueueIsEmpty(const volatile MCAF_EVENT_QUEUE_T *pqueue)
+{
+    return pqueue->tail == pqueue->head;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_QUEUE_H */
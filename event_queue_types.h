@@ -0,0 +1,103 @@
+/**
+ * event_queue_types.h
+ * 
+ * Type definitions for the ISR-to-foreground event queues
+ * 
+ * Component: event queue
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __EVENT_QUEUE_TYPES_H
+#define __EVENT_QUEUE_TYPES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Event types posted by the ADC ISR
+ */
+typedef enum tagMCAF_EVENT_TYPE
+{
+    MCAF_EVENT_NONE             = 0, /** no event */
+    MCAF_EVENT_STATE_CHANGE     = 1, /** state machine transition; payload = (from << 8) | to */
+    MCAF_EVENT_FAULT            = 2, /** new fault detected; payload = error code */
+    MCAF_EVENT_STALL_DETECT     = 3, /** stall detected; payload = masked stall detect flags */
+    MCAF_EVENT_RECOVERY         = 4, /** recovery state change; payload = recovery FSM state */
+    MCAF_EVENT_MCAPI_STATUS     = 5, /** MCAPI status change; payload = MCAPI_MOTOR_STATE */
+    MCAF_EVENT_DIRECTION_CHANGE = 6, /** commanded direction reversed; payload = UI flags */
+    MCAF_EVENT_STARTUP_PHASE    = 7  /** startup FSM transition; payload = new MCAF_STARTUP_FSM_STATE */
+} MCAF_EVENT_TYPE;
+
+/**
+ * Event record
+ */
+typedef struct tagMCAF_EVENT
+{
+    uint32_t timestamp;     /** ISR count when the event was posted */
+    uint16_t type;          /** event type (MCAF_EVENT_TYPE) */
+    uint16_t payload;       /** event-specific data */
+} MCAF_EVENT_T;
+
+/** Number of entries in each event queue (must be a power of 2) */
+#define MCAF_EVENT_QUEUE_LENGTH 16
+
+/**
+ * Single-producer, single-consumer event queue.
+ * 
+ * The head and tail indices are free-running; each one is written
+ * by only one side, so no locking is required as long as 16-bit
+ * accesses are atomic.
+ */
+typedef struct tagMCAF_EVENT_QUEUE
+{
+    MCAF_EVENT_T entry[MCAF_EVENT_QUEUE_LENGTH]; /** event storage */
+    uint16_t head;          /** count of events posted (written by producer only) */
+    uint16_t tail;          /** count of events consumed (written by consumer only) */
+    uint16_t overflowCount; /** count of events dropped because the queue was full */
+} MCAF_EVENT_QUEUE_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_QUEUE_TYPES_H */
@@ -87,7 +87,7 @@ void MCAF_FaultDetect(MCAF_FAULT_DETECT_T *pfaultDetect, const MCAF_MOTOR_DATA *
             flags = UTIL_SetBits(flags, MCAF_OVERTEMPERATURE_FAULT_DETECT);
         }
     }
-    if (MCAF_OvercurrentHWFlagPending(&pmotor->faultHandle) && MCAF_OvercurrentHWDetect())
+    if (MCAF_OvercurrentHWFlagPending(&pmotor->faultHandle) && MCAF_OvercurrentHWDetect(pmotor))
     {
         flags = UTIL_SetBits(flags, MCAF_OVERCURRENT_HW_FAULT_DETECT);
     }
@@ -126,12 +126,13 @@ inline static bool MCAF_UndervoltageDetect(const MCAF_DCLINKVOLTAGE_DETECT_T *pV
  *
  * Summary : Returns whether a hardware overcurrent happened
  *
+ * @param pmotor motor state
  * @return whether a hardware overcurrent fault has been detected
  */
 
-inline static bool MCAF_OvercurrentHWDetect(void)
+inline static bool MCAF_OvercurrentHWDetect(const MCAF_MOTOR_DATA *pmotor)
 {
-    return HAL_PWM_FaultStatus_Get();
+    return HAL_PWM_FaultStatus_GetInstance(pmotor->phal);
 }
 
 /**
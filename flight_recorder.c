@@ -0,0 +1,141 @@
+/**
+ * flight_recorder.c
+ * 
+ * Always-on recorder of the most recent ISR frames,
+ * frozen in persistent RAM by selected events
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "flight_recorder.h"
+#include "system_state.h"
+#include "mcaf_traps.h"
+#include "parameters/flight_recorder_params.h"
+
+/**
+ * Recorded data of motor #1.
+ * 
+ * As with MCAF_resetCounter in system_init.c, the persistent attribute
+ * keeps the compiler's initialization code from clearing it at reset.
+ */
+MCAF_RECORDER_SNAPSHOT_T MCAF_recorderSnapshot __attribute__((persistent, section("MCAF_persistent")));
+
+/**
+ * Checks whether the snapshot holds a recording from before the
+ * most recent reset, rather than uninitialized RAM.
+ * 
+ * @param psnapshot recorded data
+ * @return true if the contents are valid
+ */
+inline static bool MCAF_RecorderSnapshotValid(const MCAF_RECORDER_SNAPSHOT_T *psnapshot)
+{
+    return (psnapshot->signature == MCAF_RECORDER_SIGNATURE)
+        && (psnapshot->state <= MCAF_RECORDER_FROZEN)
+        && (psnapshot->head < MCAF_RECORDER_FRAME_COUNT)
+        && (psnapshot->count <= MCAF_RECORDER_FRAME_COUNT);
+}
+
+void MCAF_RecorderInit(struct tagMOTOR *pmotor, MCAF_RECORDER_SNAPSHOT_T *psnapshot)
+{
+    MCAF_RECORDER_T *precorder = &pmotor->recorder;
+    
+    precorder->psnapshot = psnapshot;
+    precorder->triggerMask = MCAF_RECORDER_TRIGGER_MASK;
+    precorder->postTriggerFrames = MCAF_RECORDER_POST_TRIGGER_FRAMES;
+    precorder->rearmRequest = false;
+    
+    const volatile int16_t **psource = precorder->source;
+    psource[0]  = &pmotor->iabc.a;
+    psource[1]  = &pmotor->iabc.b;
+    psource[2]  = &pmotor->iabc.c;
+    psource[3]  = &pmotor->idq.d;
+    psource[4]  = &pmotor->idq.q;
+    psource[5]  = &pmotor->vdq.d;
+    psource[6]  = &pmotor->vdq.q;
+    psource[7]  = (const volatile int16_t *)&pmotor->thetaElectrical;
+    psource[8]  = &pmotor->omegaElectrical;
+    psource[9]  = &pmotor->vDC;
+    psource[10] = (const volatile int16_t *)&pmotor->state;
+    psource[11] = &pmotor->idqCmd.q;
+    
+    if (psnapshot == NULL)
+    {
+        return;
+    }
+    if (MCAF_RecorderSnapshotValid(psnapshot))
+    {
+        const uint16_t state = psnapshot->state;
+        /* Only a trap or watchdog reset makes a recording in progress
+         * worth keeping; after any other reset, recording starts over. */
+        if (MCAF_RECORDER_FREEZE_ON_RESET
+            && ((state == MCAF_RECORDER_RECORDING) || (state == MCAF_RECORDER_TRIGGERED))
+            && MCAF_ResetCausedByTrapOrWatchdog())
+        {
+            if (state == MCAF_RECORDER_RECORDING)
+            {
+                psnapshot->trigger.timestamp = psnapshot->timestamp;
+                psnapshot->trigger.type = MCAF_EVENT_NONE;
+                psnapshot->trigger.payload = 0;
+            }
+            psnapshot->postTrigger = 0;
+            psnapshot->state = MCAF_RECORDER_FROZEN;
+        }
+        if (psnapshot->state == MCAF_RECORDER_FROZEN)
+        {
+            ++psnapshot->resetCount;
+            return;
+        }
+    }
+    MCAF_RecorderStart(precorder);
+}
+
+void MCAF_RecorderChannelSet(volatile MCAF_RECORDER_T *precorder, uint16_t channel,
+        const volatile int16_t *psource)
+{
+    if (channel < MCAF_RECORDER_CHANNEL_COUNT)
+    {
+        precorder->source[channel] = psource;
+        MCAF_RecorderRearm(precorder);
+    }
+}
@@ -0,0 +1,221 @@
+/**
+ * flight_recorder.h
+ * 
+ * Always-on recorder of the most recent ISR frames,
+ * frozen in persistent RAM by selected events
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __FLIGHT_RECORDER_H
+#define __FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "flight_recorder_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Persistent storage for the recording of motor #1 */
+extern MCAF_RECORDER_SNAPSHOT_T MCAF_recorderSnapshot;
+
+/* Declared here rather than including system_state.h, 
+ * which needs this header for MCAF_EventPublish() */
+struct tagMOTOR;
+
+/**
+ * Initializes the flight recorder of a motor instance, selecting
+ * the default signal set and triggers.
+ * 
+ * A recording that was frozen before a reset is kept until rearmed.
+ * With MCAF_RECORDER_FREEZE_ON_RESET, a recording that was still
+ * in progress at a reset caused by a trap or watchdog timeout
+ * is frozen as well, with a trigger type of MCAF_EVENT_NONE;
+ * after any other reset, recording restarts.
+ * This must be called before MCAF_CheckResetCause() clears the reset cause.
+ * 
+ * @param pmotor motor state data
+ * @param psnapshot storage for recorded data, or NULL to disable recording
+ */
+void MCAF_RecorderInit(struct tagMOTOR *pmotor, MCAF_RECORDER_SNAPSHOT_T *psnapshot);
+
+/**
+ * Discards any recorded data and starts recording. 
+ * 
+ * @param precorder recorder state
+ */
+inline static void MCAF_RecorderStart(MCAF_RECORDER_T *precorder)
+{
+    MCAF_RECORDER_SNAPSHOT_T *psnapshot = precorder->psnapshot;
+    for (uint16_t i = 0; i < MCAF_RECORDER_CHANNEL_COUNT; ++i)
+    {
+        psnapshot->channelAddress[i] = (uint16_t)(uintptr_t)precorder->source[i];
+    }
+    psnapshot->head = 0;
+    psnapshot->count = 0;
+    psnapshot->postTrigger = 0;
+    psnapshot->resetCount = 0;
+    psnapshot->trigger.type = MCAF_EVENT_NONE;
+    psnapshot->trigger.payload = 0;
+    psnapshot->trigger.timestamp = 0;
+    psnapshot->signature = MCAF_RECORDER_SIGNATURE;
+    psnapshot->state = MCAF_RECORDER_RECORDING;
+}
+
+/**
+ * Records one frame of the configured signals, unless the
+ * recording is frozen.
+ * 
+ * Executed in the ISR, after the control step.
+ * 
+ * @param precorder recorder state
+ * @param timestamp current ISR count
+ */
+inline static void MCAF_RecorderStepIsr(MCAF_RECORDER_T *precorder, uint32_t timestamp)
+{
+    MCAF_RECORDER_SNAPSHOT_T *psnapshot = precorder->psnapshot;
+    if (psnapshot == NULL)
+    {
+        return;
+    }
+    if (precorder->rearmRequest)
+    {
+        MCAF_RecorderStart(precorder);
+        precorder->rearmRequest = false;
+    }
+    
+    const uint16_t state = psnapshot->state;
+    if ((state == MCAF_RECORDER_RECORDING) || (state == MCAF_RECORDER_TRIGGERED))
+    {
+        const uint16_t head = psnapshot->head;
+        int16_t *pframe = psnapshot->frame[head];
+        for (uint16_t i = 0; i < MCAF_RECORDER_CHANNEL_COUNT; ++i)
+        {
+            pframe[i] = *precorder->source[i];
+        }
+        psnapshot->head = (head + 1) & (MCAF_RECORDER_FRAME_COUNT - 1);
+        if (psnapshot->count < MCAF_RECORDER_FRAME_COUNT)
+        {
+            ++psnapshot->count;
+        }
+        psnapshot->timestamp = timestamp;
+        
+        if ((state == MCAF_RECORDER_TRIGGERED) && (--psnapshot->postTrigger == 0))
+        {
+            psnapshot->state = MCAF_RECORDER_FROZEN;
+        }
+    }
+}
+
+/**
+ * Freezes the recording if the event type is one of the configured
+ * triggers; only the first trigger after arming is kept.
+ * 
+ * Executed in the ISR whenever an event is published.
+ * 
+ * @param precorder recorder state
+ * @param type event type
+ * @param payload event-specific data
+ * @param timestamp ISR count at which the event occurred
+ */
+inline static void MCAF_RecorderTrigger(MCAF_RECORDER_T *precorder,
+        MCAF_EVENT_TYPE type, uint16_t payload, uint32_t timestamp)
+{
+    MCAF_RECORDER_SNAPSHOT_T *psnapshot = precorder->psnapshot;
+    if ((psnapshot != NULL) 
+        && (psnapshot->state == MCAF_RECORDER_RECORDING)
+        && (precorder->triggerMask & (1u << type)))
+    {
+        psnapshot->trigger.timestamp = timestamp;
+        psnapshot->trigger.type = type;
+        psnapshot->trigger.payload = payload;
+        psnapshot->postTrigger = precorder->postTriggerFrames;
+        psnapshot->state = (precorder->postTriggerFrames == 0)
+                         ? MCAF_RECORDER_FROZEN : MCAF_RECORDER_TRIGGERED;
+    }
+}
+
+/**
+ * Requests that the recording be discarded and started again,
+ * for example after the host has read out a frozen recording.
+ * 
+ * Executed in the main loop; the ISR acts on the request.
+ * 
+ * @param precorder recorder state
+ */
+inline static void MCAF_RecorderRearm(volatile MCAF_RECORDER_T *precorder)
+{
+    precorder->rearmRequest = true;
+}
+
+/**
+ * Returns whether the recording is frozen and ready to be read out.
+ * 
+ * @param precorder recorder state
+ * @return true if the recording is frozen
+ */
+inline static bool MCAF_RecorderIsFrozen(const volatile MCAF_RECORDER_T *precorder)
+{
+    return (precorder->psnapshot != NULL) 
+        && (precorder->psnapshot->state == MCAF_RECORDER_FROZEN);
+}
+
+/**
+ * Selects the signal recorded in one channel, and rearms the recorder
+ * so that the recording never mixes signals.
+ * 
+ * Executed in the main loop.
+ * 
+ * @param precorder recorder state
+ * @param channel channel index, less than MCAF_RECORDER_CHANNEL_COUNT
+ * @param psource signal to record; must remain valid while recording
+ */
+void MCAF_RecorderChannelSet(volatile MCAF_RECORDER_T *precorder, uint16_t channel,
+        const volatile int16_t *psource);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLIGHT_RECORDER_H */
@@ -0,0 +1,117 @@
+/**
+ * flight_recorder_types.h
+ * 
+ * Type definitions for the flight recorder
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __FLIGHT_RECORDER_TYPES_H
+#define __FLIGHT_RECORDER_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "event_queue_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of signals recorded in each frame */
+#define MCAF_RECORDER_CHANNEL_COUNT 12
+
+/** Number of frames in the circular buffer; must be a power of 2 */
+#define MCAF_RECORDER_FRAME_COUNT 128
+
+/** Marks the snapshot contents as valid, since persistent RAM is not initialized at power-up */
+#define MCAF_RECORDER_SIGNATURE 0x5EC0
+
+/**
+ * Flight recorder state
+ */
+typedef enum tagMCAF_RECORDER_STATE
+{
+    MCAF_RECORDER_IDLE      = 0,  /** not recording */
+    MCAF_RECORDER_RECORDING = 1,  /** recording, waiting for a trigger */
+    MCAF_RECORDER_TRIGGERED = 2,  /** recording the frames that follow the trigger */
+    MCAF_RECORDER_FROZEN    = 3   /** recording complete, contents held until rearmed */
+} MCAF_RECORDER_STATE;
+
+/**
+ * Recorded data; this is placed in persistent RAM so that it survives
+ * a reset, and is read out by the host with a debugger or X2Cscope.
+ * 
+ * Frames are stored in order of time, starting with the frame at index
+ * head (if count == MCAF_RECORDER_FRAME_COUNT) or 0 (otherwise).
+ * The most recent frame was recorded at ISR count timestamp;
+ * each frame is one ISR apart.
+ */
+typedef struct tagMCAF_RECORDER_SNAPSHOT
+{
+    uint16_t signature;     /** MCAF_RECORDER_SIGNATURE if the contents are valid */
+    uint16_t state;         /** recorder state, see MCAF_RECORDER_STATE */
+    uint16_t head;          /** index of the next frame to be written */
+    uint16_t count;         /** number of valid frames */
+    uint16_t postTrigger;   /** number of frames still to be recorded after the trigger */
+    uint16_t resetCount;    /** number of resets since the contents were frozen */
+    uint32_t timestamp;     /** ISR count of the most recent frame */
+    MCAF_EVENT_T trigger;   /** event that froze the recording; MCAF_EVENT_NONE for a reset */
+    uint16_t channelAddress[MCAF_RECORDER_CHANNEL_COUNT]; /** data memory address of each recorded signal */
+    int16_t frame[MCAF_RECORDER_FRAME_COUNT][MCAF_RECORDER_CHANNEL_COUNT]; /** recorded frames */
+} MCAF_RECORDER_SNAPSHOT_T;
+
+/**
+ * Flight recorder configuration, one per motor instance
+ */
+typedef struct tagMCAF_RECORDER
+{
+    MCAF_RECORDER_SNAPSHOT_T *psnapshot;  /** recorded data, or NULL if this instance does not record */
+    const volatile int16_t *source[MCAF_RECORDER_CHANNEL_COUNT]; /** signal recorded in each channel */
+    uint16_t triggerMask;       /** bit N set: events of type N freeze the recording */
+    uint16_t postTriggerFrames; /** number of frames recorded after the trigger */
+    volatile bool rearmRequest; /** discard the recording and start again, written by the main loop */
+} MCAF_RECORDER_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLIGHT_RECORDER_TYPES_H */
@@ -74,6 +74,8 @@
 #include "mcapi_internal.h"
 #include "commutation_excitation.h"
 #include "current_measure.h"
+#include "param_id.h"
+#include "param_adapt.h"
 
 /* ------------------------- Initialization ------------------------- */
 
@@ -93,6 +95,7 @@ inline static void initStateParameters(MCAF_MOTOR_DATA *pmotor)
     MCAF_ADCCompensationInit(&pmotor->initialization,
                              &pmotor->currentCalibration); 
     MCAF_FluxControlInit(&pmotor->fluxControl);        
+    MCAF_ParamAdaptInit(&pmotor->paramAdapt);
 
     pmotor->rVdc = MCAF_ComputeReciprocalDCLinkVoltage(INT16_MAX);
     
@@ -118,6 +121,19 @@ inline static void initControlLoopState(MCAF_MOTOR_DATA *pmotor)
     pmotor->vdqCmd.q = 0;
     pmotor->idqCmdRaw.d = 0;
     pmotor->idqCmdRaw.q = 0;
+    
+    /* the remaining torque control inputs are copied from MCAPI every ISR */
+    pmotor->torqueControl.enableApi = false;
+    pmotor->torqueControl.active = false;
+    pmotor->torqueControl.iqCmdApi = 0;
+    pmotor->torqueControl.iqCmd = 0;
+    
+    pmotor->positionControl.enableApi = false;
+    pmotor->positionControl.active = false;
+    pmotor->positionControl.positionCmdApi = 0;
+    pmotor->positionControl.kp = KPOSP;
+    pmotor->positionControl.positionError = 0;
+    pmotor->positionControl.velocityCmd = 0;
 }
 
 
@@ -147,9 +163,14 @@ inline static void initMotorParameters(MCAF_MOTOR_PARAMETERS_T *pparam)
 bool MCAF_FocInit(MCAF_MOTOR_DATA *pmotor)
 {
     initMotorParameters(&pmotor->motorParameters);
+#if MCAF_INCLUDE_PARAM_ID
+    MCAF_ParamIdInit(&pmotor->paramId);
+#endif
         
     pmotor->config.deadTimeCompensationVoltageDelay = MCAF_DEAD_TIME_COMPENSATION_VOLTAGE_DELAY;
     // delay for matching current and voltage timeskew
+    pmotor->config.velocitySlewRateLimitAccel = VELOCITY_SLEWRATE_LIMIT_ACCEL;
+    pmotor->config.velocitySlewRateLimitDecel = VELOCITY_SLEWRATE_LIMIT_DECEL;
     
     MCAF_DeadTimeCompensationInit(&pmotor->deadTimeCompensation);
     MCAF_DynamicCurrentLimitInit(&pmotor->dynLimit);
@@ -478,6 +499,169 @@ inline static void rateLimitCurrentCommand(const MC_DQ_T *pidqCmdRaw, MC_DQ_T *p
     pidqCmd->q = pidqCmdRaw->q;
 }
 
+/**
+ * Returns the saturation state used as antiwindup feedback
+ * for the velocity controller.
+ * 
+ * This should include
+ * - both current and voltage saturation, if flux-weakening is not enabled,
+ * - only current saturation,             if flux-weakening is enabled.
+ *
+ * The reason for disallowing voltage saturation as antiwindup feedback
+ * when FW is enabled, is that the entire FW region is roughly equal in
+ * output voltage requirement. This makes the upper speed end of FW 
+ * effectively indistinguishable from the lower speed end of FW
+ * from looking at the voltage required from the current loop.
+ * 
+ * @param pmotor motor state data
+ * @return saturation state for the velocity controller
+ */
+inline static MCAF_SAT_STATE_T velocityLoopSaturationState(const MCAF_MOTOR_DATA *pmotor)
+{
+    const MCAF_SAT_STATE_T satState = pmotor->sat.state;
+    return MCAF_FluxWeakEnabled()
+         ? MCAF_SatMask(satState, MCAF_SAT_CURRENT)
+         : satState;
+}
+
+/**
+ * Clamps the output of the velocity controller, which enforces the 
+ * velocity limit in torque control, to the torque reference on the side
+ * of the torque reference and to the q-axis current limit on the other.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void torqueControlClampSet(MCAF_MOTOR_DATA *pmotor)
+{
+    const MCAF_TORQUE_CONTROL_DATA *ptorque = &pmotor->torqueControl;
+    MCAF_PISTATE_T *pctrl = &pmotor->omegaCtrl;
+    const MCAF_U_CURRENT iqLimit = pmotor->iqCmdLimit;
+    if (ptorque->iqCmd >= 0)
+    {
+        pctrl->outMax = ptorque->iqCmd;
+        pctrl->outMin = -iqLimit;
+    }
+    else
+    {
+        pctrl->outMax = iqLimit;
+        pctrl->outMin = ptorque->iqCmd;
+    }
+}
+
+/**
+ * Switches between velocity control and torque control without a bump
+ * in the q-axis current command.
+ * 
+ * The velocity controller keeps running in torque control (see
+ * torqueControlStep()), so its integrator already holds the present
+ * current command when velocity control resumes; the velocity command
+ * then ramps from the present velocity.
+ * 
+ * @param pmotor motor state data
+ * @param enable true to enter torque control, false to leave it
+ */
+inline static void switchTorqueControl(MCAF_MOTOR_DATA *pmotor, bool enable)
+{
+    MCAF_TORQUE_CONTROL_DATA *ptorque = &pmotor->torqueControl;
+    if (enable)
+    {
+        ptorque->iqCmd = pmotor->idqCmdRaw.q;
+        ptorque->velocityLimiting = false;
+        torqueControlClampSet(pmotor);
+    }
+    else
+    {
+        pmotor->omegaCmd = pmotor->omegaElectrical;
+        pmotor->velocityControl.velocityCmdRateLimited = pmotor->omegaElectrical;
+    }
+    ptorque->active = enable;
+}
+
+/**
+ * Executes one step of the velocity limit in torque control,
+ * at the velocity loop rate.
+ * 
+ * The velocity limit is enforced by the velocity controller, with
+ * the velocity limit in the direction of the torque reference as its
+ * reference, and its output clamped to the torque reference on that side
+ * (see torqueControlClampSet()).
+ * Below the velocity limit, the controller saturates and its output is
+ * the torque reference; above it, the controller reduces the current
+ * (down to braking) to hold the velocity at the limit.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void torqueControlStep(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_TORQUE_CONTROL_DATA *ptorque = &pmotor->torqueControl;
+    const int16_t velocityLimit = (ptorque->iqCmd >= 0)
+                                ? ptorque->velocityLimit
+                                : -ptorque->velocityLimit;
+    
+    /* The estimator uses the velocity command as a feedforward term,
+     * so it follows the present velocity. */
+    pmotor->omegaCmd = pmotor->omegaElectrical;
+    
+    MCAF_ControllerPIUpdate(
+        velocityLimit,
+        pmotor->omegaElectrical,
+        &pmotor->omegaCtrl,
+        velocityLoopSaturationState(pmotor),
+        &pmotor->idqCmdRaw.q,
+        velocityLimit);
+    ptorque->velocityLimiting = (pmotor->idqCmdRaw.q != ptorque->iqCmd);
+}
+
+/**
+ * Executes one step of the torque reference path, every ISR.
+ * 
+ * The q-axis current command follows the MCAPI torque reference, 
+ * subject to the slew rate limit and the q-axis current limit,
+ * without waiting for the subsampled velocity loop. While the velocity
+ * limit is acting, the velocity controller output remains the current
+ * command, bounded by the torque reference.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void torqueReferenceStep(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_TORQUE_CONTROL_DATA *ptorque = &pmotor->torqueControl;
+    const MCAF_U_CURRENT iqLimit = pmotor->iqCmdLimit;
+    
+    ptorque->iqCmd = UTIL_LimitSlewRateSymmetrical(
+                        UTIL_LimitS16(ptorque->iqCmdApi, -iqLimit, iqLimit),
+                        ptorque->iqCmd,
+                        ptorque->slewRate);
+    torqueControlClampSet(pmotor);
+    
+    const MCAF_PISTATE_T *pctrl = &pmotor->omegaCtrl;
+    pmotor->idqCmdRaw.q = ptorque->velocityLimiting
+                        ? UTIL_LimitS16(pmotor->idqCmdRaw.q, pctrl->outMin, pctrl->outMax)
+                        : ptorque->iqCmd;
+}
+
+/**
+ * Executes one step of the position loop.
+ * 
+ * The position loop is a proportional controller above the velocity loop;
+ * the velocity loop supplies the integral action, and its slew rate limits
+ * shape the motion between positions.
+ * 
+ * @param pmotor motor state data
+ * @return velocity command for the velocity loop
+ */
+inline static MCAF_U_VELOCITY_ELEC positionControlStep(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_POSITION_CONTROL_DATA *pposition = &pmotor->positionControl;
+    
+    const int32_t error = pposition->positionCmdApi 
+                        - MCAF_EstimatorQeiPosition(&pmotor->estimator.qei);
+    pposition->positionError = UTIL_LimitS32ToS16(error, INT16_MAX);
+    const int32_t velocityCmd = UTIL_mulss(pposition->positionError, pposition->kp) >> KPOSP_Q;
+    pposition->velocityCmd = UTIL_LimitS32ToS16(velocityCmd, pposition->velocityLimit);
+    return pposition->velocityCmd;
+}
+
 /**
  * Compute alpha-axis voltage perturbation
  * 
@@ -555,10 +739,32 @@ void MCAF_VelocityAndCurrentControllerStep(MCAF_MOTOR_DATA *pmotor)
         const bool executeVelocityControlLoop =
             MCAF_OperatingModeNormal(&pmotor->testing) && MCAF_IsClosedLoopVelocity(pmotor);
 
-        if (executeVelocityControlLoop)
+        const bool executeTorqueControl = executeVelocityControlLoop
+                                        && pmotor->torqueControl.enableApi
+                                        && (pmotor->state == MCSM_RUNNING);
+        if (executeTorqueControl != pmotor->torqueControl.active)
+        {
+            switchTorqueControl(pmotor, executeTorqueControl);
+        }
+        
+        /* The position loop needs the encoder position. Changes in either
+         * direction are bumpless, since the velocity command is slew-rate limited. */
+        pmotor->positionControl.active = executeVelocityControlLoop
+                                       && pmotor->positionControl.enableApi
+                                       && (pmotor->state == MCSM_RUNNING)
+                                       && MCAF_EstimatorQeiIsActive(&pmotor->estimator);
+        
+        if (executeTorqueControl)
         {
+            torqueControlStep(pmotor);
+        }
+        else if (executeVelocityControlLoop)
+        {
+            const int16_t velocityCmd = pmotor->positionControl.active
+                                      ? positionControlStep(pmotor)
+                                      : pmotor->velocityControl.velocityCmd;
             const int16_t velocityCmdPerturbed = 
-                  pmotor->velocityControl.velocityCmd
+                  velocityCmd
                 + MCAF_TestPerturbationVelocity(&pmotor->testing);
 
             pmotor->velocityControl.velocityCmdRateLimited =
@@ -585,21 +791,7 @@ void MCAF_VelocityAndCurrentControllerStep(MCAF_MOTOR_DATA *pmotor)
                     limitPos,   /* positive limit */
                     limitNeg);  /* negative limit */
       
-            /* Antiwindup feedback for the velocity controller should include
-             * - both current and voltage saturation, if flux-weakening is not enabled,
-             * - only current saturation,             if flux-weakening is enabled.
-             *
-             * The reason for disallowing voltage saturation as antiwindup feedback
-             * when FW is enabled, is that the entire FW region is roughly equal in
-             * output voltage requirement. This makes the upper speed end of FW 
-             * effectively indistinguishable from the lower speed end of FW
-             * from looking at the voltage required from the current loop.
-             */
-            const MCAF_SAT_STATE_T satState = pmotor->sat.state;
-            const MCAF_SAT_STATE_T satStateMasked =
-                MCAF_FluxWeakEnabled()
-                ? MCAF_SatMask(satState, MCAF_SAT_CURRENT)
-                : satState;
+            const MCAF_SAT_STATE_T satStateMasked = velocityLoopSaturationState(pmotor);
                 
             const int16_t velocityReference =
                 (MCAF_OuterLoopType() == MCAF_OLT_VOLTAGE)
@@ -618,21 +810,39 @@ void MCAF_VelocityAndCurrentControllerStep(MCAF_MOTOR_DATA *pmotor)
                 satStateMasked,
                 &pmotor->idqCmdRaw.q,
                 direction);
+        }
         
-            if (!MCAF_OverrideFluxControl(&pmotor->testing))
+        if (executeVelocityControlLoop && !MCAF_OverrideFluxControl(&pmotor->testing))
+        {
+            // Apply d-axis current command and q-axis current limit
+
+            pmotor->idqCmdRaw.d = MCAF_FluxControlGetIdCommand(&pmotor->fluxControl);
+            if (MCAF_ParamAdaptationEnabled())
+            {
+                pmotor->idqCmdRaw.d += MCAF_ParamAdaptGetIdInjection(&pmotor->paramAdapt);
+            }
+            const MCAF_U_CURRENT iCmdLimit = MCAF_DynamicCurrentLimitGet(&pmotor->dynLimit);
+            MCAF_U_CURRENT iqLimit = 
+                MCAF_FluxControlGetIqLimit(&pmotor->fluxControl, iCmdLimit);
+            if (MCAF_ParamAdaptationEnabled())
+            {
+                iqLimit = MCAF_ParamAdaptGetIqLimit(&pmotor->paramAdapt, iqLimit);
+            }
+            pmotor->iqCmdLimit = iqLimit;
+            if (!executeTorqueControl)
             {
-                // Apply d-axis current command and q-axis current limit
-                
-                pmotor->idqCmdRaw.d = MCAF_FluxControlGetIdCommand(&pmotor->fluxControl);
-                const MCAF_U_CURRENT iCmdLimit = MCAF_DynamicCurrentLimitGet(&pmotor->dynLimit);
-                const MCAF_U_CURRENT iqLimit = 
-                    MCAF_FluxControlGetIqLimit(&pmotor->fluxControl, iCmdLimit);
-                pmotor->iqCmdLimit = iqLimit;
                 pmotor->omegaCtrl.outMax = iqLimit;
                 pmotor->omegaCtrl.outMin = -iqLimit;
             }
         }
     }
+    
+    /* The torque reference bypasses the subsampled velocity loop,
+     * so that it reaches the current loop in the same ISR. */
+    if (pmotor->torqueControl.active)
+    {
+        torqueReferenceStep(pmotor);
+    }
 
     if (MCAF_OperatingModeCurrentLoopActive(&pmotor->testing))
     {
@@ -662,19 +872,20 @@ void MCAF_VelocityAndCurrentControllerStep(MCAF_MOTOR_DATA *pmotor)
                                            pmotor->psys->vDC);
         pmotor->idCtrl.outMax =  vlim_d;
         pmotor->idCtrl.outMin = -vlim_d;
-        /* PI control for D-axis */
-        MCAF_ControllerPIUpdate(
-                pmotor->idqCmd.d, 
-                pmotor->idq.d, 
-                &pmotor->idCtrl,
-                MCAF_SAT_NONE, 
-                &pmotor->vdqCmd.d,
-                0);
-        
-        pmotor->vdq.d = MCAF_ComputeVdPerturbation(pmotor);
 
         if (MCAF_OverrideDAxisVoltagePriority(&pmotor->testing))
         {
+            /* PI control for D-axis */
+            MCAF_ControllerPIUpdate(
+                    pmotor->idqCmd.d, 
+                    pmotor->idq.d, 
+                    &pmotor->idCtrl,
+                    MCAF_SAT_NONE, 
+                    &pmotor->vdqCmd.d,
+                    0);
+            
+            pmotor->vdq.d = MCAF_ComputeVdPerturbation(pmotor);
+
             /*
              * Vector limitation
              * Vd is not limited
@@ -689,23 +900,37 @@ void MCAF_VelocityAndCurrentControllerStep(MCAF_MOTOR_DATA *pmotor)
             const int16_t vdqSquaredLimit = UTIL_SignedSqr(UTIL_MulQ15(pmotor->psys->vDC, MCAF_CURRENT_CTRL_DQ_MAGNITUDE_LIMIT));
             pmotor->iqCtrl.outMax = Q15SQRT(vdqSquaredLimit - vdSquared);
             pmotor->iqCtrl.outMin = -pmotor->iqCtrl.outMax;
+
+            /* PI control for Q-axis */
+            MCAF_ControllerPIUpdate(
+                    pmotor->idqCmd.q,
+                    pmotor->idq.q,
+                    &pmotor->iqCtrl,
+                    MCAF_SAT_NONE, 
+                    &pmotor->vdqCmd.q,
+                    0);
         }
         else
         {
+            /* 
+             * The Q-axis limit does not depend on the D-axis output,
+             * so both axes can be updated in a single pass.
+             */
             const int16_t vlim_q = UTIL_MulQ15(pmotor->idqCtrlOutLimit.q,
                                                pmotor->psys->vDC);            
             pmotor->iqCtrl.outMax =  vlim_q;
             pmotor->iqCtrl.outMin = -vlim_q;
-        }
 
-        /* PI control for Q-axis */
-        MCAF_ControllerPIUpdate(
-                pmotor->idqCmd.q,
-                pmotor->idq.q,
-                &pmotor->iqCtrl,
-                MCAF_SAT_NONE, 
-                &pmotor->vdqCmd.q,
-                0);
+            /* PI control for D-axis and Q-axis */
+            MCAF_ControllerPIUpdateDQ(
+                    &pmotor->idqCmd,
+                    &pmotor->idq,
+                    &pmotor->idCtrl,
+                    &pmotor->iqCtrl,
+                    &pmotor->vdqCmd);
+
+            pmotor->vdq.d = MCAF_ComputeVdPerturbation(pmotor);
+        }
 
         pmotor->vdq.q = MCAF_ComputeVqPerturbation(pmotor);
     } /* end of OM_FORCE_CURRENT section */
@@ -791,6 +1016,13 @@ inline static void calculateManualZeroSequenceModulation(
 
 void MCAF_FocStepIsrForwardPath(MCAF_MOTOR_DATA *pmotor)
 {
+#if MCAF_INCLUDE_PARAM_ID
+    MCAF_ParamIdApplyIsr(pmotor);
+    /* vdq still holds the voltage applied during the last control cycle */
+    MCAF_ParamIdCaptureIsr(&pmotor->paramId, &pmotor->idq, &pmotor->vdq,
+                           pmotor->omegaElectrical);
+#endif
+
     /* Calculate control values */
     MCAF_VelocityAndCurrentControllerStep(pmotor);
 
@@ -884,6 +1116,25 @@ void MCAF_FocStepIsrForwardPath(MCAF_MOTOR_DATA *pmotor)
  * 4. Non-critical tasks
  */
 
+/**
+ * Checks whether Rs/Ke adaptation may run: only while running normally,
+ * and not while a test perturbation disturbs the steady state.
+ *
+ * @param pmotor motor state data
+ * @return whether adaptation may run
+ */
+inline static bool isParamAdaptationAllowed(const MCAF_MOTOR_DATA *pmotor)
+{
+#if MCAF_INCLUDE_PARAM_ID
+    if (pmotor->paramId.capturing)
+    {
+        return false;
+    }
+#endif
+    return (pmotor->state == MCSM_RUNNING)
+        && MCAF_OperatingModeNormal(&pmotor->testing);
+}
+
 void MCAF_FocStepIsrNonCriticalTask(MCAF_MOTOR_DATA* pmotor)
 {
     MCAF_ADCReadNonCritical(pmotor);
@@ -899,9 +1150,20 @@ void MCAF_FocStepIsrNonCriticalTask(MCAF_MOTOR_DATA* pmotor)
                          &pmotor->motorParameters);
     MCAF_CaptureTimestamp(&pmotor->testing, MCTIMESTAMP_FLUX_CONTROL_END);
 
+    if (MCAF_ParamAdaptationEnabled())
+    {
+        MCAF_ParamAdaptFilterStep(&pmotor->paramAdapt, &pmotor->idq,
+                                  &pmotor->vdq, pmotor->omegaElectrical);
+    }
+
     if (++pmotor->subsampleCounter >= MCAF_ISR_SUBSAMPLE_DIVIDER)
     {
         pmotor->subsampleCounter = 0;
+        if (MCAF_ParamAdaptationEnabled() && isParamAdaptationAllowed(pmotor))
+        {
+            MCAF_ParamAdaptUpdate(&pmotor->paramAdapt, pmotor->omegaElectrical,
+                                  pmotor->psys->vDC, &pmotor->motorParameters);
+        }
     }
     
     if (MCAF_OuterLoopType() == MCAF_OLT_VOLTAGE)
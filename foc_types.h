@@ -90,6 +90,40 @@ typedef struct tagMCAF_VELOCITY_CONTROL_DATA
     int16_t slewRateLimitDecel;   /** deceleration slew rate limit */
 } MCAF_VELOCITY_CONTROL_DATA;
 
+/**
+ * Torque control data
+ * 
+ * In torque control, the q-axis current command follows a reference
+ * from MCAPI instead of the output of the velocity loop.
+ */
+typedef struct tagMCAF_TORQUE_CONTROL_DATA
+{
+    bool enableApi;                      /** torque control requested through MCAPI */
+    bool active;                         /** torque control replaces the velocity loop */
+    MCAF_U_CURRENT iqCmdApi;             /** q-axis current reference received from MCAPI */
+    MCAF_U_CURRENT iqCmd;                /** q-axis current reference after slew rate limiting */
+    int16_t slewRate;                    /** maximum change in iqCmd per ISR */
+    bool velocityLimiting;               /** the velocity limit holds the current below iqCmd */
+    MCAF_U_VELOCITY_ELEC velocityLimit;  /** velocity magnitude that torque control may not exceed */
+} MCAF_TORQUE_CONTROL_DATA;
+
+/**
+ * Position control data
+ * 
+ * In position control, a proportional position loop computes the 
+ * velocity command for the velocity loop from the encoder position.
+ */
+typedef struct tagMCAF_POSITION_CONTROL_DATA
+{
+    bool enableApi;                      /** position control requested through MCAPI */
+    bool active;                         /** position loop replaces the MCAPI velocity command */
+    int32_t positionCmdApi;              /** position reference received from MCAPI, in encoder counts */
+    int16_t kp;                          /** proportional gain, velocity per count */
+    MCAF_U_VELOCITY_ELEC velocityLimit;  /** velocity magnitude that the position loop may command */
+    int16_t positionError;               /** position error in counts, saturated to 16 bits */
+    MCAF_U_VELOCITY_ELEC velocityCmd;    /** velocity command computed by the position loop */
+} MCAF_POSITION_CONTROL_DATA;
+
 /**
  * Standard input signals
  * 
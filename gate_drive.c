@@ -63,7 +63,7 @@ static inline uint16_t minimumDutyCycleForBootstrapCharging(void)
     return HAL_PARAM_PWM_PERIOD_COUNTS - HAL_PARAM_MIN_LOWER_DUTY_COUNTS;
 }
 
-bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap)
+bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap, const HAL_MOTOR_MAP_T *phal)
 {
     bool returnState = false;
     
@@ -72,12 +72,12 @@ bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap)
         case MCBS_IDLE_START:
             /* Override high-side PWMx to LOW and set 
              * low-side PWMx to 0% duty cycle */
-            HAL_PWM_Outputs_Disable();
+            HAL_PWM_Outputs_DisableInstance(phal);
             pbootstrap->dutycycle[0] = HAL_PARAM_PWM_PERIOD_COUNTS;
             pbootstrap->dutycycle[1] = HAL_PARAM_PWM_PERIOD_COUNTS;
             pbootstrap->dutycycle[2] = HAL_PARAM_PWM_PERIOD_COUNTS;
-            HAL_PWM_UpperTransistorsOverride_Low();
-            HAL_PWM_LowerTransistorsOverride_Disable();
+            HAL_PWM_UpperTransistorsOverride_LowInstance(phal);
+            HAL_PWM_LowerTransistorsOverride_DisableInstance(phal);
             
             pbootstrap->delayCount = MCAF_BOARD_BOOTSTRAP_INITIAL_DELAY;
             pbootstrap->state = MCBS_WAIT_INITIAL;
@@ -142,7 +142,7 @@ bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap)
             returnState = true;
             break;
     }
-    HAL_PWM_DutyCycle_Set(pbootstrap->dutycycle);
+    HAL_PWM_DutyCycle_SetInstance(phal, pbootstrap->dutycycle);
     
     if (pbootstrap->delayCount > 0)
     {
@@ -150,4 +150,4 @@ bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap)
     }
     
     return returnState;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -68,12 +68,13 @@ void MCAF_BootstrapChargeInit(MCAF_BOOTSTRAP_STATE *pbootstrap);
  * It implements a state machine to soft-start the board by sequentially ramping up phase
  * duty cycle values to the desired value. This bootstrap step occurs in the control ISR.
  * @param pbootstrap bootstrap state data
+ * @param phal PWM resources of the motor being charged
  * @return bool value true when bootstrap sequence is complete
  */
-bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap);
+bool MCAF_BootstrapChargeStepIsr(MCAF_BOOTSTRAP_STATE *pbootstrap, const HAL_MOTOR_MAP_T *phal);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* __MCAF_GATE_DRIVE_H */
\ No newline at end of file
+#endif /* __MCAF_GATE_DRIVE_H */
\ No newline at end of file
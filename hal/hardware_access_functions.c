@@ -51,6 +51,21 @@
 
 volatile HAL_DATA_T halData;
 
+#if MCAF_MOTOR_COUNT != 1
+#error "This board provides the PWM generators and current-sense channels of one motor only"
+#endif
+
+const HAL_MOTOR_MAP_T halMotorMap[MCAF_MOTOR_COUNT] = {
+    {
+        .pwmPhaseA = MOTOR1_PHASE_A,
+        .pwmPhaseB = MOTOR1_PHASE_B,
+        .pwmPhaseC = MOTOR1_PHASE_C,
+        .adcPhaseACurrent = MCAF_ADC_PHASEA_CURRENT,
+        .adcPhaseBCurrent = MCAF_ADC_PHASEB_CURRENT,
+        .adcPhaseCCurrent = MCAF_ADC_PHASEC_CURRENT
+    }
+};
+
 /*****************************************************************************/
 /* Section: HAF board functions                                              */
 /*****************************************************************************/
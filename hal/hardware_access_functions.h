@@ -125,12 +125,15 @@ extern "C" {
  */
 #define HAL_ADC_ISR                     _ADCAN15Interrupt
 #define MCAF_ADC_CHANNEL_USED_FOR_ISR   MCAF_ADC_DCLINK_VOLTAGE
+#define HAL_UART_RX_ISR                 _U1RXInterrupt
+#define HAL_UART_TX_ISR                 _U1TXInterrupt
 
 /** Interrupt priorities used in MCAF */
 enum {
     MCAF_PRIORITY_ADC = 6,                /** Primary motor control ISR priority */
     MCAF_PRIORITY_ADC_SINGLECHANNEL = 5,  /** ISR priority for DC link current measurement(single-channel) */
-    MCAF_PRIORITY_TMR = 4                 /** Periodic timer tick ISR priority */
+    MCAF_PRIORITY_TMR = 4,                /** Periodic timer tick ISR priority */
+    MCAF_PRIORITY_UART = 2                /** Buffered diagnostics UART ISR priority */
 };
 
 /**
@@ -1299,6 +1302,58 @@ inline static bool HAL_UART_IsTxReady(void)
 #endif
 }
 
+/*
+ * The UART interrupt functions below, and the HAL_UART_RX_ISR and
+ * HAL_UART_TX_ISR handlers in uart_buffer.c, make MCAF the only owner
+ * of the UART1 interrupts. They access the interrupt controller directly,
+ * because the UART driver generated for this project is in polled mode:
+ * it neither enables the UART1 interrupts nor defines their ISRs.
+ * The driver must stay configured that way (interrupts disabled)
+ * while MCAF_INCLUDE_BUFFERED_UART is enabled; otherwise its ISRs
+ * would clash with those in uart_buffer.c at link time.
+ */
+
+/**
+ * Sets the priority of the UART receive and transmit interrupts,
+ * and clears their interrupt flags.
+ * 
+ * The UART is left at its reset interrupt thresholds:
+ * the receive interrupt is requested while the rx buffer has data,
+ * and the transmit interrupt is requested while the tx buffer is empty.
+ */
+inline static void HAL_UART_InterruptInitialize(void)
+{
+    IPC2bits.U1RXIP = MCAF_PRIORITY_UART;
+    IPC3bits.U1TXIP = MCAF_PRIORITY_UART;
+    IFS0bits.U1RXIF = 0;
+    IFS0bits.U1TXIF = 0;
+}
+
+/**
+ * Enables the UART receive interrupt
+ */
+inline static void HAL_UART_RxInterrupt_Enable(void) { IEC0bits.U1RXIE = 1; }
+
+/**
+ * Clears the UART receive interrupt flag
+ */
+inline static void HAL_UART_RxInterruptFlag_Clear(void) { IFS0bits.U1RXIF = 0; }
+
+/**
+ * Enables the UART transmit interrupt
+ */
+inline static void HAL_UART_TxInterrupt_Enable(void) { IEC0bits.U1TXIE = 1; }
+
+/**
+ * Disables the UART transmit interrupt
+ */
+inline static void HAL_UART_TxInterrupt_Disable(void) { IEC0bits.U1TXIE = 0; }
+
+/**
+ * Clears the UART transmit interrupt flag
+ */
+inline static void HAL_UART_TxInterruptFlag_Clear(void) { IFS0bits.U1TXIF = 0; }
+
 
 /**
   Sub-section: Watchdog Module Access Functions
@@ -1489,6 +1544,39 @@ inline static uint16_t HAL_QEI_PositionCaptureGet(void)
     return QEI_PositionCaptureGet();
 #endif    
 }
+
+/**
+ * Sets the prescaler of the QEI interval timer, which measures
+ * the time between position counts.
+ * @param prescale prescaler selection (QEI1CONbits.INTDIV): 1:2^prescale
+ */
+inline static void HAL_QEI_IntervalTimerPrescaleSet(uint16_t prescale)
+{
+    QEI1CONbits.INTDIV = prescale;
+}
+
+/**
+ * Returns the frequency of the QEI interval timer, which runs from
+ * the instruction clock divided by the prescaler.
+ * @param prescale prescaler selection (QEI1CONbits.INTDIV): 1:2^prescale
+ * @return interval timer frequency in Hz
+ */
+inline static uint32_t HAL_QEI_IntervalTimerFrequencyGet(uint16_t prescale)
+{
+    return (uint32_t)FCY >> prescale;
+}
+
+/**
+ * Reads the QEI interval timer hold register. The interval timer is
+ * latched into this register when the position count is read, so 
+ * after HAL_QEI_PositionCountGet() this is the time from the most recent
+ * count to that read.
+ * @return interval timer value latched at the last position count read
+ */
+inline static uint16_t HAL_QEI_IntervalTimerHoldGet(void)
+{
+    return INT1HLDL;
+}
  
 
 /**
@@ -1758,6 +1846,391 @@ inline static void HAL_UART_ReconfigureIoMapping(void)
     // no action required
 }
 
+/**
+  Sub-section: Per-instance motor access functions
+
+  These mirror the Motor #1 functions above, but take the peripheral
+  resources from a HAL_MOTOR_MAP_T so that the same control code can
+  drive any motor instance.
+*/
+
+/** Peripheral resources of each motor instance, indexed by instance number */
+extern const HAL_MOTOR_MAP_T halMotorMap[MCAF_MOTOR_COUNT];
+
+#if MCAF_MOTOR_COUNT == 1
+/* With a single instance, use the MCC-generated identifiers directly, so that
+ * the PWM and ADC accesses in the ISR compile to the same code as the
+ * Motor #1 functions instead of loading the identifiers from the map. */
+#define HAL_MOTOR_PWM_PHASE_A(pmap)         MOTOR1_PHASE_A
+#define HAL_MOTOR_PWM_PHASE_B(pmap)         MOTOR1_PHASE_B
+#define HAL_MOTOR_PWM_PHASE_C(pmap)         MOTOR1_PHASE_C
+#define HAL_MOTOR_ADC_PHASEA_CURRENT(pmap)  MCAF_ADC_PHASEA_CURRENT
+#define HAL_MOTOR_ADC_PHASEB_CURRENT(pmap)  MCAF_ADC_PHASEB_CURRENT
+#define HAL_MOTOR_ADC_PHASEC_CURRENT(pmap)  MCAF_ADC_PHASEC_CURRENT
+#else
+#define HAL_MOTOR_PWM_PHASE_A(pmap)         ((pmap)->pwmPhaseA)
+#define HAL_MOTOR_PWM_PHASE_B(pmap)         ((pmap)->pwmPhaseB)
+#define HAL_MOTOR_PWM_PHASE_C(pmap)         ((pmap)->pwmPhaseC)
+#define HAL_MOTOR_ADC_PHASEA_CURRENT(pmap)  ((pmap)->adcPhaseACurrent)
+#define HAL_MOTOR_ADC_PHASEB_CURRENT(pmap)  ((pmap)->adcPhaseBCurrent)
+#define HAL_MOTOR_ADC_PHASEC_CURRENT(pmap)  ((pmap)->adcPhaseCCurrent)
+#endif
+
+/**
+ * Writes three unique duty cycle values to the PWM generators of a motor instance.
+ * @param pmap motor instance resources
+ * @param pdc Pointer to the array that holds duty cycle values
+ */
+inline static void HAL_PWM_DutyCycleRegister_SetInstance(const HAL_MOTOR_MAP_T *pmap, const uint16_t *pdc)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_A(pmap),pdc[0]);
+    MCC_PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_B(pmap),pdc[1]);
+    MCC_PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_C(pmap),pdc[2]);
+#else
+    PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_A(pmap),pdc[0]);
+    PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_B(pmap),pdc[1]);
+    PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_C(pmap),pdc[2]);
+#endif
+}
+
+/**
+ * Writes three unique phase values to the PWM generators of a motor instance.
+ * @param pmap motor instance resources
+ * @param phase Pointer to the array that holds phase values
+ */
+inline static void HAL_PWM_PhaseRegister_SetInstance(const HAL_MOTOR_MAP_T *pmap, const uint16_t *phase)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_A(pmap),phase[0]);
+    MCC_PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_B(pmap),phase[1]);
+    MCC_PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_C(pmap),phase[2]);
+#else
+    PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_A(pmap),phase[0]);
+    PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_B(pmap),phase[1]);
+    PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_C(pmap),phase[2]);
+#endif
+}
+
+/**
+ * Writes three unique duty cycle values to both halves of the PWM duty
+ * cycles of a motor instance.
+ * @param pmap motor instance resources
+ * @param pdc Pointer to the array that holds duty cycle values
+ */
+inline static void HAL_PWM_DutyCycle_SetInstance(const HAL_MOTOR_MAP_T *pmap, const uint16_t *pdc)
+{
+    #if MCAF_SINGLE_CHANNEL_SUPPORT
+    HAL_PWM_PhaseRegister_SetInstance(pmap, pdc);
+    #endif 
+    HAL_PWM_DutyCycleRegister_SetInstance(pmap, pdc);
+}
+
+/**
+ * Writes the first half and second half of the PWM duty cycles of a motor instance.
+ * @param pmap motor instance resources
+ * @param firstHalf Pointer to the array that holds the first half of PWM duty cycle
+ * @param secondHalf Pointer to the array that holds the second half of PWM duty cycle
+ */
+inline static void HAL_PWM_DutyCycleDualEdge_SetInstance(const HAL_MOTOR_MAP_T *pmap,
+                                                         const uint16_t *firstHalf,
+                                                         const uint16_t *secondHalf)
+{
+    HAL_PWM_PhaseRegister_SetInstance(pmap, firstHalf);
+    HAL_PWM_DutyCycleRegister_SetInstance(pmap, secondHalf);
+}
+
+/**
+ * Writes the same duty cycle value to all PWM generators of a motor instance.
+ * @param pmap motor instance resources
+ * @param dc duty cycle value
+ */
+inline static void HAL_PWM_DutyCycle_SetIdenticalInstance(const HAL_MOTOR_MAP_T *pmap, uint16_t dc)
+{
+#ifdef MCC_MELODY
+    #if MCAF_SINGLE_CHANNEL_SUPPORT
+    MCC_PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_A(pmap),dc);
+    MCC_PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_B(pmap),dc);
+    MCC_PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_C(pmap),dc);
+    #endif
+    MCC_PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_A(pmap),dc);
+    MCC_PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_B(pmap),dc);
+    MCC_PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_C(pmap),dc);
+#else
+    #if MCAF_SINGLE_CHANNEL_SUPPORT
+    PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_A(pmap),dc);
+    PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_B(pmap),dc);
+    PWM_PhaseSet(HAL_MOTOR_PWM_PHASE_C(pmap),dc);
+    #endif
+    PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_A(pmap),dc);
+    PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_B(pmap),dc);
+    PWM_DutyCycleSet(HAL_MOTOR_PWM_PHASE_C(pmap),dc);
+#endif
+}
+
+/**
+ * Disables PWM override on the three low-side transistors of a motor instance.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_LowerTransistorsOverride_DisableInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_OverrideLowDisable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    MCC_PWM_OverrideLowDisable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    MCC_PWM_OverrideLowDisable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#else
+    PWM_OverrideLowDisable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    PWM_OverrideLowDisable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    PWM_OverrideLowDisable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#endif
+}
+
+/**
+ * Disables PWM override on the three high-side transistors of a motor instance.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_UpperTransistorsOverride_DisableInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_OverrideHighDisable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    MCC_PWM_OverrideHighDisable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    MCC_PWM_OverrideHighDisable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#else
+    PWM_OverrideHighDisable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    PWM_OverrideHighDisable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    PWM_OverrideHighDisable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#endif
+}
+
+/**
+ * Overrides the three high-side transistors of a motor instance to the OFF state.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_UpperTransistorsOverride_LowInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_A(pmap),0);
+    MCC_PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_B(pmap),0);
+    MCC_PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_C(pmap),0);
+
+    MCC_PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    MCC_PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    MCC_PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#else
+    PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_A(pmap),0);
+    PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_B(pmap),0);
+    PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_C(pmap),0);
+
+    PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#endif
+}
+
+/**
+ * Maintains the low-side transistors of a motor instance at the requested
+ * duty cycle while keeping the high-side transistors OFF.
+ * @param pmap motor instance resources
+ * @param pwmPeriodCount PWM period count
+ * @param dc Duty cycle value for the low-side transistors
+ */
+inline static void HAL_PWM_LowerTransistorsDutyCycle_SetInstance(const HAL_MOTOR_MAP_T *pmap,
+                                                                 uint16_t pwmPeriodCount, uint16_t dc)
+{
+    HAL_PWM_UpperTransistorsOverride_LowInstance(pmap);
+
+    uint16_t dutyCycleLowSide = pwmPeriodCount;
+    dutyCycleLowSide -= dc;
+
+    HAL_PWM_DutyCycle_SetIdenticalInstance(pmap, dutyCycleLowSide);
+}
+
+/**
+ * Disables the PWM channels of a motor instance by overriding them to low state.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_Outputs_DisableInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_A(pmap),0);
+    MCC_PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_B(pmap),0);
+    MCC_PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_C(pmap),0);
+
+    MCC_PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    MCC_PWM_OverrideLowEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    MCC_PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    MCC_PWM_OverrideLowEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    MCC_PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+    MCC_PWM_OverrideLowEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#else
+    PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_A(pmap),0);
+    PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_B(pmap),0);
+    PWM_OverrideDataSet(HAL_MOTOR_PWM_PHASE_C(pmap),0);
+
+    PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    PWM_OverrideLowEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+    PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    PWM_OverrideLowEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+    PWM_OverrideHighEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+    PWM_OverrideLowEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+#endif
+}
+
+/**
+ * Clears the PWM fault status of a motor instance.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_FaultStatus_ClearInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_GeneratorEventStatusClear(HAL_MOTOR_PWM_PHASE_A(pmap), PWM_GENERATOR_INTERRUPT_FAULT);
+    MCC_PWM_GeneratorEventStatusClear(HAL_MOTOR_PWM_PHASE_B(pmap), PWM_GENERATOR_INTERRUPT_FAULT);
+    MCC_PWM_GeneratorEventStatusClear(HAL_MOTOR_PWM_PHASE_C(pmap), PWM_GENERATOR_INTERRUPT_FAULT);
+#else
+    PWM_GeneratorEventStatusClear(HAL_MOTOR_PWM_PHASE_A(pmap),PWM_GENERATOR_INTERRUPT_FAULT);
+    PWM_GeneratorEventStatusClear(HAL_MOTOR_PWM_PHASE_B(pmap),PWM_GENERATOR_INTERRUPT_FAULT);
+    PWM_GeneratorEventStatusClear(HAL_MOTOR_PWM_PHASE_C(pmap),PWM_GENERATOR_INTERRUPT_FAULT);
+#endif
+}
+
+/**
+ * Gets the PWM fault status of a motor instance.
+ * @param pmap motor instance resources
+ * @return whether a PWM fault is active
+ */
+inline static bool HAL_PWM_FaultStatus_GetInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    return MCC_PWM_GeneratorEventStatusGet(HAL_MOTOR_PWM_PHASE_A(pmap),PWM_GENERATOR_INTERRUPT_FAULT);
+#else
+    return PWM_GeneratorEventStatusGet(HAL_MOTOR_PWM_PHASE_A(pmap),PWM_GENERATOR_INTERRUPT_FAULT);
+#endif
+}
+
+/**
+ * Begins the PWM fault clearing process for a motor instance.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_FaultClearBeginInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    #if (PWM_FAULT_LATCH_SOFTWARE_CLEAR_FEATURE_AVAILABLE)
+        MCC_PWM_FaultModeLatchClear(HAL_MOTOR_PWM_PHASE_A(pmap));
+        MCC_PWM_FaultModeLatchClear(HAL_MOTOR_PWM_PHASE_B(pmap));
+        MCC_PWM_FaultModeLatchClear(HAL_MOTOR_PWM_PHASE_C(pmap));
+    #else
+        MCC_PWM_FaultModeLatchDisable(HAL_MOTOR_PWM_PHASE_A(pmap));
+        MCC_PWM_FaultModeLatchDisable(HAL_MOTOR_PWM_PHASE_B(pmap));
+        MCC_PWM_FaultModeLatchDisable(HAL_MOTOR_PWM_PHASE_C(pmap));
+    #endif
+#else
+    #if (PWM_FAULT_LATCH_SOFTWARE_CLEAR_FEATURE_AVAILABLE)
+        PWM_FaultModeLatchClear(HAL_MOTOR_PWM_PHASE_A(pmap));
+        PWM_FaultModeLatchClear(HAL_MOTOR_PWM_PHASE_B(pmap));
+        PWM_FaultModeLatchClear(HAL_MOTOR_PWM_PHASE_C(pmap));
+    #else
+        PWM_FaultModeLatchDisable(HAL_MOTOR_PWM_PHASE_A(pmap));
+        PWM_FaultModeLatchDisable(HAL_MOTOR_PWM_PHASE_B(pmap));
+        PWM_FaultModeLatchDisable(HAL_MOTOR_PWM_PHASE_C(pmap));
+    #endif
+#endif
+}
+
+/**
+ * Ends the PWM fault clearing process for a motor instance.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_FaultClearEndInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#if !(PWM_FAULT_LATCH_SOFTWARE_CLEAR_FEATURE_AVAILABLE)
+    #ifdef MCC_MELODY
+        MCC_PWM_FaultModeLatchEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+        MCC_PWM_FaultModeLatchEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+        MCC_PWM_FaultModeLatchEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+    #else
+        PWM_FaultModeLatchEnable(HAL_MOTOR_PWM_PHASE_A(pmap));
+        PWM_FaultModeLatchEnable(HAL_MOTOR_PWM_PHASE_B(pmap));
+        PWM_FaultModeLatchEnable(HAL_MOTOR_PWM_PHASE_C(pmap));
+    #endif
+#endif
+}
+
+/**
+ * Sets the same dead time on all PWM generators of a motor instance.
+ * @param pmap motor instance resources
+ * @param dt dead time value
+ */
+inline static void HAL_PWM_SetDeadtimeIdenticalInstance(const HAL_MOTOR_MAP_T *pmap, uint16_t dt)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_DeadTimeSet(HAL_MOTOR_PWM_PHASE_A(pmap), dt);
+    MCC_PWM_DeadTimeSet(HAL_MOTOR_PWM_PHASE_B(pmap), dt);
+    MCC_PWM_DeadTimeSet(HAL_MOTOR_PWM_PHASE_C(pmap), dt);
+#else
+    PWM_DeadTimeSet(HAL_MOTOR_PWM_PHASE_A(pmap),dt);
+    PWM_DeadTimeSet(HAL_MOTOR_PWM_PHASE_B(pmap),dt);
+    PWM_DeadTimeSet(HAL_MOTOR_PWM_PHASE_C(pmap),dt);
+#endif
+}
+
+/**
+ * Sets up the ADC trigger of a motor instance so that its currents are
+ * sampled at the center of its own low-side pulse.
+ * @param pmap motor instance resources
+ */
+inline static void HAL_PWM_SetADCTriggerInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    MCC_PWM_TriggerACompareValueSet(HAL_MOTOR_PWM_PHASE_A(pmap),
+                                (HAL_PARAM_DEADTIME_COUNTS >> 1) + HAL_PARAM_ADC_TRIGGER_DELAY);
+#else
+    PWM_TriggerACompareValueSet(HAL_MOTOR_PWM_PHASE_A(pmap),
+                                (HAL_PARAM_DEADTIME_COUNTS >> 1) + HAL_PARAM_ADC_TRIGGER_DELAY);
+#endif
+}
+
+/**
+ * Gets the phase A current of a motor instance.
+ * @param pmap motor instance resources
+ * @return phase A current (ADC counts)
+ */
+inline static uint16_t HAL_ADC_ValuePhaseACurrentInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    return MCC_ADC_ConversionResultGet(HAL_MOTOR_ADC_PHASEA_CURRENT(pmap));
+#else
+    return ADC1_ConversionResultGet(HAL_MOTOR_ADC_PHASEA_CURRENT(pmap));
+#endif
+}
+
+/**
+ * Gets the phase B current of a motor instance.
+ * @param pmap motor instance resources
+ * @return phase B current (ADC counts)
+ */
+inline static uint16_t HAL_ADC_ValuePhaseBCurrentInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    return MCC_ADC_ConversionResultGet(HAL_MOTOR_ADC_PHASEB_CURRENT(pmap));
+#else
+    return ADC1_ConversionResultGet(HAL_MOTOR_ADC_PHASEB_CURRENT(pmap));
+#endif
+}
+
+/**
+ * Gets the phase C current of a motor instance.
+ * @param pmap motor instance resources
+ * @return phase C current (ADC counts)
+ */
+inline static uint16_t HAL_ADC_ValuePhaseCCurrentInstance(const HAL_MOTOR_MAP_T *pmap)
+{
+#ifdef MCC_MELODY
+    return MCC_ADC_ConversionResultGet(HAL_MOTOR_ADC_PHASEC_CURRENT(pmap));
+#else
+    return ADC1_ConversionResultGet(HAL_MOTOR_ADC_PHASEC_CURRENT(pmap));
+#endif
+}
+
 /**
  * Set all interrupt priorities.
  */
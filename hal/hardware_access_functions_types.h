@@ -79,6 +79,21 @@ typedef struct tagHAL_ADC_INPUTS_T
     uint16_t vDC;
 } HAL_ADC_INPUTS_T;
 
+/**
+ * Peripheral resources assigned to one motor instance.
+ * The PWM generator and ADC channel identifiers are the values
+ * generated by MCC (e.g. MOTOR1_PHASE_A, MCAF_ADC_PHASEA_CURRENT).
+ */
+typedef struct tagHAL_MOTOR_MAP_T
+{
+    uint16_t pwmPhaseA;          /** PWM generator driving phase A */
+    uint16_t pwmPhaseB;          /** PWM generator driving phase B */
+    uint16_t pwmPhaseC;          /** PWM generator driving phase C */
+    uint16_t adcPhaseACurrent;   /** ADC channel measuring phase A current */
+    uint16_t adcPhaseBCurrent;   /** ADC channel measuring phase B current */
+    uint16_t adcPhaseCCurrent;   /** ADC channel measuring phase C current */
+} HAL_MOTOR_MAP_T;
+
 typedef struct tagHAL_DATA_T
 {
     HAL_ADC_SELECT_T adcSelect;
@@ -79,6 +79,23 @@ extern MCAF_SYSTEM_DATA systemData;
 /** watchdog state, accessed directly */
 extern volatile MCAF_WATCHDOG_T watchdog;
 
+/**
+ * Executes the per-motor tasks that follow the control step
+ * in the ADC ISR of a motor instance.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void MCAF_MotorServiceIsr(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_UiStepIsr(&pmotor->ui);
+    MCAF_MonitorStepIsr(pmotor);
+    MCAF_CalculateFilteredCurrent(pmotor);
+    MCAF_ApiServiceIsr(pmotor);
+#if MCAF_INCLUDE_FLIGHT_RECORDER
+    MCAF_RecorderStepIsr(&pmotor->recorder, pmotor->fsm.isrCount);
+#endif
+}
+
 /**
  * Executes tasks in the ISR for ADC interrupts.
  * 
@@ -103,12 +120,9 @@ void __attribute__((interrupt, auto_psv)) HAL_ADC_ISR(void)
 #endif
     MCAF_SystemStateMachine_StepIsr(&motor); // data is read from ADC buffer every ISR
     HAL_ADC_InterruptFlag_Clear(); // interrupt flag must be cleared after data is read from ADC buffer
-    MCAF_UiStepIsr(&motor.ui);
-    MCAF_MonitorStepIsr(&motor);
+    MCAF_MotorServiceIsr(&motor);
     MCAF_WatchdogManageIsr(&watchdog);
     HAL_ADC_StepIsrCallback();
-    MCAF_CalculateFilteredCurrent(&motor);
-    MCAF_ApiServiceIsr(&motor);
 
     /* Test and diagnostics code are always the lowest-priority routine within 
      * this ISR; diagnostics code should always be last.
@@ -131,4 +145,4 @@ void __attribute__((interrupt, auto_psv)) HAL_ADC_SINGLE_CHANNEL_ISR(void)
     
     ADC1_IndividualChannelInterruptFlagClear(MCAF_ADC_DCLINK_CURRENT);
 }
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
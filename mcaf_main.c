@@ -56,6 +56,8 @@
 #include "stall_detect.h"
 #include "recover.h"
 #include "mcaf_watchdog.h"
+#include "param_id.h"
+#include "flight_recorder.h"
 #include "mcaf_traps.h"
 #include "ui.h"
 #include "parameters/init_params.h"
@@ -69,6 +71,10 @@
 #endif
 /** Global instance of the main set of motor state variables */
 MCAF_MOTOR_DATA motor;
+/** Motor instances, indexed by instance number */
+MCAF_MOTOR_DATA * const motorInstance[MCAF_MOTOR_COUNT] = {
+    &motor
+};
 /** Global instance of the main set of system state variables */
 MCAF_SYSTEM_DATA systemData;
 
@@ -76,17 +82,27 @@ extern volatile MCAF_WATCHDOG_T watchdog;
 
 bool MCAF_MainInit(void)
 {
-    MCAF_SystemStateInit(&motor, &systemData);
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        MCAF_SystemStateInit(motorInstance[i], &systemData, &halMotorMap[i]);
+    }
     MCAF_SystemInit(&systemData);
     MCAF_BoardServiceInit(&systemData.board);
-    MCAF_UiInit(&motor.ui);
-    MCAF_MonitorInit(&motor.monitor);
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        MCAF_MOTOR_DATA *pmotor = motorInstance[i];
+        MCAF_UiInit(&pmotor->ui);
+        MCAF_MonitorInit(&pmotor->monitor);
 #if MCAF_INCLUDE_STALL_DETECT  
-    MCAF_StallDetectInit(&motor.stallDetect);
+        MCAF_StallDetectInit(&pmotor->stallDetect);
 #endif
-    MCAF_FaultDetectInit(&motor.faultDetect);
-    MCAF_RecoveryInit(&motor.recovery);
-    MCAF_SystemStateMachine_Init(&motor);
+        MCAF_FaultDetectInit(&pmotor->faultDetect);
+        MCAF_RecoveryInit(&pmotor->recovery);
+        MCAF_SystemStateMachine_Init(pmotor);
+#if MCAF_INCLUDE_FLIGHT_RECORDER
+        MCAF_RecorderInit(pmotor, (i == 0) ? &MCAF_recorderSnapshot : NULL);
+#endif
+    }
     MCAF_SystemTestHarness_Init(&systemData.testing);
     
     /* Check reset cause and act upon it, prior to clearing the watchdog,
@@ -96,13 +112,20 @@ bool MCAF_MainInit(void)
     HAL_WATCHDOG_Timer_Enable();
     MCAF_WatchdogManageMainLoop(&watchdog);
     
-    MCAPI_Initialize(&motor.apiData);
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        MCAPI_Initialize(&motorInstance[i]->apiData);
+    }
     
     APP_StartupTestApplicationInitialize(&motor.apiData, &systemData.board);
     
     MCAF_InitControlParameters_Motor1(&motor);
     
-    bool success = MCAF_FocInit(&motor);
+    bool success = true;
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        success = MCAF_FocInit(motorInstance[i]) && success;
+    }
     if (success)
     {
         MCAF_SystemStart(&systemData);
@@ -122,8 +145,11 @@ bool MCAF_MainInit(void)
 
     while (!MCAF_GateDriverReady(&systemData.board.gateDriver))
     {
-        MCAF_UiStepMain(&motor.ui);
-        MCAF_SystemStateMachine_StepMain(&motor);
+        for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+        {
+            MCAF_UiStepMain(&motorInstance[i]->ui);
+            MCAF_SystemStateMachine_StepMain(motorInstance[i]);
+        }
         MCAF_TestHarnessStepMain(&systemData.testing);
         MCAF_DiagnosticsStepMain();
     }
@@ -137,12 +163,18 @@ void MCAF_MainLoop(void)
      * (since no interruptions)
      * but in main loop, the ISR may interrupt + we need to assume volatile.
      */
-    volatile MCAF_MOTOR_DATA *pmotor = &motor;
     volatile MCAF_SYSTEM_DATA *psystemData = &systemData;
     volatile MCAF_WATCHDOG_T *pwatchdog = &watchdog;
     
-    MCAF_UiStepMain(&pmotor->ui);
-    MCAF_SystemStateMachine_StepMain(pmotor);
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        volatile MCAF_MOTOR_DATA *pmotor = motorInstance[i];
+        MCAF_UiStepMain(&pmotor->ui);
+        MCAF_SystemStateMachine_StepMain(pmotor);
+#if MCAF_INCLUDE_PARAM_ID
+        MCAF_ParamIdStepMain(pmotor);
+#endif
+    }
     MCAF_WatchdogManageMainLoop(pwatchdog);
     MCAF_TestHarnessStepMain(&psystemData->testing);
     MCAF_DiagnosticsStepMain();
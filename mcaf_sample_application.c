@@ -90,6 +90,13 @@ void APP_ApplicationStep(APPLICATION_DATA *appData)
     volatile MCAPI_MOTOR_DATA *apiData = appData->apiData;
     MCAF_BOARD_DATA *pboard = appData->pboard;
 
+    /* This application does not act on MCAF events; drain them,
+     * since the queue drops new events once it is full. */
+    MCAF_EVENT_T event;
+    while (MCAPI_EventGet(apiData, &event))
+    {
+    }
+
     if (appData->hardwareUiEnabled)
     {
         /* Use potentiometer to set motor velocity command */
@@ -128,6 +135,8 @@ void APP_ApplicationStep(APPLICATION_DATA *appData)
 
                 case MCAPI_MOTOR_STARTING:
                 case MCAPI_MOTOR_RUNNING:
+                case MCAPI_MOTOR_RUNNING_TORQUE:
+                case MCAPI_MOTOR_RUNNING_POSITION:
                 {
                     MCAPI_MotorStop(apiData);
                     break;
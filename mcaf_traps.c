@@ -48,6 +48,8 @@
 
 #include <xc.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include "mcaf_traps.h"
 #include "ui.h"
 #include "error_codes.h"
 #include "mcaf_watchdog.h"
@@ -113,6 +115,11 @@ void ERROR_HANDLER_NORETURN _DefaultInterrupt(void) {
     halt_on_error(ERR_UNEXPECTED_INTERRUPT_BASE + HAL_InterruptVector_Get());
 }
 
+bool MCAF_ResetCausedByTrapOrWatchdog(void)
+{
+    return (RCON & (0x8000 /* TRAPR */ | 0x4000 /* IOPUWR */ | 0x0010 /* WDTO */)) != 0;
+}
+
 void MCAF_CheckResetCause(void)
 {
     const uint16_t rconcopy = RCON;
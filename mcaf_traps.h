@@ -48,6 +48,8 @@
 #ifndef __MCAF_TRAPS_H
 #define __MCAF_TRAPS_H
 
+#include <stdbool.h>
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
@@ -61,6 +63,17 @@ extern "C" {
  */
 void MCAF_CheckResetCause(void);
 
+/**
+ * Checks whether the most recent reset was caused by a software failure:
+ * a trap conflict, an illegal opcode or a watchdog timeout.
+ * 
+ * Note: this function must be called before MCAF_CheckResetCause(),
+ * which clears the register showing reset cause.
+ * 
+ * @return true if the reset was caused by a trap or watchdog timeout
+ */
+bool MCAF_ResetCausedByTrapOrWatchdog(void);
+
 #ifdef  __cplusplus
 }
 #endif
@@ -50,6 +50,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "mcapi_types.h"
+#include "event_queue.h"
 #include "math_asm.h"
 #include "util.h"
 #include "parameters/mcapi_params.h"
@@ -83,6 +84,26 @@ static inline void MCAPI_Initialize(volatile MCAPI_MOTOR_DATA *pMotor)
    pMotor->velocityMaximum = MCAPI_MAXIMUM_VELOCITY;
    pMotor->velocityReference = pMotor->velocityMinimum;
    pMotor->velocityReferencePrevious = pMotor->velocityMinimum;
+   pMotor->controlMode = MCAPI_CONTROL_VELOCITY;
+   pMotor->torqueReference = 0;
+   pMotor->torqueSlewRate = MCAPI_TORQUE_SLEWRATE;
+   pMotor->torqueVelocityLimit = MCAPI_TORQUE_VELOCITY_LIMIT;
+   pMotor->positionReference = 0;
+   pMotor->positionVelocityLimit = MCAPI_POSITION_VELOCITY_LIMIT;
+   pMotor->positionMeasured = 0;
+   MCAF_EventQueueInit(&pMotor->events);
+   pMotor->statusSequence = 0;
+   pMotor->status.timestamp = 0;
+   pMotor->status.motorStatus = MCAPI_MOTOR_STOPPED;
+   pMotor->status.faultFlags = MCAPI_FAULT_FLAG_NO_FAULT;
+   pMotor->status.velocityMeasured = 0;
+   pMotor->status.iqFiltered = 0;
+   pMotor->status.isMagSquaredFiltered = 0;
+   pMotor->status.dcLinkVoltage = 0;
+   pMotor->status.currentLimitIqUpper = 0;
+   pMotor->status.currentLimitIqLower = 0;
+   pMotor->status.rotorStopped = false;
+   pMotor->startupConfigRequest = false;
 }
     
 /**
@@ -148,6 +169,177 @@ static inline int16_t MCAPI_VelocityReferenceGet(volatile MCAPI_MOTOR_DATA *pMot
     return velocityReference;
 }
 
+/**
+ * Selects velocity control, torque control or position control 
+ * for the specified motor.
+ * 
+ * In torque control, the q-axis current follows the torque reference
+ * (see MCAPI_TorqueReferenceSet()) instead of the output of the velocity
+ * loop, and MCAPI_OperatingStatusGet() reports MCAPI_MOTOR_RUNNING_TORQUE.
+ * Startup is unchanged: the motor starts in the direction of the velocity
+ * reference, and torque control takes over once the velocity loop is closed.
+ * The mode may be changed at any time; the change is bumpless in either
+ * direction. Torque control is suspended while the motor is stopping.
+ * 
+ * In position control, the velocity reference is replaced by the output
+ * of a position loop; see MCAPI_PositionReferenceSet().
+ * @param pMotor
+ * @param mode control mode
+ */
+static inline void MCAPI_ControlModeSet(volatile MCAPI_MOTOR_DATA *pMotor, MCAPI_CONTROL_MODE mode)
+{
+    pMotor->apiBusy = true;
+    pMotor->controlMode = mode;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Returns the control mode requested for the specified motor.
+ * @param pMotor
+ * @return control mode
+ */
+static inline MCAPI_CONTROL_MODE MCAPI_ControlModeGet(volatile MCAPI_MOTOR_DATA *pMotor)
+{
+    return pMotor->controlMode;
+}
+
+/**
+ * Sets the torque reference for the specified motor, used in torque control.
+ * The reference is applied in the next ISR, subject to the slew rate limit
+ * (see MCAPI_TorqueSlewRateSet()) and the q-axis current limits
+ * (see MCAPI_CurrentLimitIqUpperGet() and MCAPI_CurrentLimitIqLowerGet()).
+ * @param pMotor
+ * @param torque reference value, signed Q15 with the scaling factor 
+ * specified by MCAPI_FullscaleTorqueGet(); this is equivalent to q-axis current
+ * with the scaling factor specified by MCAPI_FullscaleCurrentGet()
+ */
+static inline void MCAPI_TorqueReferenceSet(volatile MCAPI_MOTOR_DATA *pMotor, int16_t torque)
+{
+    pMotor->apiBusy = true;
+    pMotor->torqueReference = torque;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Returns the torque reference for the specified motor, 
+ * as set by MCAPI_TorqueReferenceSet().
+ * @param pMotor
+ * @return torque reference, signed Q15 with the scaling factor 
+ * specified by MCAPI_FullscaleTorqueGet()
+ */
+static inline int16_t MCAPI_TorqueReferenceGet(volatile MCAPI_MOTOR_DATA *pMotor)
+{
+    pMotor->apiBusy = true;
+    int16_t torqueReference = pMotor->torqueReference;
+    pMotor->apiBusy = false;
+    return torqueReference;
+}
+
+/**
+ * Sets the slew rate limit of the torque reference for the specified motor.
+ * A value of INT16_MAX applies each new torque reference immediately.
+ * @param pMotor
+ * @param slewRate maximum change in torque reference per ISR, Q15 with 
+ * the scaling factor specified by MCAPI_FullscaleTorqueGet()
+ */
+static inline void MCAPI_TorqueSlewRateSet(volatile MCAPI_MOTOR_DATA *pMotor, int16_t slewRate)
+{
+    pMotor->apiBusy = true;
+    pMotor->torqueSlewRate = slewRate;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Sets the velocity limit for the specified motor in torque control.
+ * When the velocity magnitude reaches this limit, the velocity loop
+ * overrides the torque reference, braking if necessary, 
+ * to keep the motor from exceeding it.
+ * @param pMotor
+ * @param velocity velocity magnitude limit, Q15 with the scaling factor 
+ * specified by MCAPI_FullscaleVelocityGet()
+ */
+static inline void MCAPI_TorqueVelocityLimitSet(volatile MCAPI_MOTOR_DATA *pMotor, int16_t velocity)
+{
+    pMotor->apiBusy = true;
+    pMotor->torqueVelocityLimit = velocity;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Sets the position reference for the specified motor, used in position control.
+ * 
+ * Position control requires an encoder (see MCAF_EncoderEnabled()).
+ * It takes over from velocity control once the motor is running with
+ * the encoder aligned, and MCAPI_OperatingStatusGet() then reports 
+ * MCAPI_MOTOR_RUNNING_POSITION. Until then, the motor runs under velocity 
+ * control. The reference should be set before selecting position control,
+ * since the motor moves towards it as soon as position control takes over.
+ * Moves are limited in velocity by MCAPI_PositionVelocityLimitSet(), and
+ * in acceleration by the slew rate limits of the velocity loop.
+ * @param pMotor
+ * @param position multi-turn position reference, in encoder counts 
+ * (see MCAPI_PositionCountsPerRevolutionGet())
+ */
+static inline void MCAPI_PositionReferenceSet(volatile MCAPI_MOTOR_DATA *pMotor, int32_t position)
+{
+    pMotor->apiBusy = true;
+    pMotor->positionReference = position;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Returns the position reference for the specified motor, 
+ * as set by MCAPI_PositionReferenceSet().
+ * @param pMotor
+ * @return position reference, in encoder counts
+ */
+static inline int32_t MCAPI_PositionReferenceGet(volatile MCAPI_MOTOR_DATA *pMotor)
+{
+    pMotor->apiBusy = true;
+    int32_t positionReference = pMotor->positionReference;
+    pMotor->apiBusy = false;
+    return positionReference;
+}
+
+/**
+ * Sets the largest velocity magnitude that the position loop 
+ * of the specified motor may command.
+ * @param pMotor
+ * @param velocity velocity magnitude limit, Q15 with the scaling factor 
+ * specified by MCAPI_FullscaleVelocityGet()
+ */
+static inline void MCAPI_PositionVelocityLimitSet(volatile MCAPI_MOTOR_DATA *pMotor, int16_t velocity)
+{
+    pMotor->apiBusy = true;
+    pMotor->positionVelocityLimit = velocity;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Returns the position of the specified motor as measured by the encoder.
+ * The position is zero at reset; it is unaffected by stopping the motor.
+ * @param pMotor
+ * @return multi-turn position, in encoder counts
+ */
+static inline int32_t MCAPI_PositionMeasuredGet(volatile MCAPI_MOTOR_DATA *pMotor)
+{
+    pMotor->apiBusy = true;
+    int32_t positionMeasured = pMotor->positionMeasured;
+    pMotor->apiBusy = false;
+    return positionMeasured;
+}
+
+/**
+ * Returns the number of encoder counts per mechanical revolution,
+ * which is the scaling factor of positions in MCAPI.
+ * @param pMotor
+ * @return encoder counts per revolution
+ */
+static inline uint16_t MCAPI_PositionCountsPerRevolutionGet(const volatile MCAPI_MOTOR_DATA *pMotor)
+{
+    return MCAPI_POSITION_COUNTS_PER_REV;
+}
+
 /**
  * Returns velocity of the specified motor as measured by an estimator in MCAF.
  * Sign of the input value will determine the direction of rotation of the motor.
@@ -212,6 +404,83 @@ static inline void MCAPI_FaultStatusClear(volatile MCAPI_MOTOR_DATA *pMotor,
     pMotor->apiBusy = false;
 }
 
+/**
+ * Retrieves the oldest pending event posted by MCAF for the specified motor.
+ * Events are queued in the order they occurred, so transient conditions
+ * are reported even if they have already cleared.
+ * This function must be called from only one context.
+ * @param pMotor
+ * @param pEvent destination for the event
+ * @return true if an event was retrieved, false if none are pending
+ */
+static inline bool MCAPI_EventGet(volatile MCAPI_MOTOR_DATA *pMotor, MCAF_EVENT_T *pEvent)
+{
+    return MCAF_EventQueuePop(&pMotor->events, pEvent);
+}
+
+/**
+ * Reads a coherent snapshot of the status signals of the specified motor:
+ * state, faults, velocity, currents, DC link voltage, current limits
+ * and rotor standstill all belong to the same ISR.
+ * 
+ * This does not set the apiBusy flag or disable interrupts; if the ISR
+ * publishes a new snapshot during the copy, the copy is simply repeated.
+ * The copy is much shorter than the ISR period, so at most one retry
+ * is expected.
+ * @param pMotor
+ * @param pSnapshot destination for the snapshot
+ */
+static inline void MCAPI_StatusSnapshotGet(volatile MCAPI_MOTOR_DATA *pMotor, 
+                                           MCAPI_STATUS_SNAPSHOT *pSnapshot)
+{
+    uint16_t sequence;
+    do
+    {
+        sequence = pMotor->statusSequence;
+        pSnapshot->timestamp = pMotor->status.timestamp;
+        pSnapshot->motorStatus = pMotor->status.motorStatus;
+        pSnapshot->faultFlags = pMotor->status.faultFlags;
+        pSnapshot->velocityMeasured = pMotor->status.velocityMeasured;
+        pSnapshot->iqFiltered = pMotor->status.iqFiltered;
+        pSnapshot->isMagSquaredFiltered = pMotor->status.isMagSquaredFiltered;
+        pSnapshot->dcLinkVoltage = pMotor->status.dcLinkVoltage;
+        pSnapshot->currentLimitIqUpper = pMotor->status.currentLimitIqUpper;
+        pSnapshot->currentLimitIqLower = pMotor->status.currentLimitIqLower;
+        pSnapshot->rotorStopped = pMotor->status.rotorStopped;
+    } while ((sequence & 1) || (sequence != pMotor->statusSequence));
+}
+
+/**
+ * Requests new open-loop startup settings for the specified motor.
+ * MCAF applies them while the motor is stopped, so they take effect
+ * at the next start; until then MCAPI_StartupConfigPending() returns true.
+ * The settings remain in effect until changed again or until reset.
+ * @param pMotor
+ * @param pConfig startup settings
+ */
+static inline void MCAPI_StartupConfigSet(volatile MCAPI_MOTOR_DATA *pMotor,
+                                          const MCAPI_STARTUP_CONFIG *pConfig)
+{
+    pMotor->apiBusy = true;
+    pMotor->startupConfig.current = pConfig->current;
+    pMotor->startupConfig.acceleration[0] = pConfig->acceleration[0];
+    pMotor->startupConfig.acceleration[1] = pConfig->acceleration[1];
+    pMotor->startupConfig.holdTime = pConfig->holdTime;
+    pMotor->startupConfigRequest = true;
+    pMotor->apiBusy = false;
+}
+
+/**
+ * Returns whether startup settings requested by MCAPI_StartupConfigSet()
+ * have not yet been applied.
+ * @param pMotor
+ * @return true if the request is still pending
+ */
+static inline bool MCAPI_StartupConfigPending(volatile MCAPI_MOTOR_DATA *pMotor)
+{
+    return pMotor->startupConfigRequest;
+}
+
 /**
  * Gets status of the specified motor.
  * @param pMotor
@@ -398,4 +667,4 @@ static inline void MCAPI_ApplicationFaultCodeSet(volatile MCAPI_MOTOR_DATA *pMot
 }
 #endif
 
-#endif /* __MCAPI_H */
\ No newline at end of file
+#endif /* __MCAPI_H */
\ No newline at end of file
@@ -60,6 +60,7 @@
 #include "ui_types.h"
 #include "fault_detect.h"
 #include "fault_handle.h"
+#include "monitor.h"
 #include "error_codes.h"
 #include "filter.h"
 #include "parameters/mcapi_params.h"
@@ -191,7 +192,8 @@ inline static MCAF_U_VELOCITY_MECH MCAF_private_limit_speed_command(const volati
 
 /**
  * Private function that handles the User Interface related interactions 
- * between MCAF and MC API, which are motor start/stop and velocity reference.
+ * between MCAF and MC API, which are motor start/stop, velocity reference,
+ * torque control and position control.
  * @param pMotor motor data
  */
 inline static void handleUI(MCAF_MOTOR_DATA *pMotor)
@@ -218,11 +220,43 @@ inline static void handleUI(MCAF_MOTOR_DATA *pMotor)
         {
             pMotor->ui.flags ^= MCAF_UI_REVERSE;
             pMotor->ui.flags |= MCAF_UI_DIRECTION_CHANGED;
+            MCAF_EventPublish(pMotor, MCAF_EVENT_DIRECTION_CHANGE, pMotor->ui.flags);
         }
     }
     pApiData->velocityReferencePrevious = pApiData->velocityReference;
     
     pMotor->velocityControl.velocityCmdApi = MCAF_private_limit_speed_command(pApiData);
+    
+    MCAF_TORQUE_CONTROL_DATA *ptorque = &pMotor->torqueControl;
+    ptorque->enableApi = (pApiData->controlMode == MCAPI_CONTROL_TORQUE);
+    ptorque->iqCmdApi = pApiData->torqueReference;
+    ptorque->slewRate = pApiData->torqueSlewRate;
+    ptorque->velocityLimit = pApiData->torqueVelocityLimit;
+    
+    MCAF_POSITION_CONTROL_DATA *pposition = &pMotor->positionControl;
+    pposition->enableApi = (pApiData->controlMode == MCAPI_CONTROL_POSITION);
+    pposition->positionCmdApi = pApiData->positionReference;
+    pposition->velocityLimit = pApiData->positionVelocityLimit;
+}
+
+/**
+ * Private function that applies startup settings requested by the application.
+ * They are only written while the motor is stopped, so that a startup
+ * in progress never sees a partial update.
+ * @param pMotor motor data
+ */
+inline static void handleStartupConfig(MCAF_MOTOR_DATA *pMotor)
+{
+    volatile MCAPI_MOTOR_DATA *pApiData = &pMotor->apiData;
+    if (pApiData->startupConfigRequest && (pMotor->state == MCSM_STOPPED))
+    {
+        MCAF_MOTOR_STARTUP_DATA *pstartup = &pMotor->startup;
+        pstartup->iAmplitude = pApiData->startupConfig.current;
+        pstartup->acceleration[0] = pApiData->startupConfig.acceleration[0];
+        pstartup->acceleration[1] = pApiData->startupConfig.acceleration[1];
+        pstartup->holdTime = pApiData->startupConfig.holdTime;
+        pApiData->startupConfigRequest = false;
+    }
 }
 
 /**
@@ -242,7 +276,13 @@ inline static MCAPI_MOTOR_STATE determineMotorStatus(MCAF_MOTOR_DATA *pMotor)
             return MCAPI_MOTOR_STARTING;
             
         case MCSM_RUNNING:
-            return MCAPI_MOTOR_RUNNING;
+            if (pMotor->torqueControl.active)
+            {
+                return MCAPI_MOTOR_RUNNING_TORQUE;
+            }
+            return pMotor->positionControl.active
+                 ? MCAPI_MOTOR_RUNNING_POSITION
+                 : MCAPI_MOTOR_RUNNING;
             
         case MCSM_STOPPING:
             return MCAPI_MOTOR_STOPPING;
@@ -281,6 +321,33 @@ inline static void updateMotorOperatingParameters(MCAF_MOTOR_DATA *pMotor)
     pApiData->iqFiltered = pMotor->apiFeedback.iqFiltered;
     pApiData->isMagSquaredFiltered = pMotor->apiFeedback.isSquaredFiltered;
     pApiData->velocityMeasured = pMotor->omegaElectrical;
+    pApiData->positionMeasured = MCAF_EstimatorQeiPosition(&pMotor->estimator.qei);
+}
+
+/**
+ * Private function that publishes a consistent status snapshot.
+ * The sequence count is odd while the snapshot is being written,
+ * so a reader that is interrupted by this function can detect it and retry.
+ * @param pMotor motor data
+ * @param motorStatus abstracted motor status from determineMotorStatus()
+ */
+inline static void publishStatusSnapshot(MCAF_MOTOR_DATA *pMotor,
+                                         MCAPI_MOTOR_STATE motorStatus)
+{
+    volatile MCAPI_MOTOR_DATA *pApiData = &pMotor->apiData;
+    
+    ++pApiData->statusSequence;
+    pApiData->status.timestamp = pMotor->fsm.isrCount;
+    pApiData->status.motorStatus = motorStatus;
+    pApiData->status.faultFlags = pApiData->faultFlags;
+    pApiData->status.velocityMeasured = pMotor->omegaElectrical;
+    pApiData->status.iqFiltered = pMotor->apiFeedback.iqFiltered;
+    pApiData->status.isMagSquaredFiltered = pMotor->apiFeedback.isSquaredFiltered;
+    pApiData->status.dcLinkVoltage = MCAF_GetDcLinkVoltage(pMotor);
+    pApiData->status.currentLimitIqUpper = MCAF_CurrentLimitIqUpperGet(pMotor);
+    pApiData->status.currentLimitIqLower = MCAF_CurrentLimitIqLowerGet(pMotor);
+    pApiData->status.rotorStopped = MCAF_MonitorIsMotorStopped(pMotor);
+    ++pApiData->statusSequence;
 }
 
 /**
@@ -291,13 +358,21 @@ inline static void updateMotorOperatingParameters(MCAF_MOTOR_DATA *pMotor)
 static inline void MCAF_ApiServiceIsr(MCAF_MOTOR_DATA *pMotor)
 {
     volatile MCAPI_MOTOR_DATA *pApiData = &pMotor->apiData;
+    const MCAPI_MOTOR_STATE motorStatus = determineMotorStatus(pMotor);
     if (!pApiData->apiBusy)
     {
         handleFaults(pMotor);
         handleUI(pMotor);
-        pApiData->motorStatus = determineMotorStatus(pMotor);
+        handleStartupConfig(pMotor);
+        if (motorStatus != pApiData->motorStatus)
+        {
+            pApiData->motorStatus = motorStatus;
+            MCAF_EventPublish(pMotor, MCAF_EVENT_MCAPI_STATUS, motorStatus);
+        }
         updateMotorOperatingParameters(pMotor);
     }
+    /* the snapshot does not depend on apiBusy, so it is always published */
+    publishStatusSnapshot(pMotor, motorStatus);
 }
 
 /**
@@ -349,4 +424,4 @@ inline static void MCAF_CalculateFilteredCurrent(MCAF_MOTOR_DATA *pmotor)
 }
 #endif
 
-#endif /* __MCAPI_INTERNAL_H */
\ No newline at end of file
+#endif /* __MCAPI_INTERNAL_H */
\ No newline at end of file
@@ -0,0 +1,513 @@
+/**
+ * mcapi_remote.c
+ * 
+ * Binary command protocol that gives a remote host access to MCAPI
+ * over the diagnostics UART
+ * 
+ * Component: MCAPI
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "mcapi_remote.h"
+#include "mcapi.h"
+#include "uart_buffer.h"
+#include "util.h"
+#include "parameters/mcapi_remote_params.h"
+#include "parameters/timing_params.h"
+
+/** Size of the data of each setpoint in MCAPI_REMOTE_CMD_SCHEDULE_LOAD */
+#define MCAPI_REMOTE_SETPOINT_SIZE 4
+
+/** Status flags in the response to MCAPI_REMOTE_CMD_STATUS_GET */
+#define MCAPI_REMOTE_STATUS_ROTOR_STOPPED     0x01
+#define MCAPI_REMOTE_STATUS_SCHEDULE_RUNNING  0x02
+
+/**
+ * Reads a little-endian 16-bit value.
+ * 
+ * @param p first byte
+ * @return value
+ */
+inline static uint16_t MCAPI_RemoteGetU16(const uint8_t *p)
+{
+    return p[0] | ((uint16_t)p[1] << 8);
+}
+
+/**
+ * Writes a little-endian 16-bit value.
+ * 
+ * @param p first byte
+ * @param x value
+ * @return byte following the value
+ */
+inline static uint8_t *MCAPI_RemotePutU16(uint8_t *p, uint16_t x)
+{
+    *p++ = (uint8_t)x;
+    *p++ = (uint8_t)(x >> 8);
+    return p;
+}
+
+/**
+ * Returns the current time, as counted by the ISR.
+ * 
+ * @param apiData motor data
+ * @return ISR count
+ */
+static uint32_t MCAPI_RemoteTimeGet(volatile MCAPI_MOTOR_DATA *apiData)
+{
+    MCAPI_STATUS_SNAPSHOT status;
+    MCAPI_StatusSnapshotGet(apiData, &status);
+    return status.timestamp;
+}
+
+void MCAPI_RemoteInit(MCAPI_REMOTE_T *premote, volatile MCAPI_MOTOR_DATA *apiData)
+{
+    premote->apiData = apiData;
+    premote->rxState = MCAPI_REMOTE_RX_SYNC;
+    premote->crcErrors = 0;
+    premote->framingErrors = 0;
+    premote->txLength = 0;
+    premote->txIndex = 0;
+    premote->schedule.count = 0;
+    premote->schedule.running = false;
+    premote->ptelemetryEnable = NULL;
+    premote->telemetryStartPending = false;
+}
+
+/**
+ * Sets the velocity reference at the current time in the schedule.
+ * 
+ * @param premote remote protocol state
+ * @param elapsed time since the start of the schedule, in milliseconds
+ */
+static void MCAPI_RemoteScheduleApply(MCAPI_REMOTE_T *premote, uint16_t elapsed)
+{
+    MCAPI_REMOTE_SCHEDULE_T *pschedule = &premote->schedule;
+    const MCAPI_REMOTE_SETPOINT_T *ppoint = pschedule->point;
+    uint16_t index = pschedule->index;
+    while ((index < pschedule->count) && (ppoint[index].time <= elapsed))
+    {
+        ++index;
+    }
+    pschedule->index = index;
+    
+    int16_t velocity = pschedule->velocity;
+    if (index >= pschedule->count)
+    {
+        velocity = ppoint[pschedule->count - 1].velocity;
+    }
+    else if (index > 0)
+    {
+        const MCAPI_REMOTE_SETPOINT_T *p0 = &ppoint[index - 1];
+        velocity = p0->velocity;
+        if (pschedule->interpolate)
+        {
+            /* fraction of the interval is Q15, so the product fits in 32 bits */
+            const MCAPI_REMOTE_SETPOINT_T *p1 = &ppoint[index];
+            const uint32_t fraction = ((uint32_t)(elapsed - p0->time) << 15)
+                                    / (uint16_t)(p1->time - p0->time);
+            const int32_t dv = (int32_t)p1->velocity - p0->velocity;
+            velocity += (int16_t)((dv * (int32_t)fraction) >> 15);
+        }
+    }
+    
+    if (velocity != pschedule->velocity)
+    {
+        pschedule->velocity = velocity;
+        MCAPI_VelocityReferenceSet(premote->apiData, velocity);
+    }
+}
+
+void MCAPI_RemoteScheduleStep(MCAPI_REMOTE_T *premote)
+{
+    MCAPI_REMOTE_SCHEDULE_T *pschedule = &premote->schedule;
+    if (!pschedule->running)
+    {
+        return;
+    }
+    
+    const uint32_t ticks = MCAPI_RemoteTimeGet(premote->apiData) - pschedule->startTime;
+    const uint16_t elapsed = (ticks >= (uint32_t)UINT16_MAX * MCAF_ISR_SUBSAMPLE_DIVIDER)
+                           ? UINT16_MAX
+                           : __builtin_divud(ticks, MCAF_ISR_SUBSAMPLE_DIVIDER);
+    MCAPI_RemoteScheduleApply(premote, elapsed);
+    
+    if (pschedule->index >= pschedule->count)
+    {
+        pschedule->running = false;
+        if (pschedule->stopAtEnd)
+        {
+            MCAPI_MotorStop(premote->apiData);
+        }
+    }
+}
+
+/**
+ * Loads a setpoint schedule.
+ * 
+ * @param premote remote protocol state
+ * @param pdata command data
+ * @param length length of command data
+ * @return status code
+ */
+static uint16_t MCAPI_RemoteScheduleLoad(MCAPI_REMOTE_T *premote,
+        const uint8_t *pdata, uint16_t length)
+{
+    MCAPI_REMOTE_SCHEDULE_T *pschedule = &premote->schedule;
+    if (length < 2)
+    {
+        return MCAPI_REMOTE_ERR_LENGTH;
+    }
+    const uint16_t count = pdata[1];
+    if (length != 2 + count * MCAPI_REMOTE_SETPOINT_SIZE)
+    {
+        return MCAPI_REMOTE_ERR_LENGTH;
+    }
+    if (pschedule->running)
+    {
+        return MCAPI_REMOTE_ERR_STATE;
+    }
+    if ((count == 0) || (count > MCAPI_REMOTE_SCHEDULE_LENGTH))
+    {
+        return MCAPI_REMOTE_ERR_ARGUMENT;
+    }
+    
+    const uint8_t *p = pdata + 2;
+    uint16_t previousTime = 0;
+    for (uint16_t i = 0; i < count; ++i, p += MCAPI_REMOTE_SETPOINT_SIZE)
+    {
+        const uint16_t time = MCAPI_RemoteGetU16(p);
+        if (time < previousTime)
+        {
+            pschedule->count = 0;
+            return MCAPI_REMOTE_ERR_ARGUMENT;
+        }
+        previousTime = time;
+        pschedule->point[i].time = time;
+        pschedule->point[i].velocity = (int16_t)MCAPI_RemoteGetU16(p + 2);
+    }
+    pschedule->count = count;
+    pschedule->interpolate = (pdata[0] & MCAPI_REMOTE_LOAD_INTERPOLATE) != 0;
+    return MCAPI_REMOTE_OK;
+}
+
+/**
+ * Starts the loaded setpoint schedule.
+ * 
+ * @param premote remote protocol state
+ * @param flags see MCAPI_REMOTE_START_FLAGS
+ * @return status code
+ */
+static uint16_t MCAPI_RemoteScheduleStart(MCAPI_REMOTE_T *premote, uint16_t flags)
+{
+    MCAPI_REMOTE_SCHEDULE_T *pschedule = &premote->schedule;
+    if (pschedule->running)
+    {
+        return MCAPI_REMOTE_ERR_STATE;
+    }
+    if (pschedule->count == 0)
+    {
+        return MCAPI_REMOTE_ERR_ARGUMENT;
+    }
+    
+    volatile MCAPI_MOTOR_DATA *apiData = premote->apiData;
+    pschedule->index = 0;
+    pschedule->stopAtEnd = (flags & MCAPI_REMOTE_START_MOTOR_STOP) != 0;
+    pschedule->startTime = MCAPI_RemoteTimeGet(apiData);
+    pschedule->velocity = MCAPI_VelocityReferenceGet(apiData);
+    pschedule->running = true;
+    MCAPI_RemoteScheduleApply(premote, 0);
+    if (flags & MCAPI_REMOTE_START_MOTOR_START)
+    {
+        MCAPI_MotorStart(apiData);
+    }
+    return MCAPI_REMOTE_OK;
+}
+
+/**
+ * Fills in the response data of MCAPI_REMOTE_CMD_STATUS_GET.
+ * 
+ * @param premote remote protocol state
+ * @param p start of response data
+ * @return end of response data
+ */
+static uint8_t *MCAPI_RemoteStatusGet(MCAPI_REMOTE_T *premote, uint8_t *p)
+{
+    volatile MCAPI_MOTOR_DATA *apiData = premote->apiData;
+    MCAPI_STATUS_SNAPSHOT status;
+    MCAPI_StatusSnapshotGet(apiData, &status);
+    
+    uint8_t flags = 0;
+    if (status.rotorStopped)
+    {
+        flags |= MCAPI_REMOTE_STATUS_ROTOR_STOPPED;
+    }
+    if (premote->schedule.running)
+    {
+        flags |= MCAPI_REMOTE_STATUS_SCHEDULE_RUNNING;
+    }
+    
+    p = MCAPI_RemotePutU16(p, (uint16_t)status.timestamp);
+    p = MCAPI_RemotePutU16(p, (uint16_t)(status.timestamp >> 16));
+    *p++ = (uint8_t)status.motorStatus;
+    *p++ = flags;
+    p = MCAPI_RemotePutU16(p, status.faultFlags);
+    p = MCAPI_RemotePutU16(p, status.velocityMeasured);
+    p = MCAPI_RemotePutU16(p, MCAPI_VelocityReferenceGet(apiData));
+    p = MCAPI_RemotePutU16(p, status.iqFiltered);
+    p = MCAPI_RemotePutU16(p, status.dcLinkVoltage);
+    p = MCAPI_RemotePutU16(p, status.currentLimitIqUpper);
+    p = MCAPI_RemotePutU16(p, status.currentLimitIqLower);
+    *p++ = (uint8_t)premote->schedule.index;
+    return p;
+}
+
+/**
+ * Executes a received command and prepares its response for transmission.
+ * 
+ * @param premote remote protocol state
+ */
+static void MCAPI_RemoteExecute(MCAPI_REMOTE_T *premote)
+{
+    volatile MCAPI_MOTOR_DATA *apiData = premote->apiData;
+    const uint8_t command = premote->rxBody[0];
+    const uint8_t *pdata = &premote->rxBody[1];
+    const uint16_t length = premote->rxLength - 1;
+    
+    uint8_t *pframe = premote->txFrame;
+    uint8_t *p = &pframe[4];
+    uint16_t status = MCAPI_REMOTE_OK;
+    
+    switch (command)
+    {
+        case MCAPI_REMOTE_CMD_PING:
+            *p++ = MCAPI_REMOTE_VERSION;
+            break;
+            
+        case MCAPI_REMOTE_CMD_MOTOR_START:
+            MCAPI_MotorStart(apiData);
+            break;
+            
+        case MCAPI_REMOTE_CMD_MOTOR_STOP:
+            premote->schedule.running = false;
+            MCAPI_MotorStop(apiData);
+            break;
+            
+        case MCAPI_REMOTE_CMD_VELOCITY_SET:
+            if (length != 2)
+            {
+                status = MCAPI_REMOTE_ERR_LENGTH;
+            }
+            else if (premote->schedule.running)
+            {
+                status = MCAPI_REMOTE_ERR_STATE;
+            }
+            else
+            {
+                MCAPI_VelocityReferenceSet(apiData, (int16_t)MCAPI_RemoteGetU16(pdata));
+            }
+            break;
+            
+        case MCAPI_REMOTE_CMD_FAULT_CLEAR:
+            MCAPI_FaultStatusClear(apiData, MCAPI_FaultStatusGet(apiData));
+            break;
+            
+        case MCAPI_REMOTE_CMD_STATUS_GET:
+            p = MCAPI_RemoteStatusGet(premote, p);
+            break;
+            
+        case MCAPI_REMOTE_CMD_TELEMETRY_START:
+            if (premote->ptelemetryEnable == NULL)
+            {
+                status = MCAPI_REMOTE_ERR_COMMAND;
+            }
+            else
+            {
+                premote->telemetryStartPending = true;
+            }
+            break;
+            
+        case MCAPI_REMOTE_CMD_SCHEDULE_LOAD:
+            status = MCAPI_RemoteScheduleLoad(premote, pdata, length);
+            break;
+            
+        case MCAPI_REMOTE_CMD_SCHEDULE_START:
+            status = (length != 1)
+                   ? MCAPI_REMOTE_ERR_LENGTH
+                   : MCAPI_RemoteScheduleStart(premote, pdata[0]);
+            break;
+            
+        case MCAPI_REMOTE_CMD_SCHEDULE_ABORT:
+            premote->schedule.running = false;
+            break;
+            
+        default:
+            status = MCAPI_REMOTE_ERR_COMMAND;
+            break;
+    }
+    
+    /* Commands that fail return no data */
+    if (status != MCAPI_REMOTE_OK)
+    {
+        p = &pframe[4];
+    }
+    const uint16_t bodyLength = p - &pframe[2];
+    pframe[0] = MCAPI_REMOTE_SYNC;
+    pframe[1] = (uint8_t)bodyLength;
+    pframe[2] = command | 0x80;
+    pframe[3] = (uint8_t)status;
+    
+    uint16_t crc = 0xffff;
+    for (const uint8_t *q = &pframe[1]; q < p; ++q)
+    {
+        crc = UTIL_Crc16CcittUpdate(crc, *q);
+    }
+    p = MCAPI_RemotePutU16(p, crc);
+    
+    premote->txLength = p - pframe;
+    premote->txIndex = 0;
+}
+
+/**
+ * Processes one received byte.
+ * 
+ * @param premote remote protocol state
+ * @param data received byte
+ * @return true if a complete, valid command has been received
+ */
+static bool MCAPI_RemoteReceive(MCAPI_REMOTE_T *premote, uint8_t data)
+{
+    switch (premote->rxState)
+    {
+        case MCAPI_REMOTE_RX_SYNC:
+            if (data == MCAPI_REMOTE_SYNC)
+            {
+                premote->rxState = MCAPI_REMOTE_RX_LENGTH;
+            }
+            break;
+            
+        case MCAPI_REMOTE_RX_LENGTH:
+            if ((data == 0) || (data > MCAPI_REMOTE_BODY_MAX))
+            {
+                ++premote->framingErrors;
+                premote->rxState = MCAPI_REMOTE_RX_SYNC;
+            }
+            else
+            {
+                premote->rxLength = data;
+                premote->rxCount = 0;
+                premote->rxState = MCAPI_REMOTE_RX_BODY;
+            }
+            break;
+            
+        case MCAPI_REMOTE_RX_BODY:
+        {
+            premote->rxBody[premote->rxCount++] = data;
+            const uint16_t length = premote->rxLength;
+            if (premote->rxCount < length + 2)
+            {
+                break;
+            }
+            premote->rxState = MCAPI_REMOTE_RX_SYNC;
+            
+            uint16_t crc = UTIL_Crc16CcittUpdate(0xffff, (uint8_t)length);
+            for (uint16_t i = 0; i < length; ++i)
+            {
+                crc = UTIL_Crc16CcittUpdate(crc, premote->rxBody[i]);
+            }
+            if (crc != MCAPI_RemoteGetU16(&premote->rxBody[length]))
+            {
+                ++premote->crcErrors;
+                break;
+            }
+            return true;
+        }
+            
+        default:
+            premote->rxState = MCAPI_REMOTE_RX_SYNC;
+            break;
+    }
+    return false;
+}
+
+void MCAPI_RemoteCommunicate(MCAPI_REMOTE_T *premote)
+{
+    uint16_t txIndex = premote->txIndex;
+    while ((txIndex < premote->txLength) && MCAF_UartIsTxReady())
+    {
+        MCAF_UartWrite(premote->txFrame[txIndex++]);
+    }
+    premote->txIndex = txIndex;
+    if (txIndex < premote->txLength)
+    {
+        return;
+    }
+    if (premote->telemetryStartPending)
+    {
+        /* The UART belongs to the telemetry stream from now on,
+         * until the host sends MCAF_TELEMETRY_STOP_BYTE. */
+        premote->telemetryStartPending = false;
+        *premote->ptelemetryEnable = true;
+        return;
+    }
+    
+    const uint32_t now = MCAPI_RemoteTimeGet(premote->apiData);
+    if ((premote->rxState != MCAPI_REMOTE_RX_SYNC)
+        && (now - premote->rxTime > MCAPI_REMOTE_FRAME_TIMEOUT))
+    {
+        ++premote->framingErrors;
+        premote->rxState = MCAPI_REMOTE_RX_SYNC;
+    }
+    
+    while (MCAF_UartIsRxReady())
+    {
+        premote->rxTime = now;
+        if (MCAPI_RemoteReceive(premote, MCAF_UartRead()))
+        {
+            /* The response is sent on the next call; any further
+             * commands wait in the UART receive buffer until then. */
+            MCAPI_RemoteExecute(premote);
+            break;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * mcapi_remote.h
+ * 
+ * Binary command protocol that gives a remote host access to MCAPI
+ * over the diagnostics UART
+ * 
+ * Component: MCAPI
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __MCAPI_REMOTE_H
+#define __MCAPI_REMOTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mcapi_remote_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Frame format, in both directions:
+ * 
+ *   sync (MCAPI_REMOTE_SYNC)
+ *   body length N (1 to MCAPI_REMOTE_BODY_MAX)
+ *   body: N bytes
+ *   CRC-16-CCITT of length and body, initial value 0xFFFF, little-endian
+ * 
+ * A command body is the command code followed by its data.
+ * A response body is the command code with the high bit set, 
+ * a status code (see MCAPI_REMOTE_STATUS), and the response data.
+ * Multi-byte values are little-endian. Frames with a CRC error
+ * are discarded without a response; the host should retry after
+ * a timeout.
+ * 
+ * Command data:
+ *   VELOCITY_SET:   int16 velocity
+ *   SCHEDULE_LOAD:  uint8 flags (MCAPI_REMOTE_LOAD_FLAGS), uint8 count,
+ *                   count x (uint16 time in ms, int16 velocity),
+ *                   with times in nondecreasing order
+ *   SCHEDULE_START: uint8 flags (MCAPI_REMOTE_START_FLAGS)
+ * 
+ * TELEMETRY_START switches the UART to streaming telemetry (telemetry.h)
+ * once its response has been transmitted; the host switches it back by
+ * sending MCAF_TELEMETRY_STOP_BYTE. Without telemetry it fails with
+ * MCAPI_REMOTE_ERR_COMMAND.
+ * 
+ * Response data:
+ *   PING:           uint8 protocol version
+ *   STATUS_GET:     uint32 ISR count, uint8 motor status (MCAPI_MOTOR_STATE),
+ *                   uint8 flags (bit 0: rotor stopped, bit 1: schedule running),
+ *                   uint16 fault flags, int16 measured velocity, 
+ *                   int16 velocity reference, int16 filtered Iq,
+ *                   int16 DC link voltage, int16 Iq upper limit,
+ *                   int16 Iq lower limit, uint8 next schedule index
+ */
+
+/**
+ * Initializes the remote command protocol.
+ * 
+ * @param premote remote protocol state
+ * @param apiData motor controlled by the remote host
+ */
+void MCAPI_RemoteInit(MCAPI_REMOTE_T *premote, volatile MCAPI_MOTOR_DATA *apiData);
+
+/**
+ * Enables the TELEMETRY_START command.
+ * 
+ * @param premote remote protocol state
+ * @param penable streaming request flag of the telemetry module
+ */
+inline static void MCAPI_RemoteTelemetrySet(MCAPI_REMOTE_T *premote, volatile bool *penable)
+{
+    premote->ptelemetryEnable = penable;
+}
+
+/**
+ * Executes the setpoint schedule, if one is running.
+ * This runs independently of communication, so a schedule continues
+ * even while the UART is used for something else.
+ * 
+ * Executed in the main loop.
+ * 
+ * @param premote remote protocol state
+ */
+void MCAPI_RemoteScheduleStep(MCAPI_REMOTE_T *premote);
+
+/**
+ * Receives commands from the UART, executes them, and transmits responses.
+ * Never waits on the UART; a partially transmitted response is continued
+ * in the next call, and no new command is processed until it is complete.
+ * 
+ * Executed in the main loop.
+ * 
+ * @param premote remote protocol state
+ */
+void MCAPI_RemoteCommunicate(MCAPI_REMOTE_T *premote);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MCAPI_REMOTE_H */
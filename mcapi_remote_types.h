@@ -0,0 +1,181 @@
+/**
+ * mcapi_remote_types.h
+ * 
+ * Type definitions for the binary MCAPI remote command protocol
+ * 
+ * Component: MCAPI
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __MCAPI_REMOTE_TYPES_H
+#define __MCAPI_REMOTE_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mcapi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Frame sync byte, first byte of every command and response */
+#define MCAPI_REMOTE_SYNC 0xC5
+
+/** Protocol version, returned by MCAPI_REMOTE_CMD_PING */
+#define MCAPI_REMOTE_VERSION 1
+
+/** Maximum frame body length: command or response code, and data */
+#define MCAPI_REMOTE_BODY_MAX 132
+
+/** Maximum number of setpoints in a schedule */
+#define MCAPI_REMOTE_SCHEDULE_LENGTH 32
+
+/**
+ * Command codes; a response carries the command code with the high bit set
+ */
+typedef enum tagMCAPI_REMOTE_COMMAND
+{
+    MCAPI_REMOTE_CMD_PING           = 0x00,  /** no action, returns the protocol version */
+    MCAPI_REMOTE_CMD_MOTOR_START    = 0x01,  /** MCAPI_MotorStart() */
+    MCAPI_REMOTE_CMD_MOTOR_STOP     = 0x02,  /** MCAPI_MotorStop(), aborts a running schedule */
+    MCAPI_REMOTE_CMD_VELOCITY_SET   = 0x03,  /** MCAPI_VelocityReferenceSet(): int16 velocity */
+    MCAPI_REMOTE_CMD_FAULT_CLEAR    = 0x04,  /** MCAPI_FaultStatusClear() of all active faults */
+    MCAPI_REMOTE_CMD_STATUS_GET     = 0x05,  /** returns the status block */
+    MCAPI_REMOTE_CMD_TELEMETRY_START = 0x06, /** hands the UART over to streaming telemetry */
+    MCAPI_REMOTE_CMD_SCHEDULE_LOAD  = 0x10,  /** replaces the setpoint schedule */
+    MCAPI_REMOTE_CMD_SCHEDULE_START = 0x11,  /** starts executing the setpoint schedule */
+    MCAPI_REMOTE_CMD_SCHEDULE_ABORT = 0x12   /** stops executing the setpoint schedule */
+} MCAPI_REMOTE_COMMAND;
+
+/**
+ * Response status codes
+ */
+typedef enum tagMCAPI_REMOTE_STATUS
+{
+    MCAPI_REMOTE_OK               = 0,  /** command executed */
+    MCAPI_REMOTE_ERR_LENGTH       = 1,  /** wrong amount of data for the command */
+    MCAPI_REMOTE_ERR_COMMAND      = 2,  /** unknown command code */
+    MCAPI_REMOTE_ERR_STATE        = 3,  /** not allowed while a schedule is running */
+    MCAPI_REMOTE_ERR_ARGUMENT     = 4   /** data out of range */
+} MCAPI_REMOTE_STATUS;
+
+/**
+ * Options of MCAPI_REMOTE_CMD_SCHEDULE_LOAD
+ */
+typedef enum tagMCAPI_REMOTE_LOAD_FLAGS
+{
+    MCAPI_REMOTE_LOAD_INTERPOLATE  = 0x01   /** ramp linearly between setpoints */
+} MCAPI_REMOTE_LOAD_FLAGS;
+
+/**
+ * Options of MCAPI_REMOTE_CMD_SCHEDULE_START
+ */
+typedef enum tagMCAPI_REMOTE_START_FLAGS
+{
+    MCAPI_REMOTE_START_MOTOR_START = 0x01,  /** start the motor with the schedule */
+    MCAPI_REMOTE_START_MOTOR_STOP  = 0x02   /** stop the motor after the last setpoint */
+} MCAPI_REMOTE_START_FLAGS;
+
+/**
+ * Receiver state
+ */
+typedef enum tagMCAPI_REMOTE_RX_STATE
+{
+    MCAPI_REMOTE_RX_SYNC   = 0,  /** waiting for the sync byte */
+    MCAPI_REMOTE_RX_LENGTH = 1,  /** waiting for the body length */
+    MCAPI_REMOTE_RX_BODY   = 2   /** receiving body and CRC */
+} MCAPI_REMOTE_RX_STATE;
+
+/**
+ * One point of a setpoint schedule
+ */
+typedef struct tagMCAPI_REMOTE_SETPOINT
+{
+    uint16_t time;          /** time from start of schedule, in milliseconds */
+    int16_t velocity;       /** velocity reference, in MCAPI velocity units */
+} MCAPI_REMOTE_SETPOINT_T;
+
+/**
+ * Setpoint schedule, executed in the main loop
+ */
+typedef struct tagMCAPI_REMOTE_SCHEDULE
+{
+    MCAPI_REMOTE_SETPOINT_T point[MCAPI_REMOTE_SCHEDULE_LENGTH]; /** setpoints, in time order */
+    uint16_t count;         /** number of setpoints loaded */
+    bool interpolate;       /** ramp linearly between setpoints, rather than stepping */
+    bool running;           /** schedule is being executed */
+    bool stopAtEnd;         /** stop the motor after the last setpoint */
+    uint16_t index;         /** next setpoint to reach */
+    uint32_t startTime;     /** ISR count at the start of the schedule */
+    int16_t velocity;       /** velocity reference last applied */
+} MCAPI_REMOTE_SCHEDULE_T;
+
+/**
+ * State of the remote command protocol
+ */
+typedef struct tagMCAPI_REMOTE
+{
+    volatile MCAPI_MOTOR_DATA *apiData; /** motor controlled by the remote host */
+
+    /* receiver */
+    uint16_t rxState;       /** see MCAPI_REMOTE_RX_STATE */
+    uint16_t rxLength;      /** body length of the frame being received */
+    uint16_t rxCount;       /** number of body and CRC bytes received */
+    uint32_t rxTime;        /** ISR count when the last byte was received */
+    uint8_t rxBody[MCAPI_REMOTE_BODY_MAX + 2]; /** body and CRC of the frame being received */
+    uint16_t crcErrors;     /** number of frames discarded due to a CRC error */
+    uint16_t framingErrors; /** number of frames discarded due to bad length or timeout */
+
+    /* transmitter */
+    uint16_t txLength;      /** number of bytes in the response */
+    uint16_t txIndex;       /** next byte of the response to transmit */
+    uint8_t txFrame[MCAPI_REMOTE_BODY_MAX + 4]; /** response being transmitted */
+
+    MCAPI_REMOTE_SCHEDULE_T schedule; /** setpoint schedule */
+
+    volatile bool *ptelemetryEnable; /** streaming telemetry request, or NULL if not available */
+    bool telemetryStartPending;      /** request streaming once the response has been transmitted */
+} MCAPI_REMOTE_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MCAPI_REMOTE_TYPES_H */
@@ -51,6 +51,7 @@
 #include <stdbool.h>
 #include "units.h"
 #include "filter_types.h"
+#include "event_queue_types.h"
 
 
 #ifdef __cplusplus
@@ -65,9 +66,19 @@ typedef enum tagMCAPI_MOTOR_STATE
     MCAPI_MOTOR_RUNNING      = 3,  /** motor is running */
     MCAPI_MOTOR_STOPPING     = 4,  /** motor is stopping */
     MCAPI_MOTOR_FAULT        = 5,  /** fault detected */
-    MCAPI_MOTOR_DIAGSTATE    = 6   /** motor drive in diagnostic state */
+    MCAPI_MOTOR_DIAGSTATE    = 6,  /** motor drive in diagnostic state */
+    MCAPI_MOTOR_RUNNING_TORQUE = 7, /** motor is running under torque control */
+    MCAPI_MOTOR_RUNNING_POSITION = 8 /** motor is running under position control */
 } MCAPI_MOTOR_STATE;
 
+/** Control mode requested by the application */
+typedef enum tagMCAPI_CONTROL_MODE
+{
+    MCAPI_CONTROL_VELOCITY   = 0,  /** velocity reference drives the velocity loop */
+    MCAPI_CONTROL_TORQUE     = 1,  /** torque reference drives the q-axis current directly */
+    MCAPI_CONTROL_POSITION   = 2   /** position reference drives the velocity loop through a position loop */
+} MCAPI_CONTROL_MODE;
+
 /** Abstracted motor drive fault data */
 typedef enum tagMCAPI_FAULT_FLAGS
 {
@@ -81,6 +92,45 @@ typedef enum tagMCAPI_FAULT_FLAGS
                                                 * all other unspecified faults */
 } MCAPI_FAULT_FLAGS;
 
+/** 
+ * Consistent snapshot of motor status, published by MCAF once per ISR
+ * and read by the application with MCAPI_StatusSnapshotGet() 
+ */
+typedef struct tagMCAPI_STATUS_SNAPSHOT
+{
+    /** ISR count at which this snapshot was published */
+    uint32_t timestamp;
+    /** abstracted motor state */
+    MCAPI_MOTOR_STATE motorStatus;
+    /** bit field of individual faults */
+    uint16_t faultFlags;
+    /** velocity estimated in MCAF */
+    MCAF_U_VELOCITY_ELEC velocityMeasured;
+    /** low-pass filtered value of q-axis current */
+    int16_t iqFiltered;
+    /** low-pass filtered squared value of current magnitude */
+    int16_t isMagSquaredFiltered;
+    /** DC link voltage */
+    MCAF_U_VOLTAGE dcLinkVoltage;
+    /** q axis current upper limit used by the velocity control loop */
+    int16_t currentLimitIqUpper;
+    /** q axis current lower limit used by the velocity control loop */
+    int16_t currentLimitIqLower;
+    /** whether the rotor has been detected at standstill */
+    bool rotorStopped;
+} MCAPI_STATUS_SNAPSHOT;
+
+/** Open-loop startup settings that the application may change */
+typedef struct tagMCAPI_STARTUP_CONFIG
+{
+    /** amplitude of the current applied during startup */
+    MCAF_U_CURRENT current;
+    /** first and second open-loop acceleration, same scaling as STARTUP_ACCELERATIONx */
+    int16_t acceleration[2];
+    /** time after acceleration and before reference frame alignment, in ISR cycles */
+    uint32_t holdTime;
+} MCAPI_STARTUP_CONFIG;
+
 /** MCAPI motor data */
 typedef struct tagMCAPImotordata
 {
@@ -103,6 +153,20 @@ typedef struct tagMCAPImotordata
     MCAF_U_VELOCITY_ELEC velocityMinimum;
     /** maximum velocity command supported by MCAF */
     MCAF_U_VELOCITY_ELEC velocityMaximum;
+    /** control mode requested by the application */
+    MCAPI_CONTROL_MODE controlMode;
+    /** torque (q-axis current) reference set by the application */
+    int16_t torqueReference;
+    /** maximum change in torque reference applied per ISR */
+    int16_t torqueSlewRate;
+    /** velocity magnitude that the motor may not exceed in torque control */
+    MCAF_U_VELOCITY_ELEC torqueVelocityLimit;
+    /** position reference set by the application, in encoder counts */
+    int32_t positionReference;
+    /** velocity magnitude that the position loop may command */
+    MCAF_U_VELOCITY_ELEC positionVelocityLimit;
+    /** multi-turn position measured by the encoder, in encoder counts */
+    int32_t positionMeasured;
     /** low-pass filtered squared value of current magnitude measured in MCAF */
     int16_t isMagSquaredFiltered;
     /** low-pass filtered value of q-axis current measured in MCAF */
@@ -122,6 +186,18 @@ typedef struct tagMCAPImotordata
     MCAPI_MOTOR_STATE motorStatus;
     /** application-level fault code */
     uint16_t appFaultCode;
+    /** events posted by MCAF for the application */
+    MCAF_EVENT_QUEUE_T events;
+    /** sequence count for the status snapshot: odd while it is
+     * being written, incremented twice per update */
+    uint16_t statusSequence;
+    /** status snapshot, valid only when statusSequence is even and unchanged
+     * across the read */
+    MCAPI_STATUS_SNAPSHOT status;
+    /** flag used by MCAPI to request MCAF to apply startupConfig */
+    bool startupConfigRequest;
+    /** startup settings requested by the application */
+    MCAPI_STARTUP_CONFIG startupConfig;
 } MCAPI_MOTOR_DATA;
 
 /** MCAPI related data that is intended to be 
@@ -144,4 +220,4 @@ typedef struct tagMCAPI_FEEDBACK_SIGNALS
 }
 #endif
 
-#endif /* __MCAPI_TYPES_H */
\ No newline at end of file
+#endif /* __MCAPI_TYPES_H */
\ No newline at end of file
@@ -52,6 +52,9 @@
 #include "system_state.h"
 #include "util.h"
 #include "test_harness.h"
+#include "hal.h"
+#include "parameters/hal_params.h"
+#include "parameters/operating_params.h"
 
 void MCAF_MonitorSysDiagnose(MCAF_MOTOR_DATA *pmotor)
 {
@@ -72,6 +75,7 @@ void MCAF_MonitorSysDiagnose(MCAF_MOTOR_DATA *pmotor)
             if (maskedFlags != 0)
             {
                 MCAF_RecoverySetInputFlag(&pmotor->recovery, MCAF_RECOVERY_FSMI_STALL_DETECTED);
+                MCAF_EventPublish(pmotor, MCAF_EVENT_STALL_DETECT, maskedFlags);
             }
         }
     }
@@ -82,6 +86,79 @@ void MCAF_MonitorInit(MCAF_MONITOR_DATA_T *pmonitor)
 {
     /* initialize run as true */
     pmonitor->runPermitted = true;
+    MCAF_MonitorStopDetectReset(&pmonitor->stopDetect);
+}
+
+void MCAF_MonitorStopDetectReset(MCAF_STOP_DETECT_T *pdetect)
+{
+    MCAF_MonitorStopDetectCancelProbe(pdetect);
+    pdetect->quietCount = 0;
+    pdetect->peakCurrent = 0;
+    pdetect->stopped = false;
+}
+
+void MCAF_MonitorStopDetectCancelProbe(MCAF_STOP_DETECT_T *pdetect)
+{
+    pdetect->timer = MCAF_STOP_DETECT_PROBE_PERIOD;
+    pdetect->probeCount = 0;
+}
+
+void MCAF_MonitorStopDetectStep(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_STOP_DETECT_T *pdetect = &pmotor->monitor.stopDetect;
+    
+    if (pdetect->probeCount == 0)
+    {
+        /* Standstill is latched until the next reset: no more probes */
+        if (!pdetect->stopped && (--pdetect->timer == 0))
+        {
+            /* Zero vector: lower transistors on for the entire PWM period,
+             * starting with the next period. */
+            HAL_PWM_LowerTransistorsDutyCycle_SetInstance(pmotor->phal,
+                    HAL_PARAM_PWM_PERIOD_COUNTS, HAL_PARAM_PWM_PERIOD_COUNTS);
+            pdetect->probeCount = 1;
+            pdetect->peakCurrent = 0;
+        }
+    }
+    else
+    {
+        /* The current measured in this ISR was sampled during 
+         * the most recent PWM period, with the zero vector applied.
+         * |ialpha| + |ibeta| overestimates the magnitude by at most sqrt(2),
+         * which is acceptable for a threshold test.
+         */
+        const MCAF_U_CURRENT current = 
+            UTIL_SatAddS16(UTIL_Abs16(pmotor->ialphabeta.alpha),
+                           UTIL_Abs16(pmotor->ialphabeta.beta));
+        if (current > pdetect->peakCurrent)
+        {
+            pdetect->peakCurrent = current;
+        }
+        
+        /* End the probe as soon as back-emf current appears,
+         * to keep the braking current pulse short at high speed. */
+        const bool moving = (current > MCAF_STOP_DETECT_CURRENT_THRESHOLD);
+        if (moving || (pdetect->probeCount >= MCAF_STOP_DETECT_PROBE_DURATION))
+        {
+            HAL_PWM_LowerTransistorsDutyCycle_SetInstance(pmotor->phal,
+                    HAL_PARAM_PWM_PERIOD_COUNTS, HAL_PARAM_MIN_LOWER_DUTY_COUNTS);
+            MCAF_MonitorStopDetectCancelProbe(pdetect);
+            if (moving)
+            {
+                pdetect->quietCount = 0;
+                pdetect->stopped = false;
+            }
+            else if (pdetect->quietCount < MCAF_STOP_DETECT_CONFIRM_COUNT)
+            {
+                ++pdetect->quietCount;
+                pdetect->stopped = (pdetect->quietCount >= MCAF_STOP_DETECT_CONFIRM_COUNT);
+            }
+        }
+        else
+        {
+            ++pdetect->probeCount;
+        }
+    }
 }
 
 void MCAF_MonitorRecoveryAcknowledged(MCAF_MOTOR_DATA *pmotor)
@@ -86,20 +86,77 @@ static inline bool MCAF_MonitorIsRunPermitted(MCAF_MOTOR_DATA *pmotor)
 }
 
 /**
- * This function checks if motor achieved stopped state, or is it still recovering
+ * This function checks if the rotor has been detected at standstill
+ * by the zero-vector probes of MCAF_MonitorStopDetectStep()
  *
- * Summary : Check if stopped state was achieved, after recovery
+ * Summary : Check if the rotor is stopped
  *
  * @param pmotor This parameter is pointer to MCAF_MOTOR_DATA structure
  * @return true if the motor is stopped
  */
-static inline bool MCAF_MonitorIsMotorStopped(MCAF_MOTOR_DATA *pmotor)
+static inline bool MCAF_MonitorIsMotorStopped(const MCAF_MOTOR_DATA *pmotor)
 {
-    /* Placeholder -- at this time, we don't actually detect 
-     * whether the motor is stopped. */
-    return true;
+    return pmotor->monitor.stopDetect.stopped;
 }
 
+/**
+ * This function checks whether a standstill probe is in progress,
+ * with the lower transistors turned on
+ *
+ * Summary : Check if a rotor standstill probe is active
+ *
+ * @param pdetect This parameter is pointer to MCAF_STOP_DETECT_T structure
+ * @return true if a probe is active
+ */
+static inline bool MCAF_MonitorStopDetectIsProbing(const MCAF_STOP_DETECT_T *pdetect)
+{
+    return pdetect->probeCount != 0;
+}
+
+/**
+ * This function clears the standstill detection state; the rotor is
+ * considered to be moving until the probes show otherwise.
+ *
+ * Summary : Resets rotor standstill detection
+ *
+ * @param pdetect This parameter is pointer to MCAF_STOP_DETECT_T structure
+ */
+void MCAF_MonitorStopDetectReset(MCAF_STOP_DETECT_T *pdetect);
+
+/**
+ * This function cancels a probe in progress, for use when the PWM outputs
+ * have been reconfigured by the caller, but keeps the standstill detection
+ * result.
+ *
+ * Summary : Cancels a rotor standstill probe
+ *
+ * @param pdetect This parameter is pointer to MCAF_STOP_DETECT_T structure
+ */
+void MCAF_MonitorStopDetectCancelProbe(MCAF_STOP_DETECT_T *pdetect);
+
+/**
+ * This function detects whether the rotor is at standstill, while the
+ * PWM outputs are in the minimal-impact state used for coasting.
+ *
+ * Every MCAF_STOP_DETECT_PROBE_PERIOD ISR cycles, all lower transistors
+ * are turned on for up to MCAF_STOP_DETECT_PROBE_DURATION cycles,
+ * shorting the motor terminals. Any back-emf then drives a current
+ * through the shunt resistors; if that current exceeds
+ * MCAF_STOP_DETECT_CURRENT_THRESHOLD, the probe ends immediately
+ * and the rotor is considered to be moving. The rotor is considered to be
+ * stopped after MCAF_STOP_DETECT_CONFIRM_COUNT consecutive quiet probes;
+ * this result is latched, and no further probes are made until
+ * MCAF_MonitorStopDetectReset() is called.
+ *
+ * This must be called once per ISR, after the current has been measured,
+ * and only in states where the PWM outputs are not otherwise in use.
+ *
+ * Summary : Probes for back-emf to detect rotor standstill
+ *
+ * @param pmotor This parameter is pointer to MCAF_MOTOR_DATA structure
+ */
+void MCAF_MonitorStopDetectStep(MCAF_MOTOR_DATA *pmotor);
+
 /**
  * This function inits the monitor function
  *
@@ -132,7 +189,12 @@ void MCAF_MonitorSysDiagnose(MCAF_MOTOR_DATA *pmotor);
  */
 static inline void MCAF_MonitorStepIsr(MCAF_MOTOR_DATA *pmotor)
 {
+    const MCAF_RECOVERY_FSM_STATE previousState = pmotor->recovery.stateMachine.state;
     MCAF_Recovery(&pmotor->recovery);
+    if (pmotor->recovery.stateMachine.state != previousState)
+    {
+        MCAF_EventPublish(pmotor, MCAF_EVENT_RECOVERY, pmotor->recovery.stateMachine.state);
+    }
 }
 
 /**
@@ -48,16 +48,33 @@
 #ifndef MONITOR_TYPES_H
 #define MONITOR_TYPES_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "units.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Rotor standstill detection state
+ */
+typedef struct tagMCAF_STOP_DETECT
+{
+    uint16_t timer;            /** ISR cycles remaining until the next probe */
+    uint16_t probeCount;       /** ISR cycles since the probe started, or 0 if no probe is active */
+    uint16_t quietCount;       /** number of consecutive probes without back-emf current */
+    MCAF_U_CURRENT peakCurrent; /** largest current seen during the most recent probe */
+    bool stopped;              /** whether the rotor has been detected at standstill */
+} MCAF_STOP_DETECT_T;
+
 /**
  * System monitor states
  */    
 typedef struct tagMCAF_MONITOR_DATA
 {
     bool runPermitted;   /** run permitted global */
+    MCAF_STOP_DETECT_T stopDetect; /** rotor standstill detection */
 } MCAF_MONITOR_DATA_T;
   
 
@@ -0,0 +1,228 @@
+/**
+ * param_adapt.h
+ *
+ * Online adaptation of stator resistance and back-emf constant
+ * 
+ * Component: FOC
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __PARAM_ADAPT_H
+#define __PARAM_ADAPT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "units.h"
+#include "util.h"
+#include "filter.h"
+#include "foc_types.h"
+#include "param_adapt_types.h"
+#include "parameters/foc_params.h"
+#include "parameters/motor_params.h"
+#include "parameters/options.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize Rs/Ke adaptation state
+ * @param padapt adaptation state
+ */
+inline static void MCAF_ParamAdaptInit(MCAF_PARAM_ADAPT_T *padapt)
+{
+    MCAF_FilterLowPassS16Init(&padapt->idFiltered, MCAF_PARAM_ADAPT_FILTER_COEFF);
+    MCAF_FilterLowPassS16Init(&padapt->iqFiltered, MCAF_PARAM_ADAPT_FILTER_COEFF);
+    MCAF_FilterLowPassS16Init(&padapt->vdFiltered, MCAF_PARAM_ADAPT_FILTER_COEFF);
+    MCAF_FilterLowPassS16Init(&padapt->vqFiltered, MCAF_PARAM_ADAPT_FILTER_COEFF);
+    MCAF_FilterLowPassS16Init(&padapt->omegaFiltered, MCAF_PARAM_ADAPT_FILTER_COEFF);
+    padapt->rsMeasured = MCAF_MOTOR_RS;
+    padapt->keMeasured = MCAF_MOTOR_KE;
+    padapt->idInjection = MCAF_PARAM_ADAPT_ID_INJECTION;
+    padapt->keSlewCount = 0;
+    padapt->enable = MCAF_ParamAdaptationEnabled();
+    padapt->steadyState = false;
+}
+
+/**
+ * Get the d-axis current to add to the d-axis current command,
+ * so that Rs is observable from the d-axis voltage equation
+ *
+ * @param padapt adaptation state
+ * @return d-axis current injection
+ */
+inline static MCAF_U_CURRENT MCAF_ParamAdaptGetIdInjection(const MCAF_PARAM_ADAPT_T *padapt)
+{
+    return (MCAF_ParamAdaptationEnabled() && padapt->enable) ? padapt->idInjection : 0;
+}
+
+/**
+ * Reduce a q-axis current limit so that the current vector, including
+ * the d-axis current injection, stays within the original limit.
+ *
+ * Uses sqrt(limit^2 - id^2) >= limit - id^2/limit,
+ * which needs no square root and never exceeds the limit.
+ *
+ * @param padapt adaptation state
+ * @param iLimit current limit
+ * @return q-axis current limit
+ */
+inline static MCAF_U_CURRENT MCAF_ParamAdaptGetIqLimit(const MCAF_PARAM_ADAPT_T *padapt,
+                                                       MCAF_U_CURRENT iLimit)
+{
+    const int16_t idInjection = UTIL_Abs16(MCAF_ParamAdaptGetIdInjection(padapt));
+    if (idInjection >= iLimit)
+    {
+        return 0;
+    }
+    return iLimit - (int16_t)(UTIL_mulss(idInjection, idInjection) / iLimit);
+}
+
+/**
+ * Low-pass filter the signals used for adaptation.
+ * Executed every control cycle.
+ *
+ * @param padapt adaptation state
+ * @param pidq dq-axis current
+ * @param pvdq dq-axis voltage
+ * @param omega electrical velocity
+ */
+inline static void MCAF_ParamAdaptFilterStep(MCAF_PARAM_ADAPT_T *padapt,
+                                             const MCAF_U_CURRENT_DQ *pidq,
+                                             const MCAF_U_VOLTAGE_DQ *pvdq,
+                                             MCAF_U_VELOCITY_ELEC omega)
+{
+    MCAF_FilterLowPassS16Update(&padapt->idFiltered, pidq->d);
+    MCAF_FilterLowPassS16Update(&padapt->iqFiltered, pidq->q);
+    MCAF_FilterLowPassS16Update(&padapt->vdFiltered, pvdq->d);
+    MCAF_FilterLowPassS16Update(&padapt->vqFiltered, pvdq->q);
+    MCAF_FilterLowPassS16Update(&padapt->omegaFiltered, omega);
+}
+
+/**
+ * Update Rs and Ke from the steady-state rotor-frame voltage equations
+ *
+ *   vd = Rs*id - omega*Lq*iq
+ *   vq = Rs*iq + omega*Ld*id + omega*Ke
+ *
+ * using the filtered signals. The voltages are the commanded ones, so the
+ * inverter deadtime error, which at the injected current is larger than
+ * Rs*id, is removed from vd before Rs is computed.
+ * Each parameter moves towards its measurement
+ * at a limited rate and stays within plausibility bounds; Ke moves
+ * only once per MCAF_PARAM_ADAPT_KE_SLEW_PERIOD updates, so that it
+ * follows the magnet temperature but not load transients. keInverse
+ * follows Ke so that the ATPLL uses the adapted value.
+ *
+ * Executed at the subsampled rate (MCAF_ISR_SUBSAMPLE_DIVIDER),
+ * only while the motor is running.
+ *
+ * @param padapt adaptation state
+ * @param omega electrical velocity
+ * @param vDC DC link voltage
+ * @param pparam motor parameters
+ */
+inline static void MCAF_ParamAdaptUpdate(MCAF_PARAM_ADAPT_T *padapt,
+                                         MCAF_U_VELOCITY_ELEC omega,
+                                         MCAF_U_VOLTAGE vDC,
+                                         MCAF_MOTOR_PARAMETERS_T *pparam)
+{
+    const int16_t omegaFiltered = MCAF_FilterLowPassS16Output(&padapt->omegaFiltered);
+    const int16_t id = MCAF_FilterLowPassS16Output(&padapt->idFiltered);
+    const int16_t iq = MCAF_FilterLowPassS16Output(&padapt->iqFiltered);
+    const int16_t vd = MCAF_FilterLowPassS16Output(&padapt->vdFiltered);
+    const int16_t vq = MCAF_FilterLowPassS16Output(&padapt->vqFiltered);
+
+    /* The voltage equations hold only without acceleration,
+     * and Ke needs a back-emf that is large enough to measure.
+     */
+    padapt->steadyState = padapt->enable
+        && !UTIL_AbsLessThan(omegaFiltered, MCAF_PARAM_ADAPT_VELOCITY_MIN)
+        && UTIL_AbsLessThan(UTIL_SatSubS16(omega, omegaFiltered), MCAF_PARAM_ADAPT_VELOCITY_RIPPLE);
+    if (!padapt->steadyState)
+    {
+        return;
+    }
+
+    if (!UTIL_AbsLessThan(id, MCAF_PARAM_ADAPT_ID_MIN))
+    {
+        /* Deadtime subtracts about vDeadtime*i/|i| from the commanded voltage
+         * vector; |i| is approximated by max + min/2 (within +12%).
+         */
+        const int16_t idAbs = UTIL_Abs16(id);
+        const int16_t iqAbs = UTIL_Abs16(iq);
+        const int16_t iMagnitude = (idAbs > iqAbs)
+            ? UTIL_SatAddS16(idAbs, iqAbs >> 1)
+            : UTIL_SatAddS16(iqAbs, idAbs >> 1);
+        const int16_t vDeadtime = UTIL_MulQ15(MCAF_PARAM_ADAPT_DEADTIME_GAIN, vDC);
+        const int16_t vdDeadtime = (int16_t)(((int32_t)vDeadtime * id) / iMagnitude);
+        const int16_t vdResistive = UTIL_SatAddS16(UTIL_SatSubS16(vd, vdDeadtime),
+            UTIL_MulQ15(pparam->lqBaseOmegaE, UTIL_MulQ15(omegaFiltered, iq)));
+        const int32_t rsMeasured = ((int32_t)vdResistive << MCAF_MOTOR_RS_Q) / id;
+        padapt->rsMeasured = UTIL_LimitS16(UTIL_LimitS32ToS16(rsMeasured, INT16_MAX),
+                                           MCAF_PARAM_ADAPT_RS_MIN, MCAF_PARAM_ADAPT_RS_MAX);
+        pparam->rs = UTIL_LimitSlewRateSymmetrical(padapt->rsMeasured, pparam->rs,
+                                                   MCAF_PARAM_ADAPT_RS_SLEW);
+    }
+
+    const int16_t vqBackEmf = UTIL_SatSubS16(UTIL_SatSubS16(vq, UTIL_MulQ15(pparam->rs, iq)),
+        UTIL_MulQ15(pparam->ldBaseOmegaE, UTIL_MulQ15(omegaFiltered, id)));
+    const int32_t keMeasured = ((int32_t)vqBackEmf << MCAF_MOTOR_KE_Q) / omegaFiltered;
+    padapt->keMeasured = UTIL_LimitS16(UTIL_LimitS32ToS16(keMeasured, INT16_MAX),
+                                       MCAF_PARAM_ADAPT_KE_MIN, MCAF_PARAM_ADAPT_KE_MAX);
+    if (++padapt->keSlewCount < MCAF_PARAM_ADAPT_KE_SLEW_PERIOD)
+    {
+        return;
+    }
+    padapt->keSlewCount = 0;
+    const MCAF_U_BACKEMF ke = UTIL_LimitSlewRateSymmetrical(padapt->keMeasured, pparam->ke,
+                                                            MCAF_PARAM_ADAPT_KE_SLEW);
+    if (ke != pparam->ke)
+    {
+        pparam->ke = ke;
+        pparam->keInverse = (int16_t)(((int32_t)1 << (MCAF_MOTOR_KE_Q + MCAF_MOTOR_KE_INVERSE_Q)) / ke);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_ADAPT_H */
@@ -0,0 +1,82 @@
+/**
+ * param_adapt_types.h
+ * 
+ * This module holds typedef structures used in param_adapt.h
+ * 
+ * Component: FOC
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __PARAM_ADAPT_TYPES_H
+#define __PARAM_ADAPT_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "units.h"
+#include "filter_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * State variables for online adaptation of Rs and Ke
+ */
+typedef struct tagMCAF_PARAM_ADAPT
+{
+    MCAF_FILTER_LOW_PASS_S16_T idFiltered;     /** filtered d-axis current */
+    MCAF_FILTER_LOW_PASS_S16_T iqFiltered;     /** filtered q-axis current */
+    MCAF_FILTER_LOW_PASS_S16_T vdFiltered;     /** filtered d-axis voltage */
+    MCAF_FILTER_LOW_PASS_S16_T vqFiltered;     /** filtered q-axis voltage */
+    MCAF_FILTER_LOW_PASS_S16_T omegaFiltered;  /** filtered electrical velocity */
+
+    MCAF_U_STATOR_RESISTANCE rsMeasured;   /** most recent Rs measurement, before rate limiting */
+    MCAF_U_BACKEMF           keMeasured;   /** most recent Ke measurement, before rate limiting */
+    MCAF_U_CURRENT           idInjection;  /** d-axis current injected while enabled */
+    uint16_t                 keSlewCount;  /** updates since the last Ke slew step */
+    bool                     enable;       /** enables adaptation, may be cleared at runtime */
+    bool                     steadyState;  /** whether steady-state conditions were met on the last update */
+} MCAF_PARAM_ADAPT_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_ADAPT_TYPES_H */
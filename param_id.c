@@ -0,0 +1,867 @@
+/**
+ * param_id.c
+ *
+ * On-target identification of motor parameters (Rs, Ld, Lq, Ke)
+ * and locked-rotor current-loop autotuning
+ * 
+ * Component: test harness
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "param_id.h"
+#include "system_state.h"
+#include "state_machine_types.h"
+#include "test_harness.h"
+#include "parameters/motor_params.h"
+#include "parameters/timing_params.h"
+#include "parameters/foc_params.h"
+#include "parameters/operating_params.h"
+#include "parameters/options.h"
+
+#if MCAF_INCLUDE_PARAM_ID
+
+#ifndef MCAF_TEST_HARNESS
+#error "Parameter identification uses the test harness perturbation; define MCAF_TEST_HARNESS"
+#endif
+
+/*
+ * The estimator works with the stator voltage equations in the rotor frame,
+ * using per-unit voltage, current and velocity (Q15 values / 32768):
+ *
+ *   vd = Rs*id + (Ld/dt)*delta(id) - omega*Lq*iq
+ *   vq = Rs*iq + (Lq/dt)*delta(iq) + omega*Ld*id + omega*Ke
+ *
+ * with unknowns theta = [Rs, Ld/dt, Lq/dt, Ke]. Both equations are fed to
+ * the same estimator as separate scalar measurements, so that the
+ * cross-coupling terms help to identify Ld and Lq.
+ *
+ * The inductance terms are estimated in the scaling of MCAF_MOTOR_Lx_BASE_DT;
+ * the omega*L terms use the scaling of MCAF_MOTOR_Lx_BASE_OMEGA_E, which differs
+ * from it by the constant factor below.
+ *
+ * The velocity-loop test uses the same estimator with the mechanical
+ * equation, evaluated over windows of MCAF_PARAMID_VELOCITY_WINDOW samples:
+ *
+ *   delta(omega) = a*iq - b*omega - c*sign(omega)
+ *
+ * with theta = [a, b, c, 0]; see processVelocitySample().
+ */
+enum
+{
+    PARAMID_RS = 0,
+    PARAMID_LD = 1,
+    PARAMID_LQ = 2,
+    PARAMID_KE = 3
+};
+
+/** per-unit scaling of Q15 voltage, current and velocity */
+#define PARAMID_Q15_SCALE      32768.0f
+/** per-unit scaling of L*I/dt inductance values */
+#define PARAMID_L_BASE_DT_SCALE  ((float)(1 << MCAF_MOTOR_LQ_BASE_DT_Q))
+/** per-unit scaling of back-emf constant */
+#define PARAMID_KE_SCALE       ((float)(1 << MCAF_MOTOR_KE_Q))
+
+/** Ratio of per-unit omega*L scaling to per-unit L/dt scaling */
+#define PARAMID_L_OMEGA_E_PER_DT  ((float)MCAF_MOTOR_LQ_BASE_OMEGA_E / MCAF_MOTOR_LQ_BASE_DT \
+                                   * PARAMID_L_BASE_DT_SCALE / PARAMID_Q15_SCALE)
+
+/** Slots of the parameter vector used by the velocity-loop test */
+enum
+{
+    PARAMID_ACCEL   = 0,
+    PARAMID_VISCOUS = 1,
+    PARAMID_COULOMB = 2
+};
+
+/** Duration of one velocity-loop test window, in seconds */
+#define PARAMID_VELOCITY_WINDOW_TIME  (MCAF_PARAMID_VELOCITY_WINDOW * MCAF_PARAMID_DECIMATION \
+                                       * LOOPTIMEINSEC)
+
+/** pi/2 */
+#define PARAMID_HALF_PI  1.5707963f
+
+/** Maximum number of queued samples processed per main loop pass */
+#define PARAMID_SAMPLES_PER_STEP  4
+
+void MCAF_ParamIdInit(MCAF_PARAMID_T *pid)
+{
+    pid->command = MCAF_PARAMID_CMD_NONE;
+    pid->state = MCAF_PARAMID_IDLE;
+    pid->error = MCAF_PARAMID_ERR_NONE;
+    pid->mode = MCAF_PARAMID_MODE_MOTOR;
+    pid->capturing = false;
+    pid->applyFlags = 0;
+    pid->head = 0;
+    pid->tail = 0;
+    pid->overruns = 0;
+    pid->idqPrev.d = 0;
+    pid->idqPrev.q = 0;
+    pid->decimationCount = 0;
+    pid->sampleCount = 0;
+    pid->currentLoopBandwidth = MCAF_PARAMID_CURRENT_LOOP_BANDWIDTH;
+    pid->currentLoopPhaseMargin = MCAF_PARAMID_CURRENT_LOOP_PHASE_MARGIN;
+    pid->velocityLoopBandwidth = MCAF_PARAMID_VELOCITY_LOOP_BANDWIDTH;
+    pid->velocityLoopPhaseMargin = MCAF_PARAMID_VELOCITY_LOOP_PHASE_MARGIN;
+}
+
+/**
+ * Resets the estimator covariance
+ *
+ * @param prls estimator state
+ * @param p0 initial value of the diagonal
+ */
+static void rlsResetCovariance(MCAF_PARAMID_RLS_T *prls, float p0)
+{
+    int i, j;
+    for (i = 0; i < MCAF_PARAMID_PARAM_COUNT; ++i)
+    {
+        for (j = 0; j < MCAF_PARAMID_PARAM_COUNT; ++j)
+        {
+            prls->p[i][j] = (i == j) ? p0 : 0.0f;
+        }
+    }
+}
+
+/**
+ * Resets the estimator, starting from the present motor parameters
+ *
+ * @param prls estimator state
+ * @param pparam motor parameters
+ */
+static void rlsReset(MCAF_PARAMID_RLS_T *prls, const volatile MCAF_MOTOR_PARAMETERS_T *pparam)
+{
+    prls->theta[PARAMID_RS] = pparam->rs / PARAMID_Q15_SCALE;
+    prls->theta[PARAMID_LD] = pparam->ldBaseDt / PARAMID_L_BASE_DT_SCALE;
+    prls->theta[PARAMID_LQ] = pparam->lqBaseDt / PARAMID_L_BASE_DT_SCALE;
+    prls->theta[PARAMID_KE] = pparam->ke / PARAMID_KE_SCALE;
+    rlsResetCovariance(prls, MCAF_PARAMID_INITIAL_COVARIANCE);
+}
+
+/**
+ * Updates the estimator with one scalar measurement y = phi' * theta
+ *
+ * @param prls estimator state
+ * @param phi regressor
+ * @param y measurement
+ */
+static void rlsUpdate(MCAF_PARAMID_RLS_T *prls, const float *phi, float y)
+{
+    float pphi[MCAF_PARAMID_PARAM_COUNT];
+    float denominator = MCAF_PARAMID_FORGETTING_FACTOR;
+    float error = y;
+    int i, j;
+
+    for (i = 0; i < MCAF_PARAMID_PARAM_COUNT; ++i)
+    {
+        float sum = 0.0f;
+        for (j = 0; j < MCAF_PARAMID_PARAM_COUNT; ++j)
+        {
+            sum += prls->p[i][j] * phi[j];
+        }
+        pphi[i] = sum;
+        denominator += phi[i] * sum;
+        error -= phi[i] * prls->theta[i];
+    }
+
+    const float gainScale = 1.0f / denominator;
+    const float lambdaInverse = 1.0f / MCAF_PARAMID_FORGETTING_FACTOR;
+    for (i = 0; i < MCAF_PARAMID_PARAM_COUNT; ++i)
+    {
+        const float gain = pphi[i] * gainScale;
+        prls->theta[i] += gain * error;
+        /* P is symmetric, so P*phi*phi'*P = pphi*pphi' */
+        for (j = 0; j < MCAF_PARAMID_PARAM_COUNT; ++j)
+        {
+            prls->p[i][j] = (prls->p[i][j] - gain * pphi[j]) * lambdaInverse;
+        }
+    }
+}
+
+/**
+ * Feeds one captured sample to the estimator
+ *
+ * With a locked rotor, only the d-axis equation carries information.
+ *
+ * @param prls estimator state
+ * @param psample captured sample
+ * @param lockedRotor whether the rotor is locked
+ */
+static void processSample(MCAF_PARAMID_RLS_T *prls, const MCAF_PARAMID_SAMPLE_T *psample,
+                          bool lockedRotor)
+{
+    const float id = psample->idq.d / PARAMID_Q15_SCALE;
+    const float iq = psample->idq.q / PARAMID_Q15_SCALE;
+    const float omega = lockedRotor ? 0.0f : psample->omega / PARAMID_Q15_SCALE;
+    const float omegaL = omega * PARAMID_L_OMEGA_E_PER_DT;
+    float phi[MCAF_PARAMID_PARAM_COUNT];
+
+    /* d-axis equation */
+    phi[PARAMID_RS] = id;
+    phi[PARAMID_LD] = psample->didq.d / PARAMID_Q15_SCALE;
+    phi[PARAMID_LQ] = -omegaL * iq;
+    phi[PARAMID_KE] = 0.0f;
+    rlsUpdate(prls, phi, psample->vdq.d / PARAMID_Q15_SCALE);
+    if (lockedRotor)
+    {
+        return;
+    }
+
+    /* q-axis equation */
+    phi[PARAMID_RS] = iq;
+    phi[PARAMID_LD] = omegaL * id;
+    phi[PARAMID_LQ] = psample->didq.q / PARAMID_Q15_SCALE;
+    phi[PARAMID_KE] = omega;
+    rlsUpdate(prls, phi, psample->vdq.q / PARAMID_Q15_SCALE);
+}
+
+/**
+ * Converts a per-unit estimate to a fixed-point parameter
+ *
+ * @param x estimate
+ * @param scale scaling of the fixed-point parameter
+ * @param pvalue fixed-point parameter, limited to the positive int16_t range
+ * @return whether the estimate is in range; if not, the limited value
+ *         must not be used as a parameter
+ */
+static bool toFixedPoint(float x, float scale, int16_t *pvalue)
+{
+    const float y = x * scale + 0.5f;
+    if (y >= (float)INT16_MAX + 1.0f)
+    {
+        *pvalue = INT16_MAX;
+        return false;
+    }
+    else if (y < 0.0f)
+    {
+        *pvalue = 0;
+        return false;
+    }
+    *pvalue = (int16_t)y;
+    return true;
+}
+
+/**
+ * Checks an estimate against its nominal value
+ *
+ * @param estimate estimated fixed-point value
+ * @param nominal nominal fixed-point value from motor_params.h
+ * @return whether the estimate is plausible
+ */
+static bool withinBounds(int16_t estimate, int16_t nominal)
+{
+    return (estimate >= MCAF_PARAMID_BOUND_RATIO_MIN * nominal)
+        && (estimate <= MCAF_PARAMID_BOUND_RATIO_MAX * nominal);
+}
+
+/**
+ * Computes the motor parameters from the estimate
+ *
+ * @param prls estimator state
+ * @param presult motor parameters
+ * @return whether all parameters are plausible
+ */
+static bool computeResult(const MCAF_PARAMID_RLS_T *prls, MCAF_MOTOR_PARAMETERS_T *presult)
+{
+    /* A saturated value would pass the bounds check whenever the upper
+     * bound is beyond the int16_t range, so saturation is a failure too.
+     */
+    const float lOmegaScale = PARAMID_L_OMEGA_E_PER_DT * PARAMID_Q15_SCALE;
+    int16_t rs, ld, lq, ke, ldOmega, lqOmega, keInverse;
+    if (!toFixedPoint(prls->theta[PARAMID_RS], PARAMID_Q15_SCALE, &rs)
+     || !toFixedPoint(prls->theta[PARAMID_LD], PARAMID_L_BASE_DT_SCALE, &ld)
+     || !toFixedPoint(prls->theta[PARAMID_LQ], PARAMID_L_BASE_DT_SCALE, &lq)
+     || !toFixedPoint(prls->theta[PARAMID_KE], PARAMID_KE_SCALE, &ke)
+     || !toFixedPoint(prls->theta[PARAMID_LD], lOmegaScale, &ldOmega)
+     || !toFixedPoint(prls->theta[PARAMID_LQ], lOmegaScale, &lqOmega)
+     || !toFixedPoint(1.0f / prls->theta[PARAMID_KE],
+                      ldexpf(1.0f, MCAF_MOTOR_KE_INVERSE_Q), &keInverse))
+    {
+        return false;
+    }
+    if (!withinBounds(rs, MCAF_MOTOR_RS)
+     || !withinBounds(ld, MCAF_MOTOR_LD_BASE_DT)
+     || !withinBounds(lq, MCAF_MOTOR_LQ_BASE_DT)
+     || !withinBounds(ke, MCAF_MOTOR_KE))
+    {
+        return false;
+    }
+
+    presult->rs = rs;
+    presult->ldBaseDt = ld;
+    presult->lqBaseDt = lq;
+    presult->l0BaseDt = (ld + lq) >> 1;
+    presult->l1BaseDt = (ld - lq) >> 1;
+    presult->ldBaseOmegaE = ldOmega;
+    presult->lqBaseOmegaE = lqOmega;
+    presult->l0BaseOmegaE = (ldOmega + lqOmega) >> 1;
+    presult->l1BaseOmegaE = (ldOmega - lqOmega) >> 1;
+    presult->ke = ke;
+    presult->keInverse = keInverse;
+    return true;
+}
+
+/**
+ * Converts per-unit PI gains to fixed-point gains, choosing the
+ * smallest normalizing shifts that keep each gain in range
+ *
+ * @param kp proportional gain, per-unit
+ * @param ki integral gain per control step, per-unit
+ * @param pgains fixed-point gains
+ * @return whether the gains are representable
+ */
+static bool toPiGains(float kp, float ki, MCAF_PARAMID_PI_GAINS_T *pgains)
+{
+    /* The shift count is checked first and the scale is built with ldexpf,
+     * since 1 << 15 overflows a 16-bit int.
+     */
+    int16_t nkp = 0;
+    while ((nkp < 15) && (kp * ldexpf(PARAMID_Q15_SCALE, -nkp) >= (float)INT16_MAX))
+    {
+        ++nkp;
+    }
+    int16_t nki = 0;
+    while ((nki < 15) && (ki * ldexpf(PARAMID_Q15_SCALE, -nki) >= (float)INT16_MAX))
+    {
+        ++nki;
+    }
+    int16_t kpFixed, kiFixed;
+    const bool kpInRange = toFixedPoint(kp, ldexpf(PARAMID_Q15_SCALE, -nkp), &kpFixed);
+    const bool kiInRange = toFixedPoint(ki, ldexpf(PARAMID_Q15_SCALE, -nki), &kiFixed);
+    pgains->kp = kpFixed;
+    pgains->ki = kiFixed;
+    pgains->nkp = nkp;
+    pgains->nki = nki;
+    return kpInRange && kiInRange && (kpFixed > 0) && (nkp < 15) && (nki < 15);
+}
+
+/**
+ * Computes PI gains for a current loop with plant 1/(R + sL) and
+ * a loop delay Td, for crossover frequency wc and phase margin PM.
+ *
+ * With C(s) = Kp*(1 + wz/s), the phase margin is
+ *   PM = 90deg + atan(wc/wz) - atan(wc*L/R) - wc*Td
+ * which sets the zero wz; Kp then sets unity loop gain at wc.
+ *
+ * @param r resistance, per-unit
+ * @param lBaseDt inductance, per-unit L/dt
+ * @param wc crossover frequency, rad/s
+ * @param phaseMargin phase margin, rad
+ * @param pgains computed gains
+ * @return whether the gains are achievable and representable
+ */
+static bool computeCurrentLoopGains(float r, float lBaseDt, float wc, float phaseMargin,
+                                    MCAF_PARAMID_PI_GAINS_T *pgains)
+{
+    const float ts = LOOPTIMEINSEC;
+    const float x = wc * ts * lBaseDt;          /* reactance at wc, per-unit */
+    const float zeroAngle = phaseMargin - PARAMID_HALF_PI + atan2f(x, r)
+                          + wc * ts * MCAF_PARAMID_CURRENT_LOOP_DELAY;
+    if (zeroAngle <= 0.0f)
+    {
+        return false;
+    }
+    /* a zero angle of 90 degrees or more means a pure P controller suffices */
+    const float wz = (zeroAngle < PARAMID_HALF_PI) ? wc / tanf(zeroAngle) : 0.0f;
+    const float kp = wc * sqrtf(r*r + x*x) / sqrtf(wc*wc + wz*wz);
+    const float ki = kp * wz * ts;
+    return toPiGains(kp, ki, pgains);
+}
+
+/**
+ * Computes the current controller gains from the locked-rotor estimate.
+ *
+ * Only Ld is observable with the rotor aligned to the d-axis;
+ * the q-axis inductance is scaled by the saliency in the present
+ * motor parameters.
+ *
+ * @param pid identification state
+ * @param prls estimator state
+ * @param pparam motor parameters
+ * @return error code
+ */
+static MCAF_PARAMID_ERROR computeCurrentLoopResult(volatile MCAF_PARAMID_T *pid,
+                                                   const MCAF_PARAMID_RLS_T *prls,
+                                                   const volatile MCAF_MOTOR_PARAMETERS_T *pparam)
+{
+    const float r = prls->theta[PARAMID_RS];
+    const float ld = prls->theta[PARAMID_LD];
+    int16_t rFixed, ldFixed;
+    if (!toFixedPoint(r, PARAMID_Q15_SCALE, &rFixed)
+     || !toFixedPoint(ld, PARAMID_L_BASE_DT_SCALE, &ldFixed)
+     || !withinBounds(rFixed, MCAF_MOTOR_RS)
+     || !withinBounds(ldFixed, MCAF_MOTOR_LD_BASE_DT))
+    {
+        return MCAF_PARAMID_ERR_OUT_OF_BOUNDS;
+    }
+    const float lq = ld * pparam->lqBaseDt / pparam->ldBaseDt;
+
+    const float wc = pid->currentLoopBandwidth;
+    const float phaseMargin = pid->currentLoopPhaseMargin * (PARAMID_HALF_PI / 90.0f);
+    MCAF_PARAMID_PI_GAINS_T gains[2];
+    if (!computeCurrentLoopGains(r, ld, wc, phaseMargin, &gains[0])
+     || !computeCurrentLoopGains(r, lq, wc, phaseMargin, &gains[1]))
+    {
+        return MCAF_PARAMID_ERR_TUNING;
+    }
+    pid->currentGains[0] = gains[0];
+    pid->currentGains[1] = gains[1];
+    return MCAF_PARAMID_ERR_NONE;
+}
+
+/**
+ * Computes the mechanical parameters, velocity controller gains
+ * and slew rate limits from the velocity-loop estimate.
+ *
+ * The mechanical plant is delta(omega)/dt = g*iq with g = a/Tw, so with
+ * C(s) = Kp*(1 + wz/s) the phase margin is 90deg - atan(wz/wc) - lag,
+ * which sets the zero wz; Kp then sets unity loop gain at wc.
+ *
+ * @param pid identification state
+ * @param prls estimator state
+ * @return error code
+ */
+static MCAF_PARAMID_ERROR computeVelocityLoopResult(volatile MCAF_PARAMID_T *pid,
+                                                    const MCAF_PARAMID_RLS_T *prls)
+{
+    const float a = prls->theta[PARAMID_ACCEL];
+    if (a <= 0.0f)
+    {
+        return MCAF_PARAMID_ERR_OUT_OF_BOUNDS;
+    }
+    const float g = a / PARAMID_VELOCITY_WINDOW_TIME;
+    const float coulombFriction = prls->theta[PARAMID_COULOMB] / a;
+    pid->inertia = 1.0f / g;
+    pid->viscousFriction = prls->theta[PARAMID_VISCOUS] / a;
+    pid->coulombFriction = coulombFriction;
+
+    const float wc = pid->velocityLoopBandwidth;
+    const float zeroAngle = (pid->velocityLoopPhaseMargin + MCAF_PARAMID_VELOCITY_LOOP_LAG)
+                          * (PARAMID_HALF_PI / 90.0f);
+    if ((zeroAngle >= PARAMID_HALF_PI) || (wc <= 0.0f))
+    {
+        return MCAF_PARAMID_ERR_TUNING;
+    }
+    const float wz = wc / tanf(zeroAngle);
+    const float kp = wc * wc / (g * sqrtf(wc*wc + wz*wz));
+    const float ki = kp * wz * VELOCITY_LOOP_TIME;
+    MCAF_PARAMID_PI_GAINS_T gains;
+    if (!toPiGains(kp, ki, &gains))
+    {
+        return MCAF_PARAMID_ERR_TUNING;
+    }
+
+    /* Leave current headroom for the velocity controller to reject disturbances,
+     * and keep the ratio of deceleration to acceleration of the defaults.
+     */
+    const float iqAvailable = MCAF_PARAMID_SLEW_RATE_CURRENT_MARGIN
+                            * CURRENT_MAXIMUM_COMMAND / PARAMID_Q15_SCALE
+                            - fabsf(coulombFriction);
+    if (iqAvailable <= 0.0f)
+    {
+        return MCAF_PARAMID_ERR_TUNING;
+    }
+    const float accel = g * iqAvailable * VELOCITY_LOOP_TIME;
+    int16_t slewRateLimitAccel, slewRateLimitDecel;
+    if (!toFixedPoint(accel, PARAMID_Q15_SCALE, &slewRateLimitAccel)
+     || !toFixedPoint(accel * VELOCITY_SLEWRATE_LIMIT_DECEL / VELOCITY_SLEWRATE_LIMIT_ACCEL,
+                      PARAMID_Q15_SCALE, &slewRateLimitDecel)
+     || (slewRateLimitDecel <= 0))
+    {
+        return MCAF_PARAMID_ERR_TUNING;
+    }
+    pid->velocityGains = gains;
+    pid->slewRateLimitAccel = slewRateLimitAccel;
+    pid->slewRateLimitDecel = slewRateLimitDecel;
+    return MCAF_PARAMID_ERR_NONE;
+}
+
+/**
+ * Starts a new window of the velocity-loop test
+ *
+ * @param pid identification state
+ * @param omega velocity at the start of the window
+ */
+static void velocityWindowReset(volatile MCAF_PARAMID_T *pid, MCAF_U_VELOCITY_ELEC omega)
+{
+    volatile MCAF_PARAMID_VELOCITY_WINDOW_T *pwindow = &pid->window;
+    pwindow->iqSum = 0;
+    pwindow->omegaSum = 0;
+    pwindow->omegaLast = omega;
+    pwindow->count = 0;
+    pwindow->overruns = pid->overruns;
+}
+
+/**
+ * Feeds one captured sample to the velocity-loop test: switches the relay,
+ * and feeds the estimator once a window is complete.
+ *
+ * @param pmotor motor state data
+ * @param prls estimator state
+ * @param psample captured sample
+ * @return whether the relay still controls the velocity
+ */
+static bool processVelocitySample(volatile MCAF_MOTOR_DATA *pmotor, MCAF_PARAMID_RLS_T *prls,
+                                  const MCAF_PARAMID_SAMPLE_T *psample)
+{
+    volatile MCAF_PARAMID_T *pid = &pmotor->paramId;
+    const MCAF_U_VELOCITY_ELEC omega = psample->omega;
+
+    /* Relay: push the velocity back towards the center once it leaves the band */
+    const int16_t error = UTIL_SatSubS16(omega, pid->relayCenter);
+    int16_t polarity = pid->relayPolarity;
+    if (error > MCAF_PARAMID_RELAY_BAND)
+    {
+        polarity = -1;
+    }
+    else if (error < -MCAF_PARAMID_RELAY_BAND)
+    {
+        polarity = 1;
+    }
+    if (polarity != pid->relayPolarity)
+    {
+        pid->relayPolarity = polarity;
+        pid->relayCount = 0;
+        MCAF_TestPerturbationPolaritySet(&pmotor->testing, polarity);
+    }
+    else if (++pid->relayCount >= MCAF_PARAMID_RELAY_TIMEOUT)
+    {
+        return false;
+    }
+
+    /* Samples are only evenly spaced if none were dropped */
+    volatile MCAF_PARAMID_VELOCITY_WINDOW_T *pwindow = &pid->window;
+    if (pwindow->overruns != pid->overruns)
+    {
+        velocityWindowReset(pid, omega);
+        return true;
+    }
+    pwindow->iqSum += psample->idq.q;
+    pwindow->omegaSum += omega;
+    if (++pwindow->count < MCAF_PARAMID_VELOCITY_WINDOW)
+    {
+        return true;
+    }
+
+    const float windowScale = 1.0f / (MCAF_PARAMID_VELOCITY_WINDOW * PARAMID_Q15_SCALE);
+    float phi[MCAF_PARAMID_PARAM_COUNT];
+    phi[PARAMID_ACCEL] = pwindow->iqSum * windowScale;
+    phi[PARAMID_VISCOUS] = -pwindow->omegaSum * windowScale;
+    phi[PARAMID_COULOMB] = -UTIL_SignFromHighBit(pid->relayCenter);
+    phi[PARAMID_KE] = 0.0f;
+    rlsUpdate(prls, phi, UTIL_SatSubS16(omega, pwindow->omegaLast) / PARAMID_Q15_SCALE);
+    velocityWindowReset(pid, omega);
+    return true;
+}
+
+/**
+ * Ends identification, removes the perturbation and
+ * restores the test harness settings of a locked-rotor test
+ *
+ * @param pmotor motor state data
+ * @param state final state
+ * @param error error code
+ */
+static void finish(volatile MCAF_MOTOR_DATA *pmotor, MCAF_PARAMID_STATE state,
+                   MCAF_PARAMID_ERROR error)
+{
+    volatile MCAF_PARAMID_T *pid = &pmotor->paramId;
+    pid->capturing = false;
+    MCAF_TestPerturbationStop(&pmotor->testing);
+    if ((pid->mode == MCAF_PARAMID_MODE_CURRENT_LOOP) && (pid->state == MCAF_PARAMID_RUNNING))
+    {
+        volatile MCAF_MOTOR_TEST_MANAGER *ptest = &pmotor->testing;
+        pmotor->vdqCmd.d = 0;
+        ptest->operatingMode = pid->savedTestState.operatingMode;
+        ptest->overrideOmegaElectrical = pid->savedTestState.overrideOmegaElectrical;
+        ptest->overrides = pid->savedTestState.overrides;
+    }
+    else if ((pid->mode == MCAF_PARAMID_MODE_VELOCITY_LOOP) && (pid->state == MCAF_PARAMID_RUNNING))
+    {
+        pmotor->testing.operatingMode = pid->savedTestState.operatingMode;
+    }
+    pid->error = error;
+    pid->state = state;
+}
+
+/**
+ * Checks whether the motor is still in the state the
+ * identification mode requires
+ *
+ * @param pmotor motor state data
+ * @return whether identification can run
+ */
+static bool motorStateValid(volatile MCAF_MOTOR_DATA *pmotor)
+{
+    if (pmotor->paramId.mode == MCAF_PARAMID_MODE_CURRENT_LOOP)
+    {
+        return pmotor->state == MCSM_TEST_ENABLE;
+    }
+    if (pmotor->paramId.mode == MCAF_PARAMID_MODE_VELOCITY_LOOP)
+    {
+        /* closed-loop velocity control holds the current command once
+         * switched to OM_FORCE_CURRENT, see start()
+         */
+        return (pmotor->state == MCSM_RUNNING)
+            && (MCAF_OperatingModeNormal(&pmotor->testing)
+             || ((pmotor->paramId.state == MCAF_PARAMID_RUNNING)
+              && (pmotor->testing.operatingMode == OM_FORCE_CURRENT)));
+    }
+    /* the current loop must be closed, so that the current perturbation is applied */
+    return ((pmotor->state == MCSM_RUNNING) || (pmotor->state == MCSM_TEST_ENABLE))
+        && MCAF_OperatingModeCurrentLoopActive(&pmotor->testing);
+}
+
+/**
+ * Starts identification, if the motor is in a suitable state
+ *
+ * @param pmotor motor state data
+ * @param mode identification mode
+ */
+static void start(volatile MCAF_MOTOR_DATA *pmotor, MCAF_PARAMID_MODE mode)
+{
+    volatile MCAF_PARAMID_T *pid = &pmotor->paramId;
+    pid->mode = mode;
+    if (pmotor->psys->testing.guard.key != TEST_GUARD_VALID)
+    {
+        finish(pmotor, MCAF_PARAMID_FAILED, MCAF_PARAMID_ERR_GUARD);
+        return;
+    }
+    if (!motorStateValid(pmotor))
+    {
+        finish(pmotor, MCAF_PARAMID_FAILED, MCAF_PARAMID_ERR_NOT_RUNNING);
+        return;
+    }
+    if ((mode != MCAF_PARAMID_MODE_CURRENT_LOOP)
+     && UTIL_AbsLessThan(pmotor->omegaElectrical, MCAF_PARAMID_MIN_VELOCITY))
+    {
+        finish(pmotor, MCAF_PARAMID_FAILED, MCAF_PARAMID_ERR_LOW_VELOCITY);
+        return;
+    }
+
+    rlsReset((MCAF_PARAMID_RLS_T *)&pid->rls, &pmotor->motorParameters);
+    pid->sampleCount = 0;
+    pid->overruns = 0;
+    pid->tail = pid->head;
+    pid->error = MCAF_PARAMID_ERR_NONE;
+    pid->state = MCAF_PARAMID_RUNNING;
+
+    if (mode == MCAF_PARAMID_MODE_CURRENT_LOOP)
+    {
+        /* Hold the commutation angle and apply a positive d-axis voltage,
+         * so that the rotor aligns with the d-axis and stays there.
+         */
+        volatile MCAF_MOTOR_TEST_MANAGER *ptest = &pmotor->testing;
+        pid->savedTestState.overrides = ptest->overrides;
+        pid->savedTestState.operatingMode = ptest->operatingMode;
+        pid->savedTestState.overrideOmegaElectrical = ptest->overrideOmegaElectrical;
+        ptest->overrideOmegaElectrical = 0;
+        ptest->overrides |= TEST_OVERRIDE_COMMUTATION;
+        pmotor->vdqCmd.q = 0;
+        pmotor->vdqCmd.d = MCAF_PARAMID_LOCKED_VOLTAGE_OFFSET;
+        ptest->operatingMode = OM_FORCE_VOLTAGE_DQ;
+
+        const MCAF_U_CURRENT_DQ idq = { 0, 0 };
+        const MCAF_U_VOLTAGE_DQ vdq = { MCAF_PARAMID_LOCKED_VOLTAGE_AMPLITUDE, 0 };
+        MCAF_TestPerturbationStart(ptest, &idq, &vdq, MCAF_PARAMID_HALFPERIOD);
+    }
+    else if (mode == MCAF_PARAMID_MODE_VELOCITY_LOOP)
+    {
+        /* Hold the q-axis current command of the velocity controller;
+         * the relay adds a current step of either sign to it.
+         */
+        volatile MCAF_MOTOR_TEST_MANAGER *ptest = &pmotor->testing;
+        rlsResetCovariance((MCAF_PARAMID_RLS_T *)&pid->rls,
+                           MCAF_PARAMID_VELOCITY_INITIAL_COVARIANCE);
+        int i;
+        for (i = 0; i < MCAF_PARAMID_PARAM_COUNT; ++i)
+        {
+            pid->rls.theta[i] = 0.0f;
+        }
+        const MCAF_U_VELOCITY_ELEC omega = pmotor->omegaElectrical;
+        pid->relayCenter = omega;
+        pid->relayPolarity = 1;
+        pid->relayCount = 0;
+        velocityWindowReset(pid, omega);
+        pid->savedTestState.operatingMode = ptest->operatingMode;
+        ptest->operatingMode = OM_FORCE_CURRENT;
+
+        const MCAF_U_CURRENT_DQ idq = { 0, MCAF_PARAMID_TORQUE_AMPLITUDE };
+        const MCAF_U_VOLTAGE_DQ vdq = { 0, 0 };
+        MCAF_TestPerturbationStart(ptest, &idq, &vdq, UINT32_MAX);
+    }
+    else
+    {
+        const MCAF_U_CURRENT_DQ idq = { MCAF_PARAMID_CURRENT_AMPLITUDE_D,
+                                        MCAF_PARAMID_CURRENT_AMPLITUDE_Q };
+        const MCAF_U_VOLTAGE_DQ vdq = { 0, 0 };
+        MCAF_TestPerturbationStart(&pmotor->testing, &idq, &vdq, MCAF_PARAMID_HALFPERIOD);
+    }
+    pid->decimationCount = 0;
+    pid->capturing = true;
+}
+
+/**
+ * Computes and hands over the result, once enough samples are processed
+ *
+ * @param pmotor motor state data
+ * @param prls estimator state
+ */
+static void complete(volatile MCAF_MOTOR_DATA *pmotor, const MCAF_PARAMID_RLS_T *prls)
+{
+    volatile MCAF_PARAMID_T *pid = &pmotor->paramId;
+    if (pid->mode == MCAF_PARAMID_MODE_CURRENT_LOOP)
+    {
+        const MCAF_PARAMID_ERROR error =
+            computeCurrentLoopResult(pid, prls, &pmotor->motorParameters);
+        if (error == MCAF_PARAMID_ERR_NONE)
+        {
+            pid->applyFlags = MCAF_PARAMID_APPLY_CURRENT_GAINS;
+            finish(pmotor, MCAF_PARAMID_COMPLETE, MCAF_PARAMID_ERR_NONE);
+        }
+        else
+        {
+            finish(pmotor, MCAF_PARAMID_FAILED, error);
+        }
+        return;
+    }
+    if (pid->mode == MCAF_PARAMID_MODE_VELOCITY_LOOP)
+    {
+        const MCAF_PARAMID_ERROR error = computeVelocityLoopResult(pid, prls);
+        if (error == MCAF_PARAMID_ERR_NONE)
+        {
+            pid->applyFlags = MCAF_PARAMID_APPLY_VELOCITY_GAINS;
+            finish(pmotor, MCAF_PARAMID_COMPLETE, MCAF_PARAMID_ERR_NONE);
+        }
+        else
+        {
+            finish(pmotor, MCAF_PARAMID_FAILED, error);
+        }
+        return;
+    }
+
+    MCAF_MOTOR_PARAMETERS_T result;
+    if (computeResult(prls, &result))
+    {
+        pid->result = result;
+        pid->applyFlags = MCAF_PARAMID_APPLY_MOTOR_PARAMETERS;
+        finish(pmotor, MCAF_PARAMID_COMPLETE, MCAF_PARAMID_ERR_NONE);
+    }
+    else
+    {
+        finish(pmotor, MCAF_PARAMID_FAILED, MCAF_PARAMID_ERR_OUT_OF_BOUNDS);
+    }
+}
+
+void MCAF_ParamIdStepMain(volatile MCAF_MOTOR_DATA *pmotor)
+{
+    volatile MCAF_PARAMID_T *pid = &pmotor->paramId;
+    /* The estimator state is only accessed from the main loop. */
+    MCAF_PARAMID_RLS_T *prls = (MCAF_PARAMID_RLS_T *)&pid->rls;
+
+    const uint16_t command = pid->command;
+    if (command != MCAF_PARAMID_CMD_NONE)
+    {
+        pid->command = MCAF_PARAMID_CMD_NONE;
+    }
+
+    if (pid->state != MCAF_PARAMID_RUNNING)
+    {
+        if (command == MCAF_PARAMID_CMD_START)
+        {
+            start(pmotor, MCAF_PARAMID_MODE_MOTOR);
+        }
+        else if (command == MCAF_PARAMID_CMD_TUNE_CURRENT_LOOP)
+        {
+            start(pmotor, MCAF_PARAMID_MODE_CURRENT_LOOP);
+        }
+        else if (command == MCAF_PARAMID_CMD_TUNE_VELOCITY_LOOP)
+        {
+            start(pmotor, MCAF_PARAMID_MODE_VELOCITY_LOOP);
+        }
+        return;
+    }
+
+    if ((command == MCAF_PARAMID_CMD_ABORT) || !motorStateValid(pmotor))
+    {
+        finish(pmotor, MCAF_PARAMID_FAILED, MCAF_PARAMID_ERR_ABORTED);
+        return;
+    }
+
+    const uint16_t mode = pid->mode;
+    const bool lockedRotor = (mode == MCAF_PARAMID_MODE_CURRENT_LOOP);
+    uint16_t tail = pid->tail;
+    uint16_t budget = PARAMID_SAMPLES_PER_STEP;
+    while ((tail != pid->head) && (budget > 0))
+    {
+        const MCAF_PARAMID_SAMPLE_T sample = pid->queue[tail];
+        tail = (tail + 1) & (MCAF_PARAMID_QUEUE_SIZE - 1);
+        pid->tail = tail;
+        if (mode != MCAF_PARAMID_MODE_VELOCITY_LOOP)
+        {
+            processSample(prls, &sample, lockedRotor);
+        }
+        else if (!processVelocitySample(pmotor, prls, &sample))
+        {
+            finish(pmotor, MCAF_PARAMID_FAILED, MCAF_PARAMID_ERR_VELOCITY);
+            return;
+        }
+        ++pid->sampleCount;
+        --budget;
+
+        /* second half of the velocity-loop test runs at a higher velocity,
+         * so that viscous and Coulomb friction can be told apart
+         */
+        if ((mode == MCAF_PARAMID_MODE_VELOCITY_LOOP)
+         && (pid->sampleCount == MCAF_PARAMID_SAMPLE_COUNT / 2))
+        {
+            pid->relayCenter = UTIL_SatAddS16(pid->relayCenter, pid->relayCenter >> 2);
+        }
+    }
+
+    if (pid->sampleCount >= MCAF_PARAMID_SAMPLE_COUNT)
+    {
+        complete(pmotor, prls);
+    }
+}
+
+#endif // MCAF_INCLUDE_PARAM_ID
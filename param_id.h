@@ -0,0 +1,216 @@
+/**
+ * param_id.h
+ *
+ * On-target identification of motor parameters (Rs, Ld, Lq, Ke)
+ * and locked-rotor current-loop autotuning
+ * 
+ * Component: test harness
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __PARAM_ID_H
+#define __PARAM_ID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "system_state.h"
+#include "param_id_types.h"
+#include "parameters/param_id_params.h"
+#include "util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes parameter identification state
+ *
+ * @param pid identification state
+ */
+void MCAF_ParamIdInit(MCAF_PARAMID_T *pid);
+
+/**
+ * Applies identified motor parameters and controller gains once
+ * the main loop has made them available. Copying them in the ISR
+ * ensures that the control loops never see a partial update.
+ *
+ * Executed in the ISR.
+ *
+ * @param pmotor motor state data
+ */
+inline static void MCAF_ParamIdApplyIsr(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_PARAMID_T *pid = &pmotor->paramId;
+    const uint16_t applyFlags = pid->applyFlags;
+    if (applyFlags == 0)
+    {
+        return;
+    }
+    if (applyFlags & MCAF_PARAMID_APPLY_MOTOR_PARAMETERS)
+    {
+        pmotor->motorParameters = pid->result;
+    }
+    if (applyFlags & MCAF_PARAMID_APPLY_CURRENT_GAINS)
+    {
+        const MCAF_PARAMID_PI_GAINS_T *pdGains = &pid->currentGains[0];
+        const MCAF_PARAMID_PI_GAINS_T *pqGains = &pid->currentGains[1];
+        pmotor->idCtrl.kp  = pdGains->kp;
+        pmotor->idCtrl.ki  = pdGains->ki;
+        pmotor->idCtrl.nkp = pdGains->nkp;
+        pmotor->idCtrl.nki = pdGains->nki;
+        pmotor->iqCtrl.kp  = pqGains->kp;
+        pmotor->iqCtrl.ki  = pqGains->ki;
+        pmotor->iqCtrl.nkp = pqGains->nkp;
+        pmotor->iqCtrl.nki = pqGains->nki;
+    }
+    if (applyFlags & MCAF_PARAMID_APPLY_VELOCITY_GAINS)
+    {
+        const MCAF_PARAMID_PI_GAINS_T *pgains = &pid->velocityGains;
+        pmotor->omegaCtrl.kp  = pgains->kp;
+        pmotor->omegaCtrl.ki  = pgains->ki;
+        pmotor->omegaCtrl.nkp = pgains->nkp;
+        pmotor->omegaCtrl.nki = pgains->nki;
+        pmotor->velocityControl.slewRateLimitAccel = pid->slewRateLimitAccel;
+        pmotor->velocityControl.slewRateLimitDecel = pid->slewRateLimitDecel;
+        pmotor->config.velocitySlewRateLimitAccel  = pid->slewRateLimitAccel;
+        pmotor->config.velocitySlewRateLimitDecel  = pid->slewRateLimitDecel;
+    }
+    pid->applyFlags = 0;
+}
+
+/**
+ * Captures one sample of the stator voltage equations for the estimator.
+ *
+ * This must be called once per control cycle, after the dq-axis current
+ * has been measured and before the dq-axis voltage is recalculated,
+ * so that pvdq is the voltage applied during the cycle that
+ * produced the change in current.
+ *
+ * Executed in the ISR.
+ *
+ * @param pid identification state
+ * @param pidq measured dq-axis current
+ * @param pvdq dq-axis voltage applied during the previous control cycle
+ * @param omega electrical velocity
+ */
+inline static void MCAF_ParamIdCaptureIsr(MCAF_PARAMID_T *pid,
+                                          const MCAF_U_CURRENT_DQ *pidq,
+                                          const MCAF_U_VOLTAGE_DQ *pvdq,
+                                          MCAF_U_VELOCITY_ELEC omega)
+{
+    if (pid->capturing)
+    {
+        MCAF_PARAMID_SAMPLE_T sample;
+        sample.didq.d = UTIL_SatSubS16(pidq->d, pid->idqPrev.d);
+        sample.didq.q = UTIL_SatSubS16(pidq->q, pid->idqPrev.q);
+
+        /* Perturbation edges carry the inductance information,
+         * so capture every sample around them. The velocity-loop test
+         * needs evenly spaced samples instead.
+         */
+        const bool edge = (pid->mode != MCAF_PARAMID_MODE_VELOCITY_LOOP)
+                       && ((UTIL_Abs16(sample.didq.d) > MCAF_PARAMID_EDGE_THRESHOLD)
+                        || (UTIL_Abs16(sample.didq.q) > MCAF_PARAMID_EDGE_THRESHOLD));
+        if (edge || (++pid->decimationCount >= MCAF_PARAMID_DECIMATION))
+        {
+            pid->decimationCount = 0;
+            const uint16_t head = pid->head;
+            const uint16_t next = (head + 1) & (MCAF_PARAMID_QUEUE_SIZE - 1);
+            if (next == pid->tail)
+            {
+                ++pid->overruns;
+            }
+            else
+            {
+                sample.idq.d = (pidq->d >> 1) + (pid->idqPrev.d >> 1);
+                sample.idq.q = (pidq->q >> 1) + (pid->idqPrev.q >> 1);
+                sample.vdq = *pvdq;
+                sample.omega = omega;
+                pid->queue[head] = sample;
+                pid->head = next;
+            }
+        }
+    }
+    pid->idqPrev = *pidq;
+}
+
+/**
+ * Runs the identification sequence and the recursive least-squares estimator.
+ *
+ * Identification is started by writing MCAF_PARAMID_CMD_START to
+ * pmotor->paramId.command while the motor is running under current control
+ * and the test harness guard key is valid. The current command is perturbed
+ * with a square wave in both axes; once enough samples have been processed,
+ * the estimates are checked against plausibility bounds and written
+ * to pmotor->motorParameters.
+ *
+ * Current-loop autotuning is started by writing
+ * MCAF_PARAMID_CMD_TUNE_CURRENT_LOOP while in the MCSM_TEST_ENABLE state.
+ * The commutation angle is held and a square-wave d-axis voltage is
+ * applied on top of a constant offset in OM_FORCE_VOLTAGE_DQ, so that the
+ * rotor stays aligned with the d-axis. Rs and Ld are estimated, and the
+ * current controller gains are computed for paramId.currentLoopBandwidth
+ * and paramId.currentLoopPhaseMargin and applied to both axes, with the
+ * q-axis gains scaled for the saliency in motorParameters. The previous
+ * test harness settings are restored afterwards.
+ *
+ * Velocity-loop autotuning is started by writing
+ * MCAF_PARAMID_CMD_TUNE_VELOCITY_LOOP while the motor is running in
+ * OM_NORMAL. The q-axis current command is held in OM_FORCE_CURRENT and
+ * a relay adds a q-axis current step whose sign keeps the velocity within
+ * a band around the starting velocity, and later around a velocity 25%
+ * higher. The inertia and friction are estimated from the velocity
+ * response, and the velocity controller gains and slew rate limits are
+ * computed for paramId.velocityLoopBandwidth and
+ * paramId.velocityLoopPhaseMargin. The slew rate limits persist across
+ * restarts.
+ *
+ * Executed in the main loop.
+ *
+ * @param pmotor motor state data
+ */
+void MCAF_ParamIdStepMain(volatile MCAF_MOTOR_DATA *pmotor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_ID_H */
@@ -0,0 +1,231 @@
+/**
+ * param_id_types.h
+ * 
+ * This module holds typedef structures used in param_id.h
+ * 
+ * Component: test harness
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __PARAM_ID_TYPES_H
+#define __PARAM_ID_TYPES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "units.h"
+#include "foc_types.h"
+#include "sat_PI_types.h"
+
+/** Number of entries in the sample queue; must be a power of 2 */
+#define MCAF_PARAMID_QUEUE_SIZE 16
+
+/** Number of identified parameters: Rs, Ld, Lq, Ke */
+#define MCAF_PARAMID_PARAM_COUNT 4
+
+/**
+ * Identification state
+ */
+typedef enum tagMCAF_PARAMID_STATE
+{
+    MCAF_PARAMID_IDLE      = 0,  /** no identification requested */
+    MCAF_PARAMID_RUNNING   = 1,  /** perturbation active, estimator running */
+    MCAF_PARAMID_COMPLETE  = 2,  /** results written to motor parameters */
+    MCAF_PARAMID_FAILED    = 3   /** identification aborted, see error */
+} MCAF_PARAMID_STATE;
+
+/**
+ * Identification error codes
+ */
+typedef enum tagMCAF_PARAMID_ERROR
+{
+    MCAF_PARAMID_ERR_NONE          = 0,  /** no error */
+    MCAF_PARAMID_ERR_GUARD         = 1,  /** test harness guard key is not valid */
+    MCAF_PARAMID_ERR_NOT_RUNNING   = 2,  /** motor not in the state required by the command */
+    MCAF_PARAMID_ERR_LOW_VELOCITY  = 3,  /** velocity too low to observe back-emf */
+    MCAF_PARAMID_ERR_ABORTED       = 4,  /** aborted by request or state change */
+    MCAF_PARAMID_ERR_OUT_OF_BOUNDS = 5,  /** estimate outside of plausibility bounds */
+    MCAF_PARAMID_ERR_TUNING        = 6,  /** requested bandwidth and phase margin not achievable */
+    MCAF_PARAMID_ERR_VELOCITY      = 7   /** velocity left the relay band and did not return */
+} MCAF_PARAMID_ERROR;
+
+/**
+ * Identification commands, written by the host
+ */
+typedef enum tagMCAF_PARAMID_COMMAND
+{
+    MCAF_PARAMID_CMD_NONE  = 0,  /** no command pending */
+    MCAF_PARAMID_CMD_START = 1,  /** start identification */
+    MCAF_PARAMID_CMD_ABORT = 2,  /** abort identification */
+    MCAF_PARAMID_CMD_TUNE_CURRENT_LOOP = 3, /** start locked-rotor current-loop autotuning */
+    MCAF_PARAMID_CMD_TUNE_VELOCITY_LOOP = 4 /** start velocity-loop autotuning */
+} MCAF_PARAMID_COMMAND;
+
+/**
+ * Identification mode
+ */
+typedef enum tagMCAF_PARAMID_MODE
+{
+    MCAF_PARAMID_MODE_MOTOR        = 0,  /** running motor: Rs, Ld, Lq, Ke */
+    MCAF_PARAMID_MODE_CURRENT_LOOP = 1,  /** locked rotor: Rs, Ld, then current-loop gains */
+    MCAF_PARAMID_MODE_VELOCITY_LOOP = 2  /** running motor: inertia, friction, then velocity-loop gains */
+} MCAF_PARAMID_MODE;
+
+/**
+ * Results that the ISR applies on behalf of the main loop
+ */
+typedef enum tagMCAF_PARAMID_APPLY
+{
+    MCAF_PARAMID_APPLY_MOTOR_PARAMETERS = 1,  /** copy result to motor parameters */
+    MCAF_PARAMID_APPLY_CURRENT_GAINS    = 2,  /** copy gains to the current controllers */
+    MCAF_PARAMID_APPLY_VELOCITY_GAINS   = 4   /** copy gains and slew rate limits to the velocity loop */
+} MCAF_PARAMID_APPLY;
+
+/**
+ * PI controller gains
+ */
+typedef struct tagMCAF_PARAMID_PI_GAINS
+{
+    int16_t kp;         /** proportional gain */
+    int16_t ki;         /** integral gain */
+    int16_t nkp;        /** normalizing shift of proportional gain */
+    int16_t nki;        /** normalizing shift of integral gain */
+} MCAF_PARAMID_PI_GAINS_T;
+
+/**
+ * Test harness settings that are replaced during locked-rotor tests
+ */
+typedef struct tagMCAF_PARAMID_SAVED_TEST_STATE
+{
+    uint16_t overrides;                 /** override bits */
+    uint16_t operatingMode;             /** operating mode */
+    MCAF_U_VELOCITY_DTHETA_ELEC_DT overrideOmegaElectrical; /** commutation frequency override */
+} MCAF_PARAMID_SAVED_TEST_STATE_T;
+
+/**
+ * One sample of the stator voltage equations, captured in the ISR
+ */
+typedef struct tagMCAF_PARAMID_SAMPLE
+{
+    MCAF_U_CURRENT_DQ idq;         /** dq-axis current, average over the control cycle */
+    MCAF_U_CURRENT_DQ didq;        /** change in dq-axis current over the control cycle */
+    MCAF_U_VOLTAGE_DQ vdq;         /** dq-axis voltage applied during the control cycle */
+    MCAF_U_VELOCITY_ELEC omega;    /** electrical velocity */
+} MCAF_PARAMID_SAMPLE_T;
+
+/**
+ * Accumulated samples over one window of the velocity-loop test
+ */
+typedef struct tagMCAF_PARAMID_VELOCITY_WINDOW
+{
+    int32_t iqSum;                  /** sum of q-axis current */
+    int32_t omegaSum;               /** sum of electrical velocity */
+    MCAF_U_VELOCITY_ELEC omegaLast; /** velocity at the end of the previous window */
+    uint16_t count;                 /** number of samples accumulated */
+    uint16_t overruns;              /** queue overrun count at the start of the window */
+} MCAF_PARAMID_VELOCITY_WINDOW_T;
+
+/**
+ * Recursive least-squares estimator state, used by the main loop only
+ *
+ * The parameter vector is held in per-unit form:
+ * theta = [Rs, Ld/(Lbase*dt), Lq/(Lbase*dt), Ke], see param_id.c.
+ */
+typedef struct tagMCAF_PARAMID_RLS
+{
+    float theta[MCAF_PARAMID_PARAM_COUNT];                           /** parameter estimate */
+    float p[MCAF_PARAMID_PARAM_COUNT][MCAF_PARAMID_PARAM_COUNT];     /** covariance matrix */
+} MCAF_PARAMID_RLS_T;
+
+/**
+ * State variables for on-target parameter identification
+ */
+typedef struct tagMCAF_PARAMID
+{
+    /* shared between ISR and main loop */
+    volatile uint16_t command;      /** host command, see MCAF_PARAMID_COMMAND */
+    volatile uint16_t state;        /** identification state, see MCAF_PARAMID_STATE */
+    volatile uint16_t error;        /** error code, see MCAF_PARAMID_ERROR */
+    volatile uint16_t mode;         /** identification mode, see MCAF_PARAMID_MODE */
+    volatile bool capturing;        /** ISR captures samples while true */
+    volatile uint16_t applyFlags;   /** results for the ISR to apply, see MCAF_PARAMID_APPLY */
+    volatile uint16_t head;         /** sample queue write index, written by ISR */
+    volatile uint16_t tail;         /** sample queue read index, written by main loop */
+    MCAF_PARAMID_SAMPLE_T queue[MCAF_PARAMID_QUEUE_SIZE]; /** sample queue */
+    uint16_t overruns;              /** number of samples dropped due to a full queue */
+
+    /* ISR-only state */
+    MCAF_U_CURRENT_DQ idqPrev;      /** dq-axis current in the previous control cycle */
+    uint16_t decimationCount;       /** counter for decimated sample capture */
+
+    /* main-loop-only state */
+    uint16_t sampleCount;           /** number of samples processed */
+    MCAF_PARAMID_RLS_T rls;         /** estimator state */
+    MCAF_MOTOR_PARAMETERS_T result; /** identified motor parameters */
+
+    /* current-loop autotuning */
+    uint16_t currentLoopBandwidth;  /** requested current-loop crossover frequency, rad/s */
+    uint16_t currentLoopPhaseMargin; /** requested current-loop phase margin, degrees */
+    MCAF_PARAMID_PI_GAINS_T currentGains[2]; /** computed d- and q-axis gains */
+    MCAF_PARAMID_SAVED_TEST_STATE_T savedTestState; /** test harness settings to restore */
+
+    /* velocity-loop autotuning */
+    uint16_t velocityLoopBandwidth; /** requested velocity-loop crossover frequency, rad/s */
+    uint16_t velocityLoopPhaseMargin; /** requested velocity-loop phase margin, degrees */
+    MCAF_U_VELOCITY_ELEC relayCenter; /** velocity around which the relay switches */
+    int16_t relayPolarity;          /** sign of the q-axis current perturbation */
+    uint16_t relayCount;            /** samples since the relay last switched */
+    MCAF_PARAMID_VELOCITY_WINDOW_T window; /** samples of the present window */
+    float inertia;                  /** total inertia, per-unit current per per-unit acceleration (s) */
+    float viscousFriction;          /** viscous friction, per-unit current per per-unit velocity */
+    float coulombFriction;          /** Coulomb friction and constant load torque, per-unit current */
+    MCAF_PARAMID_PI_GAINS_T velocityGains; /** computed velocity controller gains */
+    int16_t slewRateLimitAccel;     /** computed acceleration slew rate limit */
+    int16_t slewRateLimitDecel;     /** computed deceleration slew rate limit */
+} MCAF_PARAMID_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_ID_TYPES_H */
@@ -134,6 +134,47 @@ extern "C" {
  */
 #define TIMER_COUNTS_VARIANCE_DETECT           20      // Q0( 20.00000)  = +100.00000 ms          =  +97.93098 ms          + 2.1127%
 
+/* 
+ * Goertzel loss-of-lock detector: the back-emf Es is sampled every
+ * MCAF_GOERTZEL_DETECT_DECIMATION ISRs, and its energy at the electrical
+ * frequency and harmonics is computed over blocks of
+ * MCAF_GOERTZEL_DETECT_BLOCK_LENGTH samples, after removing the mean
+ * of the previous block. Loss of lock is reported when the ratio of this
+ * energy to the mean Es^2 exceeds MCAF_GOERTZEL_DETECT_RATIO_THRESHOLD
+ * for MCAF_GOERTZEL_DETECT_BLOCK_COUNT consecutive blocks.
+ * The decimation must exceed the number of harmonics by at least 2,
+ * since the evaluation of each block is spread over the ISRs
+ * between two samples.
+ */
+#define MCAF_GOERTZEL_DETECT_DECIMATION        20      // Q0( 20.00000)  =   +1.00000 ms          =   +1.00000 ms          + 0.0000%
+#define MCAF_GOERTZEL_DETECT_BLOCK_LENGTH      64      // Q0( 64.00000)  =  +64.00000 ms          =  +64.00000 ms          + 0.0000%
+#define MCAF_GOERTZEL_DETECT_BLOCK_LENGTH_Q     6
+#define MCAF_GOERTZEL_DETECT_BLOCK_COUNT        2      // Q0(  2.00000)  = +128.00000 ms          = +128.00000 ms          + 0.0000%
+/* 
+ * Detection latency bound: the rest of the current block, plus
+ * MCAF_GOERTZEL_DETECT_BLOCK_COUNT blocks, since the last block is evaluated
+ * within one sample period. This holds only from the point where the
+ * harmonic energy exceeds MCAF_GOERTZEL_DETECT_RATIO_THRESHOLD in every
+ * block and the estimated velocity stays above
+ * MCAF_GOERTZEL_DETECT_VELOCITY_THRESHOLD throughout. A loss of lock
+ * that builds up gradually is detected later; one where the estimated
+ * velocity falls below the threshold (e.g. a sudden load that stops the
+ * rotor) is not detected at all, and is left to the other detectors.
+ * tools/stall_detect_eval.py shows both cases in its simulated scenarios;
+ * the ratio threshold and block count should be tuned with it on recorded
+ * streams before this detector is enabled.
+ */
+#define MCAF_GOERTZEL_DETECT_LATENCY         3840      // Q0(3840.00000) = +192.00000 ms          = +192.00000 ms          + 0.0000%
+/* Time between samples, normalized for computing the bin angle from the electrical frequency */
+#define MCAF_GOERTZEL_DETECT_NORM_DELTAT    13107      // Q15(  0.39999) = +999.97711 useconds    =   +1.00000 ms          - 0.0023%
+/* Threshold of harmonic energy relative to Es^2 (harmonic amplitude 50% of Es) */
+#define MCAF_GOERTZEL_DETECT_RATIO_THRESHOLD   8192      // Q15(  0.25000) = +250.00000 m           = +250.00000 m           + 0.0000%
+/* 
+ * Minimum velocity for the Goertzel detector, so that the electrical
+ * frequency is at least two bin widths from DC
+ */
+#define MCAF_GOERTZEL_DETECT_VELOCITY_THRESHOLD   5461      // Q15(  0.16666) = +999.93896 RPM         =   +1.00000 kRPM        - 0.0061%
+
 /* Threshold for under speed detect as a fixed fraction of minimum velocity */
 #define THRESHOLD_UNDERSPEED_STALL_DETECT  ((int16_t)(0.333*MCAF_VELOCITY_COMMAND_MIN))
 /* Ed detect threshold */
@@ -0,0 +1,68 @@
+/* 
+ * flight_recorder_params.h
+ * 
+ * parameters for the flight recorder
+ *
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __FLIGHT_RECORDER_PARAMS_H
+#define __FLIGHT_RECORDER_PARAMS_H
+
+#include "event_queue_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event types that freeze the recording: fault detected, stall detected;
+ * add (1u << MCAF_EVENT_RECOVERY) to freeze on recovery retries as well */
+#define MCAF_RECORDER_TRIGGER_MASK        ((1u << MCAF_EVENT_FAULT) | (1u << MCAF_EVENT_STALL_DETECT))
+/* Number of frames recorded after the trigger; the remainder of the buffer precedes it */
+#define MCAF_RECORDER_POST_TRIGGER_FRAMES      32      // Q0( 32.00000)  =   +1.60000 ms          =   +1.60000 ms          + 0.0000%
+/* Freeze a recording that is still in progress at a trap or watchdog timeout reset */
+#define MCAF_RECORDER_FREEZE_ON_RESET           1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLIGHT_RECORDER_PARAMS_H */
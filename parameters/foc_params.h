@@ -76,6 +76,12 @@ extern "C" {
 #define KWI                                    37      // Q15(  0.00113) =  +78.35350 mA/rad      =  +77.32438 mA/rad      + 1.3309%
 #define KWI_Q                                  15
 
+//// Position loop (with an encoder only, see MCAF_EncoderEnabled())
+// crossover frequency = 15.000 rad/s, a quarter of the velocity loop
+/* Position loop proportional gain */
+#define KPOSP                                1258      // Q8(  4.91406) =  +14.99653 1/s          =  +15.00000 1/s          - 0.0232%
+#define KPOSP_Q                                 8
+
 
 /*
  * For the two output limits below, 
@@ -113,6 +119,10 @@ extern "C" {
 #define     WKP        KWP
 #define     WKI        KWI
 #define     WKC        Q15(0.0)
+/* Velocity loop anti-windup method (MCAF_PI_ANTIWINDUP_MODE).
+ * With MCAF_PI_ANTIWINDUP_BACK_CALCULATION, WKC is the tracking gain
+ * Kt = Ts/Tt and must be nonzero; 0.1 - 0.5 is a reasonable range. */
+#define     MCAF_VELOCITY_CTRL_ANTIWINDUP  MCAF_PI_ANTIWINDUP_SAT_STATE
 #define     MCAF_VELOCITY_CTRL_IQ_OUT_LIMIT  CURRENT_MAXIMUM_COMMAND   // see sat_PI_params.h for definition
 #define     WKNP       (15-KWP_Q)
 #define     WKNI       (15-KWI_Q)
@@ -175,6 +185,47 @@ extern "C" {
 
 #define MCAF_RECIPROCAL_CURRENT_NUMERATOR (1<<11) // 1.0 Q11
 
+/*
+ * Online adaptation of stator resistance and back-emf constant
+ *
+ * Rs tracks winding temperature (copper: about +0.39%/K), Ke tracks magnet
+ * temperature (NdFeB: about -0.1%/K). Bounds are set around the values
+ * in motor_params.h to cover the expected temperature range.
+ */
+/* low-pass filter coefficient for the signals used by the adaptation */
+#define MCAF_PARAM_ADAPT_FILTER_COEFF         103      // Q16(  0.00157) =   +5.00273 Hz          =   +5.00000 Hz          + 0.0547%
+/* d-axis current injected to make Rs observable from the d-axis voltage */
+#define MCAF_PARAM_ADAPT_ID_INJECTION        -752      // Q15( -0.02295) =   -1.00059 A           =   -1.00000 A           + 0.0586%
+/* minimum d-axis current for which Rs is updated */
+#define MCAF_PARAM_ADAPT_ID_MIN               564      // Q15(  0.01721) = +750.43945 mA          = +750.00000 mA          + 0.0586%
+/*
+ * amplitude of the voltage error caused by inverter deadtime,
+ * as a fraction of the DC link voltage: (4/pi) * deadtime / PWM period
+ * with the 2us deadtime of hal_params.h
+ */
+#define MCAF_PARAM_ADAPT_DEADTIME_GAIN       1669      // Q15(  0.05093) =   +0.05093             =   +0.05093             + 0.0082%
+/* minimum velocity for which adaptation is active */
+#define MCAF_PARAM_ADAPT_VELOCITY_MIN        3277      // Q15(  0.10001) = +600.03662 RPM         = +600.00000 RPM         + 0.0061%
+/* maximum deviation between velocity and filtered velocity for steady state */
+#define MCAF_PARAM_ADAPT_VELOCITY_RIPPLE      328      // Q15(  0.01001) =  +60.05859 RPM         =  +60.00000 RPM         + 0.0976%
+/* maximum change of Rs per update (1 ms) */
+#define MCAF_PARAM_ADAPT_RS_SLEW                1      // Q15(  0.00003) =  +49.90604 uohm        =  +49.90000 uohm        + 0.0121%
+/* maximum change of Ke per Ke slew period */
+#define MCAF_PARAM_ADAPT_KE_SLEW                1      // Q12(  0.00024) =  +27.70446 uV/(rad/s)  =  +27.70000 uV/(rad/s)  + 0.0161%
+/*
+ * number of updates (1 ms each) per Ke slew step: one LSB of Ke is about
+ * 0.1% or 1 K of magnet temperature, so Ke tracks up to 1 K/s, well above
+ * the thermal time constant of the magnets (minutes) but too slow
+ * to follow load transients; the full bound range takes about 5 minutes
+ */
+#define MCAF_PARAM_ADAPT_KE_SLEW_PERIOD      1000      // Q0(1000.00000) =   +1.00000 s           =   +1.00000 s           + 0.0000%
+/* plausibility bounds of Rs */
+#define MCAF_PARAM_ADAPT_RS_MIN              7984      // Q15(  0.24365) = +398.44982 mohm        = +398.46800 mohm        - 0.0046%
+#define MCAF_PARAM_ADAPT_RS_MAX             18250      // Q15(  0.55695) = +910.78583 mohm        = +910.78400 mohm        + 0.0002%
+/* plausibility bounds of Ke */
+#define MCAF_PARAM_ADAPT_KE_MIN               819      // Q12(  0.19995) =  +22.68996 mV/(rad/s)  =  +22.68997 mV/(rad/s)  - 0.0000%
+#define MCAF_PARAM_ADAPT_KE_MAX              1126      // Q12(  0.27490) =  +31.19522 mV/(rad/s)  =  +31.19871 mV/(rad/s)  - 0.0112%
+
 #ifdef  __cplusplus
 }
 #endif
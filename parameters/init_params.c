@@ -57,6 +57,7 @@ void MCAF_InitControlParameters_Motor1(MCAF_MOTOR_DATA *pmotor)
     pmotor->idCtrl.nkp = DKNP;
     pmotor->idCtrl.nki = DKNI;
     pmotor->idCtrl.kc = DKC;
+    pmotor->idCtrl.antiWindup = MCAF_PI_ANTIWINDUP_SAT_STATE;
     pmotor->idCtrl.outMax = 0;
     pmotor->idCtrl.outMin = 0;
     pmotor->idqCtrlOutLimit.d = MCAF_CURRENT_CTRL_D_OUT_LIMIT;
@@ -67,6 +68,7 @@ void MCAF_InitControlParameters_Motor1(MCAF_MOTOR_DATA *pmotor)
     pmotor->iqCtrl.nkp = QKNP;
     pmotor->iqCtrl.nki = QKNI;
     pmotor->iqCtrl.kc = QKC;
+    pmotor->iqCtrl.antiWindup = MCAF_PI_ANTIWINDUP_SAT_STATE;
     pmotor->iqCtrl.outMax = 0;
     pmotor->iqCtrl.outMin = 0;
     pmotor->idqCtrlOutLimit.q = MCAF_CURRENT_CTRL_Q_OUT_LIMIT;
@@ -78,6 +80,7 @@ void MCAF_InitControlParameters_Motor1(MCAF_MOTOR_DATA *pmotor)
     pmotor->omegaCtrl.nki = WKNI;
     pmotor->velocityControl.velocityCmdGain = INT16_MAX;
     pmotor->omegaCtrl.kc = WKC;
+    pmotor->omegaCtrl.antiWindup = MCAF_VELOCITY_CTRL_ANTIWINDUP;
     pmotor->omegaCtrl.outMax = MCAF_VELOCITY_CTRL_IQ_OUT_LIMIT;
     pmotor->omegaCtrl.outMin = -MCAF_VELOCITY_CTRL_IQ_OUT_LIMIT;
     
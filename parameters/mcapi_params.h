@@ -47,6 +47,8 @@
 #ifndef __MCAPI_PARAMS_H
 #define __MCAPI_PARAMS_H
 
+#include "qei_params.h"
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
@@ -60,11 +62,18 @@ extern "C" {
 #define MCAPI_MINIMUM_VELOCITY               5461      // Q15(  0.16666) = +104.71336 rad/s       = +104.71976 rad/s       - 0.0061%
 /* Maximum velocity command */
 #define MCAPI_MAXIMUM_VELOCITY              27307      // Q15(  0.83334) = +523.60517 rad/s       = +523.59878 rad/s       + 0.0012%
+/* Default slew rate limit of the torque reference, per ISR */
+#define MCAPI_TORQUE_SLEWRATE                  30      // Q15(  0.00092) = +798.33984 A/s         = +800.00000 A/s         - 0.2075%
+/* Default velocity limit in torque control */
+#define MCAPI_TORQUE_VELOCITY_LIMIT         27307      // Q15(  0.83334) = +523.60517 rad/s       = +523.59878 rad/s       + 0.0012%
+/* Default velocity limit in position control */
+#define MCAPI_POSITION_VELOCITY_LIMIT       10923      // Q15(  0.33334) = +209.44590 rad/s       = +209.43951 rad/s       + 0.0031%
 
 #define MCAPI_FULLSCALE_CURRENT                   43.6 //            A
 #define MCAPI_FULLSCALE_VOLTAGE                   71.3 //            V
 #define MCAPI_FULLSCALE_VELOCITY                  6000 //            RPM
 #define MCAPI_FULLSCALE_TORQUE            0.9274525877 //            Nm
+#define MCAPI_POSITION_COUNTS_PER_REV   MCAF_QEI_COUNTS_PER_REV
 
 #ifdef  __cplusplus
 }
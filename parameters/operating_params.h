@@ -94,6 +94,32 @@ extern "C" {
 /* Speed threshold for a closed-loop stop */
 #define MCAF_CLOSED_LOOP_STOPPING_SPEED       1092      // Q15(  0.03333) =  +20.93884 rad/s       =  +20.94395 rad/s       - 0.0244%
 
+/* Interval between zero-vector probes for rotor standstill detection */
+#define MCAF_STOP_DETECT_PROBE_PERIOD          200      // Q0(200.00000)  =  +10.00000 ms          =  +10.00000 ms          + 0.0000%
+/* Maximum duration of a zero-vector probe */
+#define MCAF_STOP_DETECT_PROBE_DURATION          4      // Q0(  4.00000)  = +200.00000 us          = +200.00000 us          + 0.0000%
+/* Probe current |ialpha|+|ibeta| above which the rotor is considered to be moving */
+#define MCAF_STOP_DETECT_CURRENT_THRESHOLD      38      // Q15(  0.00116) =  +50.56152 mA          =  +50.00000 mA          + 1.1230%
+/* Number of consecutive quiet probes before the rotor is considered to be stopped */
+#define MCAF_STOP_DETECT_CONFIRM_COUNT           3      // Q0(  3.00000)  =   +3.00000 counts      =   +3.00000 counts      + 0.0000%
+
+/* Active braking: deceleration slew rate limit, 4x VELOCITY_SLEWRATE_LIMIT_DECEL */
+#define MCAF_BRAKING_SLEWRATE_LIMIT            392      // Q15(  0.01196) =   +7.51651 rad/s       =   +7.51651 rad/s       + 0.0000%
+/* Active braking: rise of the DC link voltage above its value before the stop
+ * at which the deceleration rate starts to be reduced */
+#define MCAF_BRAKING_VDC_DERATE_RISE           230      // Q15(  0.00702) =   +0.50046 V           =   +0.50000 V           + 0.0926%
+/* Active braking: margin below the overvoltage fault threshold
+ * at which deceleration stops */
+#define MCAF_BRAKING_VDC_DERATE_MARGIN         689      // Q15(  0.02103) =   +1.49922 V           =   +1.50000 V           - 0.0520%
+/* Active braking: speed below which the motor terminals are shorted;
+ * the short-circuit current at this speed is about the rated motor current */
+#define MCAF_BRAKING_SHORT_SPEED              2295      // Q15(  0.07004) =  +44.00607 rad/s       =  +44.00000 rad/s       + 0.0138%
+/* Active braking: time the short-circuit current must stay below
+ * MCAF_STOP_DETECT_CURRENT_THRESHOLD before the short is released */
+#define MCAF_BRAKING_SHORT_QUIET_TIME          200      // Q0(200.00000)  =  +10.00000 ms          =  +10.00000 ms          + 0.0000%
+/* Active braking: maximum duration of each braking phase before coasting */
+#define MCAF_BRAKING_TIMEOUT                 20000      // Q0(20000.00000) =   +1.00000 s           =   +1.00000 s           + 0.0000%
+
 #define VELOCITY_SLEWRATE_LIMIT1 32000
 /* slew rate limit for velocity commands during acceleration */
 #define VELOCITY_SLEWRATE_LIMIT_ACCEL         591      // Q15(  0.01804) =  +11.33228 rad/s       =  +11.33854 rad/s       - 0.0552%
@@ -57,6 +57,13 @@ inline static bool MCAF_NegativeEdDetectEnabled(void)  { return false; }
 inline static bool MCAF_LowSpeedDetectEnabled(void)    { return true; }
 inline static bool MCAF_TorqueAngleDetectEnabled(void) { return false; }
 inline static bool MCAF_VarianceDetectEnabled(void)    { return false; }
+/** Loss-of-lock detection from the back-emf spectrum, using decimated
+ *  Goertzel filters; this reports through the same flag as
+ *  the variance detector, so at most one of the two should be enabled.
+ *  Its thresholds have not been tuned on hardware, so it is opt-in;
+ *  see fault_detect_params.h for the conditions of its latency bound.
+ */
+inline static bool MCAF_GoertzelDetectEnabled(void)    { return false; }
 
 /** Does E = V - IR - d(LI)/dt need to be calculated
  *  in the stationary frame?
@@ -104,6 +111,58 @@ inline static bool MCAF_DutyCycleFeedbackIncludesClipping(void) { return true; }
  */
 #define MCAF_TEST_HARNESS_PERTURBATION_SYMMETRIC 1
 
+/** Include on-target identification of motor parameters?
+ *  Note: MCAF_TEST_HARNESS must also be defined, since the test harness
+ *  perturbation is used to excite the motor.
+ */
+#define MCAF_INCLUDE_PARAM_ID 1
+
+/** Include the flight recorder, which keeps the most recent ISR frames
+ *  of motor #1 in persistent RAM and freezes them on selected events?
+ */
+#define MCAF_INCLUDE_FLIGHT_RECORDER 1
+
+/** Include streaming telemetry, which can take over the X2Cscope UART 
+ *  to stream selected signals continuously?
+ */
+#define MCAF_INCLUDE_TELEMETRY 1
+
+/** Service the diagnostics UART from its interrupts through ring buffers,
+ *  rather than polling it from the main loop?
+ *  This requires the UART driver to be generated in polled mode,
+ *  since MCAF then defines the UART interrupt handlers itself.
+ */
+#define MCAF_INCLUDE_BUFFERED_UART 1
+
+/** Use the diagnostics UART for the binary MCAPI remote command protocol
+ *  (see mcapi_remote.h) instead of X2Cscope?
+ *  The remote host then owns the velocity reference and start/stop,
+ *  so the startup test application never runs its tests
+ *  (which are configured through X2Cscope) and leaves the motor alone.
+ *  X2Cscope is not available to set telemetry.enable; streaming telemetry
+ *  is started with the remote TELEMETRY_START command instead.
+ */
+#define MCAF_INCLUDE_REMOTE_CONTROL 0
+
+/** Enable online adaptation of Rs and Ke to track motor temperature?
+ *  A d-axis current is injected while running so that Rs is observable;
+ *  this costs copper loss and q-axis current headroom, so it is opt-in.
+ */
+inline static bool MCAF_ParamAdaptationEnabled(void) { return false; }
+
+/** Use a quadrature encoder on QEI1 for commutation and velocity?
+ *  The ATPLL remains in use until the encoder is aligned (see qei_params.h).
+ *  This also enables position control through MCAPI.
+ */
+inline static bool MCAF_EncoderEnabled(void) { return false; }
+
+/** With an encoder, hand commutation over to the ATPLL above a velocity
+ *  threshold? The encoder is then used at standstill and low velocity,
+ *  and as a plausibility check of the ATPLL above the threshold.
+ *  Requires MCAF_EncoderEnabled().
+ */
+inline static bool MCAF_HybridCommutationEnabled(void) { return false; }
+
 /** Include triggered average example implementation?
  *  Note: MCAF_TEST_HARNESS must also be defined to enable triggered averaging.
  */
@@ -134,6 +193,25 @@ inline static bool MCAF_StoppingClosedLoopCurrent(void) { return false; }
  */
 inline static bool MCAF_StoppingClosedLoopVelocity(void) { return false; }
 
+/** Does the STOPPING state (transition towards zero-speed) brake actively
+ *  when closed-loop current is not used for stopping?
+ *  If so, and the motor is under closed-loop velocity control when stopping
+ *  begins, velocity is ramped down to a low speed while returning energy
+ *  to the DC link, at a deceleration rate reduced as the DC link voltage rises.
+ *  The motor terminals are then shorted by the lower transistors until
+ *  the braking current has decayed, and the motor coasts for the remainder.
+ *  Otherwise, the motor coasts as soon as the STOPPING state is entered.
+ *  This changes the stop behavior of the drive, so it is opt-in.
+ */
+inline static bool MCAF_StoppingActiveBraking(void) { return false; }
+
+/** Number of motor instances serviced by this application.
+ *  The control code reaches the peripherals of each instance through
+ *  halMotorMap[]; this board provides the PWM generators, current-sense
+ *  channels and motor parameters of one motor only, so this must be 1.
+ */
+#define MCAF_MOTOR_COUNT 1
+
 #ifdef __cplusplus
 }
 #endif
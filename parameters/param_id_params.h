@@ -0,0 +1,115 @@
+/* 
+ * param_id_params.h
+ * 
+ * parameters for on-target motor parameter identification
+ *
+ * Component: test harness
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+
+#ifndef __PARAM_ID_PARAMS_H
+#define __PARAM_ID_PARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Amplitude of the square-wave perturbation of the d-axis current command */
+#define MCAF_PARAMID_CURRENT_AMPLITUDE_D      752      // Q15(  0.02295) =   +1.00059 A           =   +1.00000 A           + 0.0586%
+/* Amplitude of the square-wave perturbation of the q-axis current command */
+#define MCAF_PARAMID_CURRENT_AMPLITUDE_Q      752      // Q15(  0.02295) =   +1.00059 A           =   +1.00000 A           + 0.0586%
+/* Duration of each half-cycle of the perturbation */
+#define MCAF_PARAMID_HALFPERIOD               200      // Q0(200.00000)  =  +10.00000 ms          =  +10.00000 ms          + 0.0000%
+
+/* Capture one sample every N control cycles between perturbation edges */
+#define MCAF_PARAMID_DECIMATION                10      // Q0( 10.00000)  = +500.00000 us          = +500.00000 us          + 0.0000%
+/* Change in current per control cycle above which every sample is captured */
+#define MCAF_PARAMID_EDGE_THRESHOLD            94      // Q15(  0.00287) = +125.07324 mA          = +125.00000 mA          + 0.0586%
+/* Number of samples processed before the estimate is accepted */
+#define MCAF_PARAMID_SAMPLE_COUNT            6000      // Q0(6000.00000) = +6000.00000 counts    = +6000.00000 counts    + 0.0000%
+/* Minimum velocity magnitude for identification; the back-emf must be observable */
+#define MCAF_PARAMID_MIN_VELOCITY            2731      // Q15(  0.08334) = +500.06104 RPM         = +500.00000 RPM         + 0.0122%
+
+/* Locked-rotor test: constant d-axis voltage, keeps the rotor aligned with the d-axis */
+#define MCAF_PARAMID_LOCKED_VOLTAGE_OFFSET    524      // Q15(  0.01599) =   +1.14017 V           =   +1.14000 V           + 0.0152%
+/* Locked-rotor test: amplitude of the square-wave d-axis voltage perturbation */
+#define MCAF_PARAMID_LOCKED_VOLTAGE_AMPLITUDE 262      // Q15(  0.00800) = +570.08667 mV          = +570.00000 mV          + 0.0152%
+/* Default current-loop crossover frequency for autotuning */
+#define MCAF_PARAMID_CURRENT_LOOP_BANDWIDTH  2068      // Q0(2068.00000) =   +2.06800 krad/s      =   +2.06800 krad/s      + 0.0000%
+/* Default current-loop phase margin for autotuning */
+#define MCAF_PARAMID_CURRENT_LOOP_PHASE_MARGIN 80      // Q0( 80.00000)  =  +80.00000 deg         =  +80.00000 deg         + 0.0000%
+/* Delay in the current loop, in control cycles: computation plus PWM update */
+#define MCAF_PARAMID_CURRENT_LOOP_DELAY      1.5f
+
+/* Velocity-loop test: amplitude of the relay q-axis current perturbation */
+#define MCAF_PARAMID_TORQUE_AMPLITUDE         376      // Q15(  0.01147) = +500.29297 mA          = +500.00000 mA          + 0.0586%
+/* Velocity-loop test: relay switches when the velocity error exceeds this band */
+#define MCAF_PARAMID_RELAY_BAND               546      // Q15(  0.01666) =  +99.97559 RPM         = +100.00000 RPM         - 0.0244%
+/* Velocity-loop test: maximum time between relay switches */
+#define MCAF_PARAMID_RELAY_TIMEOUT           2000      // Q0(2000.00000) =   +1.00000 s           =   +1.00000 s           + 0.0000%
+/* Velocity-loop test: number of decimated samples per velocity difference */
+#define MCAF_PARAMID_VELOCITY_WINDOW           20      // Q0( 20.00000)  =  +10.00000 ms          =  +10.00000 ms          + 0.0000%
+/* Default velocity-loop crossover frequency for autotuning */
+#define MCAF_PARAMID_VELOCITY_LOOP_BANDWIDTH   64      // Q0( 64.00000)  =  +64.00000 rad/s       =  +64.00000 rad/s       + 0.0000%
+/* Default velocity-loop phase margin for autotuning */
+#define MCAF_PARAMID_VELOCITY_LOOP_PHASE_MARGIN 65     // Q0( 65.00000)  =  +65.00000 deg         =  +65.00000 deg         + 0.0000%
+/* Phase lag at the velocity-loop crossover frequency from the current loop and velocity filtering, degrees */
+#define MCAF_PARAMID_VELOCITY_LOOP_LAG       10.0f
+/* Fraction of the maximum current command available for acceleration, used for slew rate limits */
+#define MCAF_PARAMID_SLEW_RATE_CURRENT_MARGIN 0.5f
+/* Initial value of the diagonal of the RLS covariance matrix for the velocity-loop test,
+ * which starts without a prior estimate */
+#define MCAF_PARAMID_VELOCITY_INITIAL_COVARIANCE 1.0e6f
+
+/* RLS forgetting factor */
+#define MCAF_PARAMID_FORGETTING_FACTOR     0.9995f
+/* Initial value of the diagonal of the RLS covariance matrix */
+#define MCAF_PARAMID_INITIAL_COVARIANCE    1000.0f
+
+/* Plausibility bounds, as a ratio of each estimate to its nominal value in motor_params.h */
+#define MCAF_PARAMID_BOUND_RATIO_MIN          0.25f
+#define MCAF_PARAMID_BOUND_RATIO_MAX          4.0f
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_ID_PARAMS_H */
@@ -0,0 +1,102 @@
+/* 
+ * qei_params.h
+ * 
+ * parameters for the quadrature encoder estimator and hybrid commutation
+ *
+ * Component: commutation
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __QEI_PARAMS_H
+#define __QEI_PARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Encoder counts per mechanical revolution (4 x 250 lines) */
+#define MCAF_QEI_COUNTS_PER_REV              1000      // Q0(1000.00000) = +1000.00000 counts     = +1000.00000 counts     + 0.0000%
+/* Electrical angle per encoder count, for 2 pole pairs */
+#define MCAF_QEI_ANGLE_PER_COUNT            33554      // Q8(131.07031) =  +12.56621 mrad        =  +12.56637 mrad        - 0.0013%
+
+/* Is the encoder index connected to QEI1? */
+#define MCAF_QEI_INDEX_PRESENT                  0
+/* Is MCAF_QEI_INDEX_ANGLE known for this motor and encoder? If so,
+ * the first index pulse aligns the encoder without an align step.
+ * To calibrate it, start the motor once with this set to 0 and read
+ * estimator.qei.thetaOffset after the first index pulse. */
+#define MCAF_QEI_INDEX_CALIBRATED               0
+/* Electrical angle of the rotor d-axis at the index pulse */
+#define MCAF_QEI_INDEX_ANGLE                    0      // Q15(  0.00000) =   +0.00000 rad         =   +0.00000 rad         + 0.0000%
+/* Largest count error at an index pulse that is corrected without being reported */
+#define MCAF_QEI_INDEX_TOLERANCE                2      // Q0(  2.00000)  =   +2.00000 counts      =   +2.00000 counts      + 0.0000%
+
+/* QEI interval timer prescaler (QEI1CONbits.INTDIV): 1:32 */
+#define MCAF_QEI_INTERVAL_TIMER_PRESCALE        5
+/* M/T velocity measurement window */
+#define MCAF_QEI_MT_WINDOW                     20      // Q0( 20.00000)  =   +1.00000 ms          =   +1.00000 ms          + 0.0000%
+/* M/T velocity measurement windows per second; with the interval timer
+ * frequency (FCY and MCAF_QEI_INTERVAL_TIMER_PRESCALE), this sets the
+ * window length in interval timer ticks */
+#define MCAF_QEI_MT_WINDOW_FREQUENCY         1000      // Q0(1000.00000) =   +1.00000 kHz         =   +1.00000 kHz         + 0.0000%
+/* Windows without a count after which the velocity is zero
+ * (limited to 65535 interval timer ticks) */
+#define MCAF_QEI_MT_TIMEOUT_WINDOWS            20      // Q0( 20.00000)  =  +20.00000 ms          =  +20.00000 ms          + 0.0000%
+/* Velocity of one count per M/T window */
+#define MCAF_QEI_MT_VELOCITY_PER_WINDOW     83886L     // Q8(327.67969) =   +6.28318 rad/s       =   +6.28319 rad/s       - 0.0001%
+
+/* Hybrid commutation (see MCAF_HybridCommutationEnabled()):
+ * the commutation angle is crossfaded from the encoder to the ATPLL
+ * as the velocity rises from MCAF_HYBRID_VELOCITY_LOW to MCAF_HYBRID_VELOCITY_HIGH. */
+#define MCAF_HYBRID_VELOCITY_LOW             5461      // Q15(  0.16666) = +999.93896 RPM         =   +1.00000 kRPM        - 0.0061%
+#define MCAF_HYBRID_VELOCITY_HIGH            8192      // Q15(  0.25000) =   +1.50000 kRPM        =   +1.50000 kRPM        + 0.0000%
+/* Crossfade gain = 1/(MCAF_HYBRID_VELOCITY_HIGH - MCAF_HYBRID_VELOCITY_LOW), rounded up */
+#define MCAF_HYBRID_CROSSFADE_GAIN          12287      // Q10( 11.99902) =  +11.99902             =  +11.99817             + 0.0071%
+#define MCAF_HYBRID_CROSSFADE_GAIN_Q           10
+/* Largest angle difference between the ATPLL and the encoder that is plausible */
+#define MCAF_HYBRID_ANGLE_TOLERANCE          5461      // Q15(  0.16666) = +523.56682 mrad        = +523.59878 mrad        - 0.0061%
+/* Time that the angle difference must exceed the tolerance to be reported */
+#define MCAF_HYBRID_MISMATCH_TIME            2000      // Q0(2000.00000) = +100.00000 ms          = +100.00000 ms          + 0.0000%
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __QEI_PARAMS_H */
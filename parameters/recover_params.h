@@ -51,8 +51,15 @@
 extern "C" {
 #endif
 
-/* Ticks - please note that i have not calculated this value, it is just a guess so far */
-#define MCAF_RECOVERY_COASTDOWN_TIME 50000 
+/* Delay between the end of stopping and the first retry after a stall */
+#define MCAF_RECOVERY_FIRST_RETRY_TIME        400      // Q0(400.00000)  =  +20.00000 ms          =  +20.00000 ms          + 0.0000%
+/* Backoff: each later retry waits 2^N times as long as the one before it */
+#define MCAF_RECOVERY_BACKOFF_SHIFT             2
+/* Maximum delay before a retry; the rotor has coasted down by then */
+#define MCAF_RECOVERY_COASTDOWN_TIME        50000      // Q0(50000.00000) =   +2.50000 s           =   +2.50000 s           + 0.0000%
+/* Time running without a stall after a retry, after which the retry delay
+ * and the number of re-trials are restored */
+#define MCAF_RECOVERY_STABLE_RUN_TIME       40000      // Q0(40000.00000) =   +2.00000 s           =   +2.00000 s           + 0.0000%
 
 /* Number of recovery re-trials */
 #define MCAF_RECOVERY_STARTUP_ATTEMPTS          3      // Q0(  3.00000)  =   +3.00000 counts      =   +3.00000 counts      + 0.0000%
@@ -159,6 +159,19 @@ extern "C" {
 #define STARTUP_THETA_ERROR_CONVERGE_RATE       2330      // Q24(  0.00014) =  +17.45203 rad/s       =  +17.45329 rad/s       - 0.0072%
 #define STARTUP_THETA_ERROR_CONVERGE_RATE_Q         24
 
+/* --- Parameters for catching a turning rotor, for restarts after a stall --- */
+/* Time with zero current for the estimator to measure the velocity.
+ * The ATPLL runs without a velocity feedforward term during this time, and
+ * its lock time is inversely proportional to the velocity: from the worst
+ * initial angle it settles within 5% in 37 ms at MCAF_STARTUP_CATCH_VELOCITY
+ * (host simulation of atpll.c with ideal back-EMF). This time is twice that;
+ * scale it with any change to the ATPLL gains or to the catch velocity,
+ * and confirm it on the motor before relying on quick retries. */
+#define MCAF_STARTUP_CATCH_TIME              1500      // Q0(1500.00000) =  +75.00000 ms          =  +75.00000 ms          + 0.0000%
+/* Velocity above which startup completes at once (flying restart);
+ * below it, the rotor is aligned and accelerated in open loop */
+#define MCAF_STARTUP_CATCH_VELOCITY          4096      // Q15(  0.12500) = +750.00000 RPM         = +750.00000 RPM         + 0.0000%
+
 /* --- Parameters for reference frame alignment method for startup --- */
 /* Alignment threshold; closed-loop commutation proceeds when open-loop
  * frequency and estimator frequency converge within this threshold
@@ -53,8 +53,10 @@
 void MCAF_RecoveryInit(MCAF_RECOVERY_DATA_T *precovery)
 {
     /* initialize the configuration structure */
+    precovery->time1stStaticRecovery = MCAF_RECOVERY_FIRST_RETRY_TIME;
+    precovery->retryDelayMax = MCAF_RECOVERY_COASTDOWN_TIME;
+    precovery->stableRunTime = MCAF_RECOVERY_STABLE_RUN_TIME;
     MCAF_RecoveryReset(precovery);
-    precovery->time1stStaticRecovery = MCAF_RECOVERY_COASTDOWN_TIME;
 }
 
 void MCAF_RecoveryReset(MCAF_RECOVERY_DATA_T *precovery)
@@ -62,6 +64,7 @@ void MCAF_RecoveryReset(MCAF_RECOVERY_DATA_T *precovery)
     /* initialize the configuration structure */
     precovery->countdownTrials =  MCAF_RECOVERY_STARTUP_ATTEMPTS;
     precovery->recoveryTimer = 0;
+    precovery->retryDelay = precovery->time1stStaticRecovery;
     precovery->stateMachine.state = MCAF_RECOVERY_FSM_NO_ERROR;
     precovery->stateMachine.inputs = 0;
     precovery->stateMachine.outputs = 0;
@@ -78,6 +81,18 @@ void MCAF_Recovery(MCAF_RECOVERY_DATA_T *precovery)
             {
                 nextState = MCAF_RECOVERY_FSM_STOP_PENDING;
                 precovery->stateMachine.outputs |= MCAF_RECOVERY_FSMO_STOP_MOTOR;
+                precovery->stateMachine.outputs &= ~MCAF_RECOVERY_FSMO_RETRY;
+            }
+            else if (precovery->countdownTrials < MCAF_RECOVERY_STARTUP_ATTEMPTS)
+            {
+                /* Running after a retry: once it has been stable long enough,
+                 * the recovery is complete and the backoff starts over. */
+                if (++precovery->recoveryTimer >= precovery->stableRunTime)
+                {
+                    precovery->countdownTrials = MCAF_RECOVERY_STARTUP_ATTEMPTS;
+                    precovery->retryDelay = precovery->time1stStaticRecovery;
+                    precovery->recoveryTimer = 0;
+                }
             }
             break;
         case MCAF_RECOVERY_FSM_STOP_PENDING:
@@ -98,11 +113,19 @@ void MCAF_Recovery(MCAF_RECOVERY_DATA_T *precovery)
             }
             break;
         case MCAF_RECOVERY_FSM_RESTART_PENDING:
-            if (++precovery->recoveryTimer >= precovery->time1stStaticRecovery)
+            if (++precovery->recoveryTimer >= precovery->retryDelay)
             {
                 /* Allow motor to restart */
                 nextState = MCAF_RECOVERY_FSM_NO_ERROR;
+                precovery->recoveryTimer = 0;
                 precovery->stateMachine.outputs &= ~MCAF_RECOVERY_FSMO_STOP_MOTOR;
+                precovery->stateMachine.outputs |= MCAF_RECOVERY_FSMO_RETRY;
+                
+                /* Back off exponentially for the next retry */
+                const uint16_t delay = precovery->retryDelay;
+                precovery->retryDelay = (delay > (precovery->retryDelayMax >> MCAF_RECOVERY_BACKOFF_SHIFT))
+                                      ? precovery->retryDelayMax
+                                      : (delay << MCAF_RECOVERY_BACKOFF_SHIFT);
             }
             break;
         case MCAF_RECOVERY_FSM_RETRIES_EXCEEDED:
@@ -80,7 +80,8 @@ typedef enum tagMCAF_RECOVERY_FSM_INPUTS
 typedef enum tagMCAF_RECOVERY_FSM_OUTPUTS
 {
     MCAF_RECOVERY_FSMO_STOP_MOTOR    = 1,     /** stop motor */
-    MCAF_RECOVERY_FSMO_RETRY_FAULT   = 2      /** failure: too many retries */
+    MCAF_RECOVERY_FSMO_RETRY_FAULT   = 2,     /** failure: too many retries */
+    MCAF_RECOVERY_FSMO_RETRY         = 4      /** motor restarting after a stall; the rotor may still be turning */
 } MCAF_RECOVERY_FSM_OUTPUTS;
 
 
@@ -91,7 +92,10 @@ typedef struct tagMCAF_RECOVERY_DATA
 {
     int16_t countdownTrials;         /** number of unsuccessful recovery processes so far */
     uint16_t recoveryTimer;  /** timer counting elapsed time from recovery processing start */
-    uint16_t time1stStaticRecovery;   /** time necessary for fault treatment */
+    uint16_t time1stStaticRecovery;   /** delay before the first retry */
+    uint16_t retryDelayMax;  /** upper limit of the retry delay */
+    uint16_t retryDelay;     /** delay before the next retry, increased exponentially after each retry */
+    uint16_t stableRunTime;  /** time running without a stall after which a recovery is complete */
     
     struct tagSTATEMACHINE {
         MCAF_RECOVERY_FSM_STATE state;  /** state machine state */
@@ -123,6 +127,16 @@ void MCAF_RecoveryReset(MCAF_RECOVERY_DATA_T *precovery);
  * This function handles the recovery process, executing the recovery tasks, such
  * as coasting down the motor in the event of stall
  *
+ * The first retry follows the stop after time1stStaticRecovery, which is
+ * short, so that transient stalls recover quickly; the delay is multiplied
+ * by 2^MCAF_RECOVERY_BACKOFF_SHIFT for each further retry, up to
+ * retryDelayMax. The motor may still be turning when it is allowed to
+ * restart; the startup then chooses between a flying restart and a full
+ * startup from the measured velocity (see MCAF_StartupRequestCatch()).
+ * Once the motor has run for stableRunTime after a retry without another
+ * stall, the retry delay and the number of re-trials are restored, so that
+ * a later unrelated stall starts again with the short first retry.
+ *
  * Summary : Runs the recovery task
  *
  * @param precovery This parameter is pointer to MCAF_RECOVERY_DATA_T structure
@@ -151,6 +165,21 @@ static inline bool MCAF_RecoveryTestFlag(const MCAF_RECOVERY_DATA_T *precovery,
     return (precovery->stateMachine.outputs & flag) != 0;
 }
 
+/**
+ * Tests and clears the retry flag. This is set when the motor is allowed
+ * to restart after a stall, and should be tested once on startup,
+ * to determine whether the startup has to allow for a turning rotor.
+ *
+ * @param precovery state variable structure
+ * @return whether the motor is restarting after a stall
+ */
+static inline bool MCAF_RecoveryTestAndClearRetryFlag(MCAF_RECOVERY_DATA_T *precovery)
+{
+    const bool retry = MCAF_RecoveryTestFlag(precovery, MCAF_RECOVERY_FSMO_RETRY);
+    precovery->stateMachine.outputs &= ~MCAF_RECOVERY_FSMO_RETRY;
+    return retry;
+}
+
 /**
  * This function checks whether there was any failure reported in recovery
  *
@@ -257,8 +257,22 @@ inline static void writeAccB32(int32_t input)
 #endif
 }
 
-void MCAF_ControllerPIUpdate(int16_t in_Ref, int16_t in_Meas, 
-        MCAF_PISTATE_T *state, MCAF_SAT_STATE_T sat_State, int16_t *out,
+/**
+ * Computes one PI controller step.
+ * CORCON must already be configured by HAL_CORCON_Initialize();
+ * the caller is responsible for saving and restoring it.
+ * See MCAF_ControllerPIUpdate() and MCAF_PI_ANTIWINDUP_MODE
+ * for the anti-windup conditions.
+ * 
+ * @param in_Ref reference input
+ * @param in_Meas measured input
+ * @param state PI controller state variables
+ * @param sat_State status of saturation state to support anti-windup 
+ * @param direction sign of command, >=0 for positive, <0 for negative
+ * @return saturated output of the PI controller
+ */
+inline static int16_t controllerPIStep(int16_t in_Ref, int16_t in_Meas, 
+        MCAF_PISTATE_T *state, MCAF_SAT_STATE_T sat_State,
         int16_t direction)
 {
     int16_t error;
@@ -267,10 +281,6 @@ void MCAF_ControllerPIUpdate(int16_t in_Ref, int16_t in_Meas,
     int16_t out_nonsat;
     /* saturated output */
     int16_t out_sat;
-    uint16_t saveCorcon = HAL_CORCON_RegisterValue_Get();
-    
-    /* Init CORCON register */
-    HAL_CORCON_Initialize();
     
     /* Calculate error */
     error = saturatedSubtract(in_Ref, in_Meas);
@@ -287,25 +297,94 @@ void MCAF_ControllerPIUpdate(int16_t in_Ref, int16_t in_Meas,
     /* Limit the output */
     out_sat = UTIL_LimitS16(out_nonsat, state->outMin, state->outMax);
     
-    *out = out_sat;
-    /* Calculate integrator term and add it to previous value if not in saturation state */
-    if ((sat_State == MCAF_SAT_NONE)
-         || (UTIL_DirectedLessThanEqual(in_Ref, in_Meas, direction)))
-    {    
-        /* Calculate (error * Ki) and store in A */
-        a_Reg = __builtin_mpy(error, state->ki, 0, 0, 0, 0, 0, 0);
-        a_Reg = __builtin_sftac(a_Reg, -state->nki);
-        
-        /* Calculate (excess * Kc), subtract from (error * Ki) and store in A */
-        error = out_nonsat - out_sat;
-        a_Reg = __builtin_msc(a_Reg, error, state->kc,0,0,0,0,0,0,0,0);
-        
-        /* Add (error * Ki)-(excess * Kc) to the integrator value in B */
-        a_Reg = __builtin_addab(a_Reg,b_Reg);
-        
-        state->integrator = readAccA32();
+    /* Is integration of the error allowed by the saturation state? */
+    const bool integrationAllowed = (sat_State == MCAF_SAT_NONE)
+         || (UTIL_DirectedLessThanEqual(in_Ref, in_Meas, direction));
+    const int16_t excess = out_nonsat - out_sat;
+    
+    switch (state->antiWindup)
+    {
+        case MCAF_PI_ANTIWINDUP_BACK_CALCULATION:
+            /* Calculate (error * Ki), or zero if inhibited, and store in A */
+            if (integrationAllowed)
+            {
+                a_Reg = __builtin_mpy(error, state->ki, 0, 0, 0, 0, 0, 0);
+                a_Reg = __builtin_sftac(a_Reg, -state->nki);
+            }
+            else
+            {
+                a_Reg = __builtin_clr();
+            }
+            
+            /* Subtract (excess * Kc) in all cases, so the integrator tracks the limit */
+            a_Reg = __builtin_msc(a_Reg, excess, state->kc,0,0,0,0,0,0,0,0);
+            a_Reg = __builtin_addab(a_Reg,b_Reg);
+            state->integrator = readAccA32();
+            break;
+            
+        case MCAF_PI_ANTIWINDUP_CONDITIONAL:
+        {
+            /* A clamped output may only integrate errors that pull it back in */
+            const bool unwinding = (excess > 0) ? (error < 0) : (error > 0);
+            if (integrationAllowed && ((excess == 0) || unwinding))
+            {
+                a_Reg = __builtin_mpy(error, state->ki, 0, 0, 0, 0, 0, 0);
+                a_Reg = __builtin_sftac(a_Reg, -state->nki);
+                a_Reg = __builtin_addab(a_Reg,b_Reg);
+                state->integrator = readAccA32();
+            }
+            break;
+        }
+            
+        default:
+            /* Calculate integrator term and add it to previous value if not in saturation state */
+            if (integrationAllowed)
+            {    
+                /* Calculate (error * Ki) and store in A */
+                a_Reg = __builtin_mpy(error, state->ki, 0, 0, 0, 0, 0, 0);
+                a_Reg = __builtin_sftac(a_Reg, -state->nki);
+
+                /* Calculate (excess * Kc), subtract from (error * Ki) and store in A */
+                a_Reg = __builtin_msc(a_Reg, excess, state->kc,0,0,0,0,0,0,0,0);
+
+                /* Add (error * Ki)-(excess * Kc) to the integrator value in B */
+                a_Reg = __builtin_addab(a_Reg,b_Reg);
+
+                state->integrator = readAccA32();
+            }
+            break;
     }
+    
+    return out_sat;
+}
+
+void MCAF_ControllerPIUpdate(int16_t in_Ref, int16_t in_Meas, 
+        MCAF_PISTATE_T *state, MCAF_SAT_STATE_T sat_State, int16_t *out,
+        int16_t direction)
+{
+    uint16_t saveCorcon = HAL_CORCON_RegisterValue_Get();
+    
+    /* Init CORCON register */
+    HAL_CORCON_Initialize();
+    
+    *out = controllerPIStep(in_Ref, in_Meas, state, sat_State, direction);
 
     HAL_CORCON_RegisterValue_Set(saveCorcon);
+}
+
+void MCAF_ControllerPIUpdateDQ(const MC_DQ_T *pref, const MC_DQ_T *pmeas,
+        MCAF_PISTATE_T *pdState, MCAF_PISTATE_T *pqState, MC_DQ_T *pout)
+{
+    uint16_t saveCorcon = HAL_CORCON_RegisterValue_Get();
     
-}
\ No newline at end of file
+    HAL_CORCON_Initialize();
+    
+    /* 
+     * With MCAF_SAT_NONE the saturation-state test is resolved at compile
+     * time; only the anti-windup mode of each axis is checked at run time.
+     */
+    pout->d = controllerPIStep(pref->d, pmeas->d, pdState, MCAF_SAT_NONE, 0);
+    pout->q = controllerPIStep(pref->q, pmeas->q, pqState, MCAF_SAT_NONE, 0);
+
+    HAL_CORCON_RegisterValue_Set(saveCorcon);
+}
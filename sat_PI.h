@@ -103,6 +103,11 @@ inline static MCAF_SAT_STATE_T MCAF_SatMask(MCAF_SAT_STATE_T status, MCAF_SAT_ST
  *      inReference <= inMeasure when direction >= 0
  *   or inReference >= inMeasure when direction < 0.
  * 
+ * state->antiWindup refines this: in back-calculation mode the output
+ * excess is still fed back when the error term is inhibited, and in
+ * conditional-integration mode the integrator is also held while the
+ * output is clamped, unless the error would reduce the excess.
+ * 
  * Summary : Modified PI controller
  * 
  * @param inReference Reference Input
@@ -116,6 +121,26 @@ void MCAF_ControllerPIUpdate(int16_t inReference, int16_t inMeasure,
         MCAF_PISTATE_T *state, MCAF_SAT_STATE_T sat_State, int16_t *out,
         int16_t direction);
 
+/**
+ * Computes the D-axis and Q-axis current PI corrections together.
+ * 
+ * Equivalent to calling MCAF_ControllerPIUpdate() for each axis with
+ * sat_State = MCAF_SAT_NONE and direction = 0, but the DSP engine is
+ * configured and CORCON saved/restored only once for both axes.
+ * Both output limits must be set before calling; this cannot be used
+ * when the Q-axis limit depends on the D-axis output.
+ * 
+ * Summary : Dual-axis PI controller
+ * 
+ * @param pref dq reference inputs
+ * @param pmeas dq measured inputs
+ * @param pdState D-axis PI controller state variables
+ * @param pqState Q-axis PI controller state variables
+ * @param pout dq outputs where the result is stored
+ */
+void MCAF_ControllerPIUpdateDQ(const MC_DQ_T *pref, const MC_DQ_T *pmeas,
+        MCAF_PISTATE_T *pdState, MCAF_PISTATE_T *pqState, MC_DQ_T *pout);
+
 /**
  * Invert the integrator value.
  * This is required in some estimators.
@@ -131,4 +156,4 @@ inline static void MCAF_ControllerPIIntegratorInvert(MCAF_PISTATE_T *state)
 }
 #endif
 
-#endif /* SAT_PI_H */
\ No newline at end of file
+#endif /* SAT_PI_H */
\ No newline at end of file
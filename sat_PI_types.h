@@ -93,6 +93,23 @@ typedef struct tagsatdetect
     MCAF_SAT_T currentSat;  /** Parameters related to current saturation */
 } MCAF_SAT_DETECT_T;
 
+/**
+ * Anti-windup method of a PI controller
+ */
+typedef enum tagPIAntiWindupMode
+{
+    /** Integrate unless the saturation state reports saturation in the
+     *  direction of the error; the output excess is fed back through kc */
+    MCAF_PI_ANTIWINDUP_SAT_STATE = 0,
+    /** Back-calculation: the output excess is always fed back through kc
+     *  (tracking gain), even while the error term is inhibited by the
+     *  saturation state, so the integrator unwinds at a defined rate */
+    MCAF_PI_ANTIWINDUP_BACK_CALCULATION = 1,
+    /** Conditional integration: integrate only while the output is within
+     *  its limits, or when the error drives it back inside them; kc unused */
+    MCAF_PI_ANTIWINDUP_CONDITIONAL = 2
+} MCAF_PI_ANTIWINDUP_MODE;
+
 /**
  * State variables related to PI controller 
  */
@@ -106,6 +123,7 @@ typedef struct
     int16_t nki;        /** Normalizing term for integral coefficient */
     int16_t outMax;     /** Maximum output limit */
     int16_t outMin;     /** Minimum output limit */
+    MCAF_PI_ANTIWINDUP_MODE antiWindup; /** Anti-windup method */
 } MCAF_PISTATE_T;
 
 #ifdef __cplusplus
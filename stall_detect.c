@@ -51,6 +51,12 @@
 #include "util.h"
 #include "filter_types.h"
 #include "filter.h"
+#include "motor_control.h"
+#include "motor_control_function_mapping.h"
+
+#if MCAF_GOERTZEL_DETECT_DECIMATION < (MCAF_GOERTZEL_DETECT_HARMONICS + 2)
+#error "Goertzel detector needs an ISR per harmonic and one more between samples"
+#endif
 
 /**
  * Initializes parameters related to variance detector
@@ -82,6 +88,36 @@ void MCAF_VarianceDetectx16(MCAF_VARIANCE_DETECT_T *pvariancex16,
 */
 bool MCAF_VarianceDetectx16PostDecimation(MCAF_VARIANCE_DETECT_T *pvariancex16);
 
+/**
+ * Initializes parameters related to Goertzel loss of lock detector
+ *
+ * @param pgoertzel Goertzel detect state
+ */
+void MCAF_GoertzelDetectInit(MCAF_GOERTZEL_DETECT_T *pgoertzel);
+
+/**
+ * Computes the energy of Ed and Eq at the electrical frequency and its
+ * harmonics, and indicates loss of lock when it exceeds a fraction of Es^2
+ * for several consecutive blocks.
+ *
+ * Each call does at most one of the following, depending on the ISR count
+ * within the decimation period, so the cost per ISR is bounded:
+ * - one sample: two Goertzel updates per harmonic
+ * - one harmonic of a completed block: energy of Ed and Eq
+ * - end of a completed block: threshold comparison, 
+ *   and sine/cosine of each harmonic for the next block
+ * 
+ * Detection latency is at most MCAF_GOERTZEL_DETECT_LATENCY once every
+ * block exceeds the threshold, provided the electrical frequency stays
+ * above the velocity threshold (see fault_detect_params.h).
+ *
+ * @param pgoertzel Goertzel detect state
+ * @param pinputs input signals including Ed, Eq and electrical frequency
+ * @return whether harmonic energy in Es is higher than the threshold (true = detected)
+ */
+bool MCAF_GoertzelDetect(MCAF_GOERTZEL_DETECT_T *pgoertzel,
+        const MCAF_STALL_DETECT_INPUT_T *pinputs);
+
 /**
  * Initializes parameters related to torque angle based stall detection
  *
@@ -168,6 +204,7 @@ void MCAF_StallDetectInit(MCAF_STALL_DETECT_T *pstallDetect)
 {
 
     MCAF_VarianceDetectx16Init(&pstallDetect->varianceDetect);
+    MCAF_GoertzelDetectInit(&pstallDetect->goertzelDetect);
     MCAF_OvercurrentDetectInit(&pstallDetect->overcurrentDetect);
     MCAF_LowSpeedDetectInit(&pstallDetect->lowSpeedDetect);
     MCAF_NegativeEdDetectInit(&pstallDetect->negativeEdDetect);
@@ -214,6 +251,25 @@ void MCAF_VarianceDetectx16Init(MCAF_VARIANCE_DETECT_T *pvariancex16)
     MCAF_VarianceDetectx16Reset(pvariancex16);
 }
 
+void MCAF_GoertzelDetectReset(MCAF_GOERTZEL_DETECT_T *pgoertzel)
+{
+    pgoertzel->phase = 0;
+    pgoertzel->sampleCount = 0;
+    pgoertzel->running = false;
+    pgoertzel->meanValid = false;
+    pgoertzel->blockCount = 0;
+    pgoertzel->detected = false;
+}
+
+void MCAF_GoertzelDetectInit(MCAF_GOERTZEL_DETECT_T *pgoertzel)
+{
+    pgoertzel->velocityThreshold = MCAF_GOERTZEL_DETECT_VELOCITY_THRESHOLD;
+    pgoertzel->ratioThreshold = MCAF_GOERTZEL_DETECT_RATIO_THRESHOLD;
+    pgoertzel->blockCountThreshold = MCAF_GOERTZEL_DETECT_BLOCK_COUNT;
+    
+    MCAF_GoertzelDetectReset(pgoertzel);
+}
+
 void MCAF_OvercurrentDetectReset(MCAF_OVERCURRENT_SW_DETECT_T *povercurrent)
 {
     /* Initialize state variables for LPF */
@@ -299,6 +355,7 @@ void MCAF_LowSpeedDetectInit(MCAF_LOW_SPEED_DETECT_T *plowspeed)
 void MCAF_StallDetectReset(MCAF_STALL_DETECT_T *pstallDetect)
 {
     MCAF_VarianceDetectx16Reset(&pstallDetect->varianceDetect);
+    MCAF_GoertzelDetectReset(&pstallDetect->goertzelDetect);
     MCAF_OvercurrentDetectReset(&pstallDetect->overcurrentDetect);
     MCAF_NegativeEdDetectReset(&pstallDetect->negativeEdDetect);
     MCAF_TorqueAngleDetectReset(&pstallDetect->torqueAngleDetect);
@@ -353,9 +410,19 @@ void MCAF_StallDetect(MCAF_STALL_DETECT_T *pstallDetect, const MCAF_MOTOR_DATA *
                                    &pstallDetect->inputs);
         }
         
+        if (MCAF_GoertzelDetectEnabled())
+        {
+            updateFlags(pstallDetect,
+                        MCAF_GoertzelDetect(&pstallDetect->goertzelDetect,
+                                            &pstallDetect->inputs),
+                        MCAF_LOSS_OF_LOCK_STALL_DETECT);
+        }
+        
         if (pmotor->state == MCSM_RUNNING)
         {
-            if (MCAF_LowSpeedDetectEnabled())
+            /* An encoder measures velocity down to standstill,
+             * where position control may hold the rotor. */
+            if (MCAF_LowSpeedDetectEnabled() && !MCAF_EstimatorQeiIsActive(&pmotor->estimator))
             {
                 updateFlags(pstallDetect,
                             MCAF_LowSpeedDetect(&pstallDetect->lowSpeedDetect, pmotor->omegaElectrical),
@@ -369,6 +436,12 @@ void MCAF_StallDetect(MCAF_STALL_DETECT_T *pstallDetect, const MCAF_MOTOR_DATA *
                             MCAF_TORQUE_ANGLE_STALL_DETECT);
             }
         }
+        if (MCAF_HybridCommutationEnabled())
+        {
+            updateFlags(pstallDetect,
+                        MCAF_EstimatorHybridMismatchDetected(&pmotor->estimator.hybrid),
+                        MCAF_ENCODER_MISMATCH_STALL_DETECT);
+        }
         if (MCAF_VarianceDetectEnabled() &&
                 ++pstallDetect->decimationTimer >= pstallDetect->decimationTimerThreshold)
         {
@@ -425,6 +498,204 @@ inline bool MCAF_VarianceDetectx16PostDecimation(MCAF_VARIANCE_DETECT_T *pvarian
     return varianceDetect;
 }
 
+/**
+ * Multiplies a 32-bit value by a 16-bit value and shifts right by q,
+ * using two 16x16 multiplies.
+ * 
+ * @param x 32-bit input
+ * @param k 16-bit input
+ * @param q number of bits to shift right, at most 16
+ * @return (x*k) >> q
+ */
+inline static int32_t goertzelMulS32S16(int32_t x, int16_t k, uint16_t q)
+{
+    const int16_t xhi = (int16_t)(x >> 16);
+    const uint16_t xlo = (uint16_t)x;
+    return (UTIL_mulss(xhi, k) << (16 - q)) + (UTIL_mulsu(k, xlo) >> q);
+}
+
+/**
+ * Executes one step of a Goertzel filter: s[n] = x[n] + 2*cos(theta)*s[n-1] - s[n-2]
+ * 
+ * @param pstate filter state
+ * @param x input
+ * @param coeff 2*cos(theta), Q14
+ */
+inline static void goertzelUpdate(MCAF_GOERTZEL_STATE_T *pstate, int16_t x, int16_t coeff)
+{
+    const int32_t s = x + goertzelMulS32S16(pstate->s1, coeff, 14) - pstate->s2;
+    pstate->s2 = pstate->s1;
+    pstate->s1 = s;
+}
+
+/**
+ * Computes the squared amplitude of the input at the bin frequency,
+ * from the filter state at the end of a block.
+ * 
+ * @param pstate filter state
+ * @param pbin bin containing the filter
+ * @return squared amplitude, Q28
+ */
+inline static uint32_t goertzelEnergy(const MCAF_GOERTZEL_STATE_T *pstate,
+                                      const MCAF_GOERTZEL_BIN_T *pbin)
+{
+    /* X = s1 - s2*exp(-j*theta); a sinusoid at the bin frequency
+     * has |X| = amplitude * N/2 */
+    const int32_t re = pstate->s1 - goertzelMulS32S16(pstate->s2, pbin->cosine, 15);
+    const int32_t im = goertzelMulS32S16(pstate->s2, pbin->sine, 15);
+    const int16_t reAmplitude = UTIL_SatShrS16(re, MCAF_GOERTZEL_DETECT_BLOCK_LENGTH_Q - 1);
+    const int16_t imAmplitude = UTIL_SatShrS16(im, MCAF_GOERTZEL_DETECT_BLOCK_LENGTH_Q - 1);
+    return (uint32_t)(UTIL_mulss(reAmplitude, reAmplitude) >> 2)
+         + (uint32_t)(UTIL_mulss(imAmplitude, imAmplitude) >> 2);
+}
+
+/**
+ * Starts a new block, with the bin frequencies at the harmonics
+ * of the present electrical frequency.
+ * 
+ * @param pgoertzel Goertzel detect state
+ * @param omega electrical frequency
+ */
+static void goertzelStartBlock(MCAF_GOERTZEL_DETECT_T *pgoertzel, MCAF_U_VELOCITY_ELEC omega)
+{
+    const MCAF_U_VELOCITY_ELEC speed = UTIL_Abs16(omega);
+    pgoertzel->running = (speed >= pgoertzel->velocityThreshold);
+    if (!pgoertzel->running)
+    {
+        pgoertzel->meanValid = false;
+        pgoertzel->blockCount = 0;
+        pgoertzel->detected = false;
+        return;
+    }
+    
+    /* bin angle per sample at the electrical frequency; 32768 = pi */
+    const uint16_t theta1 = UTIL_Shr15(UTIL_mulss(speed, MCAF_GOERTZEL_DETECT_NORM_DELTAT));
+    uint32_t theta = 0;
+    for (uint16_t k = 0; k < MCAF_GOERTZEL_DETECT_HARMONICS; ++k)
+    {
+        MCAF_GOERTZEL_BIN_T *pbin = &pgoertzel->bin[k];
+        theta += theta1;
+        pbin->active = (theta <= INT16_MAX);
+        if (pbin->active)
+        {
+            MC_SINCOS_T sincos;
+            MC_CalculateSineCosine((int16_t)theta, &sincos);
+            pbin->cosine = sincos.cos;
+            pbin->sine = sincos.sin;
+        }
+        pbin->ed.s1 = 0;
+        pbin->ed.s2 = 0;
+        pbin->eq.s1 = 0;
+        pbin->eq.s2 = 0;
+    }
+    pgoertzel->sumEd = 0;
+    pgoertzel->sumEq = 0;
+    pgoertzel->harmonicEnergy = 0;
+    pgoertzel->sampleCount = 0;
+}
+
+/**
+ * Feeds one sample of Es, less the mean of the previous block,
+ * to the filters.
+ * 
+ * @param pgoertzel Goertzel detect state
+ * @param pesdq back-emf Es
+ */
+inline static void goertzelSample(MCAF_GOERTZEL_DETECT_T *pgoertzel, const MCAF_U_VOLTAGE_DQ *pesdq)
+{
+    const int16_t ed = UTIL_SatSubS16(pesdq->d, pgoertzel->esdqMean.d);
+    const int16_t eq = UTIL_SatSubS16(pesdq->q, pgoertzel->esdqMean.q);
+    for (uint16_t k = 0; k < MCAF_GOERTZEL_DETECT_HARMONICS; ++k)
+    {
+        MCAF_GOERTZEL_BIN_T *pbin = &pgoertzel->bin[k];
+        if (pbin->active)
+        {
+            goertzelUpdate(&pbin->ed, ed, pbin->cosine);
+            goertzelUpdate(&pbin->eq, eq, pbin->cosine);
+        }
+    }
+    pgoertzel->sumEd += pesdq->d;
+    pgoertzel->sumEq += pesdq->q;
+    ++pgoertzel->sampleCount;
+}
+
+/**
+ * Compares the harmonic energy of a completed block with Es^2.
+ * 
+ * @param pgoertzel Goertzel detect state
+ */
+inline static void goertzelEndBlock(MCAF_GOERTZEL_DETECT_T *pgoertzel)
+{
+    const int16_t edMean = (int16_t)(pgoertzel->sumEd >> MCAF_GOERTZEL_DETECT_BLOCK_LENGTH_Q);
+    const int16_t eqMean = (int16_t)(pgoertzel->sumEq >> MCAF_GOERTZEL_DETECT_BLOCK_LENGTH_Q);
+    
+    /* Without the mean of the previous block, the filters also
+     * saw the DC component of Es, so the block is only used for the mean. */
+    if (pgoertzel->meanValid)
+    {
+        const int32_t esSqr = (UTIL_mulss(edMean, edMean) >> 2)
+                            + (UTIL_mulss(eqMean, eqMean) >> 2);
+        if (pgoertzel->harmonicEnergy 
+            > (uint32_t)goertzelMulS32S16(esSqr, pgoertzel->ratioThreshold, 15))
+        {
+            if (pgoertzel->blockCount < pgoertzel->blockCountThreshold)
+            {
+                ++pgoertzel->blockCount;
+            }
+        }
+        else
+        {
+            pgoertzel->blockCount = 0;
+        }
+        pgoertzel->detected = (pgoertzel->blockCount >= pgoertzel->blockCountThreshold);
+    }
+    pgoertzel->esdqMean.d = edMean;
+    pgoertzel->esdqMean.q = eqMean;
+    pgoertzel->meanValid = true;
+}
+
+bool MCAF_GoertzelDetect(MCAF_GOERTZEL_DETECT_T *pgoertzel,
+        const MCAF_STALL_DETECT_INPUT_T *pinputs)
+{
+    const uint16_t phase = pgoertzel->phase;
+    const bool blockComplete = pgoertzel->running
+        && (pgoertzel->sampleCount >= MCAF_GOERTZEL_DETECT_BLOCK_LENGTH);
+    
+    if (phase == 0)
+    {
+        if (pgoertzel->running && !blockComplete)
+        {
+            goertzelSample(pgoertzel, &pinputs->esdq);
+        }
+    }
+    else if (phase <= MCAF_GOERTZEL_DETECT_HARMONICS)
+    {
+        const MCAF_GOERTZEL_BIN_T *pbin = &pgoertzel->bin[phase - 1];
+        if (blockComplete && pbin->active)
+        {
+            pgoertzel->harmonicEnergy += goertzelEnergy(&pbin->ed, pbin)
+                                       + goertzelEnergy(&pbin->eq, pbin);
+        }
+    }
+    else if (phase == MCAF_GOERTZEL_DETECT_HARMONICS + 1)
+    {
+        if (blockComplete)
+        {
+            goertzelEndBlock(pgoertzel);
+        }
+        if (blockComplete || !pgoertzel->running)
+        {
+            goertzelStartBlock(pgoertzel, pinputs->omegaElectrical);
+        }
+    }
+    
+    if (++pgoertzel->phase >= MCAF_GOERTZEL_DETECT_DECIMATION)
+    {
+        pgoertzel->phase = 0;
+    }
+    return pgoertzel->detected;
+}
+
 /**
  * Evaluate a quadratic polynomial using Horner's rule and Q15 math.
  * @param x input variable
@@ -80,6 +80,68 @@ typedef struct tagVarianceDetectx16
     uint32_t timerThreshold; 
 } MCAF_VARIANCE_DETECT_T;
 
+/** Number of harmonics of the electrical frequency in the Goertzel detector */
+#define MCAF_GOERTZEL_DETECT_HARMONICS 2
+
+/**
+ * Goertzel filter state for one signal
+ */
+typedef struct tagGoertzelState
+{
+    int32_t s1;     /** most recent filter output */
+    int32_t s2;     /** filter output before s1 */
+} MCAF_GOERTZEL_STATE_T;
+
+/**
+ * Goertzel filters for Ed and Eq at one harmonic of the electrical frequency
+ */
+typedef struct tagGoertzelBin
+{
+    /** cos(theta), Q15; this is also the filter coefficient 2*cos(theta) in Q14 */
+    int16_t cosine;
+    /** sin(theta), Q15 */
+    int16_t sine;
+    /** whether the harmonic is below the Nyquist frequency of the decimated samples */
+    bool active;
+    MCAF_GOERTZEL_STATE_T ed;   /** filter for Ed */
+    MCAF_GOERTZEL_STATE_T eq;   /** filter for Eq */
+} MCAF_GOERTZEL_BIN_T;
+
+/**
+ * State variables related to Goertzel loss of lock stall detector
+ */
+typedef struct tagGoertzelDetect
+{
+    /** filters at each harmonic, starting with the electrical frequency */
+    MCAF_GOERTZEL_BIN_T bin[MCAF_GOERTZEL_DETECT_HARMONICS];
+    /** mean Es of the previous block, removed from the filter inputs */
+    MCAF_U_VOLTAGE_DQ esdqMean;
+    /** sum of Ed over the current block */
+    int32_t sumEd;
+    /** sum of Eq over the current block */
+    int32_t sumEq;
+    /** harmonic energy of the current block, accumulated during evaluation */
+    uint32_t harmonicEnergy;
+    /** ISR count within the decimation period */
+    uint16_t phase;
+    /** number of samples in the current block */
+    uint16_t sampleCount;
+    /** whether a block is being sampled; false below the velocity threshold */
+    bool running;
+    /** whether esdqMean is valid for the current block */
+    bool meanValid;
+    /** minimum electrical velocity for detection */
+    MCAF_U_VELOCITY_ELEC velocityThreshold;
+    /** ratio of harmonic energy to Es^2 above which a block indicates loss of lock */
+    int16_t ratioThreshold;
+    /** number of consecutive blocks indicating loss of lock */
+    uint16_t blockCount;
+    /** number of consecutive blocks to trigger fault */
+    uint16_t blockCountThreshold;
+    /** whether loss of lock has been detected */
+    bool detected;
+} MCAF_GOERTZEL_DETECT_T;
+
 /**
 * State variables related to over current stall detector
 */
@@ -183,6 +245,7 @@ typedef enum
     MCAF_LOW_SPEED_STALL_DETECT = 0x04,         /** Low speed stall indicator */
     MCAF_NEGATIVE_ED_STALL_DETECT = 0x08,       /** Negative Ed stall indicator */
     MCAF_TORQUE_ANGLE_STALL_DETECT = 0x10,      /** Torque angle based stall indicator */
+    MCAF_ENCODER_MISMATCH_STALL_DETECT = 0x20,  /** ATPLL disagrees with encoder */
     
     MCAF_ALL_STALL_DETECT_METHODS_ENABLED = ~0  /** Mask for enabling all detection methods. */
 } MCAF_STALL_DETECT_FLAG;
@@ -205,6 +268,7 @@ typedef struct tagStallDetect
 {
     MCAF_STALL_DETECT_INPUT_T inputs;             /** Input signals */
     MCAF_VARIANCE_DETECT_T varianceDetect;        /** Ed and Eq variance detect */
+    MCAF_GOERTZEL_DETECT_T goertzelDetect;        /** Ed and Eq harmonic energy detect */
     MCAF_OVERCURRENT_SW_DETECT_T overcurrentDetect;  /** Overcurrent detect */
     MCAF_NEGATIVE_ED_DETECT_T negativeEdDetect;   /** Negative Ed based stall detect */
     MCAF_LOW_SPEED_DETECT_T lowSpeedDetect;       /** Low speed detect */
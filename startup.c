@@ -75,6 +75,9 @@ void MCAF_StartupTransitioningInit(MCAF_MOTOR_STARTUP_DATA *pstartup)
     pstartup->referenceFrameAlign.thetaThreshold = MCAF_STARTUP_REF_FRAME_ALIGN_THRESHOLD;
     pstartup->referenceFrameAlign.omegaOffsetMagnitude = MCAF_STARTUP_REF_FRAME_ALIGN_FREQUENCY;
     pstartup->referenceFrameAlign.shiftCount = MCAF_STARTUP_REF_FRAME_ALIGN_SHIFT;
+    
+    pstartup->catchTime = MCAF_STARTUP_CATCH_TIME;
+    pstartup->catchVelocityThreshold = MCAF_STARTUP_CATCH_VELOCITY;
 }
 
 inline static int16_t limit32(int32_t x, int16_t limitLo, int16_t limitHi)
@@ -212,6 +215,12 @@ void MCAF_StartupTransitioningStep(MCAF_MOTOR_STARTUP_DATA *pstartup,
                 {
                     ++pstartup->counter;
                 }
+                else if (pstartup->catchRequest)
+                {
+                    pstartup->counter = 0;
+                    pstartup->thetaError = 0;
+                    pstartup->state = SSM_CATCH;
+                }
                 else
                 {
                     pstartup->state = SSM_CURRENT_RAMPUP;
@@ -299,6 +308,35 @@ void MCAF_StartupTransitioningStep(MCAF_MOTOR_STARTUP_DATA *pstartup,
             }
             break;
         }
+        case SSM_CATCH:
+        {
+            idqcmd_next.d = 0;
+            idqcmd_next.q = 0;
+            if (pstartup->counter < pstartup->catchTime)
+            {
+                ++pstartup->counter;
+            }
+            else
+            {
+                /* A rotor turning against the commanded direction 
+                 * would have to pass through standstill in closed loop. */
+                const MCAF_U_VELOCITY_ELEC omega = pstartup->omegaElectricalEstimated;
+                const bool forward = (omega < 0) == (direction < 0);
+                pstartup->catchRequest = false;
+                if (forward && UTIL_AbsGreaterThanEqual(omega, pstartup->catchVelocityThreshold))
+                {
+                    pstartup->complete = true;
+                    pstartup->state = SSM_COMPLETE;
+                }
+                else
+                {
+                    /* start as if from standstill */
+                    pstartup->counter = 0;
+                    pstartup->state = SSM_CURRENT_RAMPUP;
+                }
+            }
+            break;
+        }
         case SSM_COMPLETE:
             /* startup complete: do nothing */
             break;
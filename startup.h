@@ -88,6 +88,7 @@ inline static void MCAF_StartupReinit(MCAF_MOTOR_STARTUP_DATA *pstartup, int16_t
     pstartup->counter = 0;
     pstartup->complete = false;
     pstartup->enable = false;
+    pstartup->catchRequest = false;
     pstartup->delayRequest = false;
     pstartup->iRampupLimit = STARTUP_TORQUE_RAMPUP_RATE;
     pstartup->referenceFrameAlign.omegaOffset = 0;
@@ -103,6 +104,23 @@ inline static void MCAF_StartupEnable(MCAF_MOTOR_STARTUP_DATA *pstartup)
     pstartup->enable = true;
 }
 
+/**
+ * Requests the catch state ahead of current rampup, for a rotor that may
+ * be turning: the current is held at zero in closed-loop commutation for
+ * catchTime, so that the estimator can measure the velocity. If the rotor
+ * then turns in the commanded direction at catchVelocityThreshold or faster,
+ * startup completes without open-loop commutation (flying restart);
+ * otherwise, startup proceeds with current rampup and align as usual.
+ * 
+ * This must be called after MCAF_StartupReinit().
+ * 
+ * @param pstartup startup state
+ */
+inline static void MCAF_StartupRequestCatch(MCAF_MOTOR_STARTUP_DATA *pstartup)
+{
+    pstartup->catchRequest = true;
+}
+
 /**
  * Returns whether startup has completed
  * 
@@ -114,6 +132,19 @@ inline static bool MCAF_StartupHasCompleted(const MCAF_MOTOR_STARTUP_DATA *pstar
     return pstartup->complete;
 }
 
+/**
+ * Completes startup without open-loop commutation, 
+ * for use when the rotor angle is already known from a position sensor.
+ * 
+ * @param pstartup startup state
+ */
+inline static void MCAF_StartupSkipToClosedLoop(MCAF_MOTOR_STARTUP_DATA *pstartup)
+{
+    pstartup->thetaError = 0;
+    pstartup->state = SSM_COMPLETE;
+    pstartup->complete = true;
+}
+
 /**
  * Returns whether startup is in open-loop commutation
  * 
@@ -122,6 +153,7 @@ inline static bool MCAF_StartupHasCompleted(const MCAF_MOTOR_STARTUP_DATA *pstar
  */
 inline static bool MCAF_StartupInOpenLoopCommutation(const MCAF_MOTOR_STARTUP_DATA *pstartup)
 {
+    /* SSM_CATCH and SSM_INACTIVE follow SSM_COMPLETE */
     return pstartup->state < SSM_COMPLETE;
 }
 
@@ -49,12 +49,353 @@
 #include "startup_testing.h"
 #include "util.h"
 #include "mcapi_types.h"
+#include "event_queue_types.h"
+#include "recover.h"
+#include "startup_types.h"
+#include "parameters/startup_params.h"
+#include "parameters/options.h"
 #include "board_service.h"
 #include "hal/hardware_access_functions.h"
 
 STARTUP_TEST_APP_DATA app;
 void APP_TimerCallback(void);
 
+/**
+ * Clears the pass/fail counts and startup times.
+ * @param app application data
+ */
+static void APP_StartupTestResultsReset(STARTUP_TEST_APP_DATA *app)
+{
+    app->statStartupTimeAccumulated = 0;
+    app->statStartupTimeAverage = 0;
+    app->statStartupTimeMax = 0;
+    app->statStartupTimeMin = 32767;
+    app->statTestCount = 0;
+    app->statTestFailCount = 0;
+    app->statTestPassCount = 0;
+    app->statTestTimeout = 0;
+}
+
+/**
+ * Initializes the sweep grid around the default startup settings.
+ * @param psweep sweep state
+ */
+static void APP_SweepInitialize(APP_SWEEP *psweep)
+{
+    psweep->enable = false;
+    psweep->runsPerPoint = APP_SWEEP_RUNS_PER_POINT;
+
+    APP_SWEEP_AXIS *paxis = &psweep->axis[APP_SWEEP_AXIS_CURRENT];
+    paxis->start = MCAF_STARTUP_CURRENT - 310;      // 1.24 A .. 2.06 A
+    paxis->step = 310;
+    paxis->count = 3;
+    paxis = &psweep->axis[APP_SWEEP_AXIS_ACCEL0];
+    paxis->start = STARTUP_ACCELERATION0 - 6000;
+    paxis->step = 6000;
+    paxis->count = 3;
+    paxis = &psweep->axis[APP_SWEEP_AXIS_ACCEL1];
+    paxis->start = STARTUP_ACCELERATION1 - 4000;
+    paxis->step = 4000;
+    paxis->count = 3;
+    paxis = &psweep->axis[APP_SWEEP_AXIS_HOLD];
+    paxis->start = STARTUP_HOLD_TIME;
+    paxis->step = 2000;                             // 100 ms
+    paxis->count = 3;
+
+    psweep->pointCount = 0;
+    psweep->pointIndex = 0;
+    psweep->pointApplied = false;
+}
+
+/**
+ * Returns a value of a sweep axis, limited to the given range.
+ * @param paxis sweep axis
+ * @param index index along the axis
+ * @param min minimum value
+ * @param max maximum value
+ * @return axis value
+ */
+static int32_t APP_SweepAxisValue(const APP_SWEEP_AXIS *paxis, uint16_t index,
+                                  int32_t min, int32_t max)
+{
+    const int32_t value = paxis->start + paxis->step * (int32_t)index;
+    if (value < min)
+    {
+        return min;
+    }
+    return (value > max) ? max : value;
+}
+
+/**
+ * Computes the startup settings of a grid point.
+ * @param psweep sweep state
+ * @param point grid point index
+ * @param pconfig startup settings
+ */
+static void APP_SweepPointConfig(const APP_SWEEP *psweep, uint16_t point,
+                                 MCAPI_STARTUP_CONFIG *pconfig)
+{
+    uint16_t index[APP_SWEEP_AXIS_COUNT];
+    int i;
+    for (i = 0; i < APP_SWEEP_AXIS_COUNT; ++i)
+    {
+        const uint16_t count = psweep->axis[i].count;
+        index[i] = point % count;
+        point /= count;
+    }
+    const APP_SWEEP_AXIS *paxis = psweep->axis;
+    pconfig->current = APP_SweepAxisValue(&paxis[APP_SWEEP_AXIS_CURRENT],
+                                          index[APP_SWEEP_AXIS_CURRENT], 0, INT16_MAX);
+    pconfig->acceleration[0] = APP_SweepAxisValue(&paxis[APP_SWEEP_AXIS_ACCEL0],
+                                                  index[APP_SWEEP_AXIS_ACCEL0], 1, INT16_MAX);
+    pconfig->acceleration[1] = APP_SweepAxisValue(&paxis[APP_SWEEP_AXIS_ACCEL1],
+                                                  index[APP_SWEEP_AXIS_ACCEL1], 1, INT16_MAX);
+    pconfig->holdTime = APP_SweepAxisValue(&paxis[APP_SWEEP_AXIS_HOLD],
+                                           index[APP_SWEEP_AXIS_HOLD], 0, INT32_MAX);
+}
+
+/**
+ * Requests the startup settings of the grid point in progress.
+ * At the first point, the grid size is fixed and the result table is cleared.
+ * @param app application data
+ */
+static void APP_SweepApplyPoint(STARTUP_TEST_APP_DATA *app)
+{
+    APP_SWEEP *psweep = &app->sweep;
+    if (psweep->pointIndex == 0)
+    {
+        uint32_t pointCount = 1;
+        int i;
+        for (i = 0; i < APP_SWEEP_AXIS_COUNT; ++i)
+        {
+            if (psweep->axis[i].count == 0)
+            {
+                psweep->axis[i].count = 1;
+            }
+            pointCount *= psweep->axis[i].count;
+        }
+        psweep->pointCount = (pointCount > APP_SWEEP_MAX_POINTS)
+                           ? APP_SWEEP_MAX_POINTS : pointCount;
+        for (i = 0; i < APP_SWEEP_MAX_POINTS; ++i)
+        {
+            APP_SWEEP_RESULT *presult = &psweep->result[i];
+            APP_SweepPointConfig(psweep, i, &presult->config);
+            presult->runs = 0;
+            presult->passes = 0;
+            presult->successRate = 0;
+            presult->startupTimeMean = 0;
+            presult->startupTimeMax = 0;
+        }
+    }
+    MCAPI_StartupConfigSet(app->apiData, &psweep->result[psweep->pointIndex].config);
+    psweep->pointApplied = true;
+}
+
+/**
+ * Records the results of the grid point in progress and moves to the next one.
+ * The statistics are cleared for the next point; after the last point they
+ * are kept, so that the final average can still be computed from them.
+ * @param app application data
+ * @return whether there are grid points left
+ */
+static bool APP_SweepNextPoint(STARTUP_TEST_APP_DATA *app)
+{
+    APP_SWEEP *psweep = &app->sweep;
+    if (psweep->pointApplied)
+    {
+        APP_SWEEP_RESULT *presult = &psweep->result[psweep->pointIndex];
+        presult->runs = app->statTestCount;
+        presult->passes = app->statTestPassCount;
+        if (app->statTestCount > 0)
+        {
+            presult->successRate = __builtin_divud((uint32_t)app->statTestPassCount * 100,
+                                                   app->statTestCount);
+        }
+        if (app->statTestPassCount > 0)
+        {
+            presult->startupTimeMean = __builtin_divud(app->statStartupTimeAccumulated,
+                                                       app->statTestPassCount);
+        }
+        presult->startupTimeMax = app->statStartupTimeMax;
+        ++psweep->pointIndex;
+        psweep->pointApplied = false;
+    }
+    const bool pointsLeft = psweep->pointIndex < psweep->pointCount;
+    if (pointsLeft)
+    {
+        APP_StartupTestResultsReset(app);
+    }
+    return pointsLeft;
+}
+
+/**
+ * Ends the sweep and restores the default startup settings.
+ * @param app application data
+ */
+static void APP_SweepFinish(STARTUP_TEST_APP_DATA *app)
+{
+    const MCAPI_STARTUP_CONFIG defaults = {
+        MCAF_STARTUP_CURRENT,
+        { STARTUP_ACCELERATION0, STARTUP_ACCELERATION1 },
+        STARTUP_HOLD_TIME
+    };
+    MCAPI_StartupConfigSet(app->apiData, &defaults);
+    app->sweep.enable = false;
+    app->sweep.pointIndex = 0;
+    app->sweep.pointApplied = false;
+}
+
+/**
+ * Clears the startup phase timing statistics.
+ * @param pstats phase statistics
+ */
+static void APP_StartupPhaseStatsReset(APP_STARTUP_PHASE_STATS *pstats)
+{
+    int i, j;
+    for (i = 0; i < APP_STARTUP_PHASE_COUNT; ++i)
+    {
+        APP_STARTUP_PHASE_SUMMARY *psummary = &pstats->summary[i];
+        psummary->count = 0;
+        psummary->min = UINT32_MAX;
+        psummary->max = 0;
+        psummary->p50 = 0;
+        psummary->p90 = 0;
+        psummary->p99 = 0;
+        for (j = 0; j < APP_PHASE_HISTOGRAM_BINS; ++j)
+        {
+            pstats->histogram[i][j] = 0;
+        }
+    }
+    pstats->phase = SSM_START;
+    pstats->phaseStart = 0;
+}
+
+/**
+ * Returns the histogram bin for a phase duration.
+ * @param duration duration in ISR cycles
+ * @return bin index
+ */
+static uint16_t APP_PhaseHistogramBin(uint32_t duration)
+{
+    const uint16_t octaveMax = APP_PHASE_HISTOGRAM_OCTAVE_MIN + APP_PHASE_HISTOGRAM_OCTAVES;
+    if (duration < (1UL << APP_PHASE_HISTOGRAM_OCTAVE_MIN))
+    {
+        return 0;
+    }
+    uint16_t octave = APP_PHASE_HISTOGRAM_OCTAVE_MIN;
+    while ((octave < octaveMax) && ((duration >> (octave + 1)) != 0))
+    {
+        ++octave;
+    }
+    if (octave >= octaveMax)
+    {
+        return APP_PHASE_HISTOGRAM_BINS - 1;
+    }
+    const uint16_t quarter = (duration >> (octave - 2)) & 3;
+    return 1 + (octave - APP_PHASE_HISTOGRAM_OCTAVE_MIN)*4 + quarter;
+}
+
+/**
+ * Returns the upper edge of a histogram bin.
+ * @param bin bin index, excluding the overflow bin
+ * @return first duration in ISR cycles beyond the bin
+ */
+static uint32_t APP_PhaseHistogramBinEnd(uint16_t bin)
+{
+    if (bin == 0)
+    {
+        return 1UL << APP_PHASE_HISTOGRAM_OCTAVE_MIN;
+    }
+    const uint16_t octave = APP_PHASE_HISTOGRAM_OCTAVE_MIN + ((bin - 1) >> 2);
+    const uint16_t quarter = (bin - 1) & 3;
+    return (1UL << octave) + ((uint32_t)(quarter + 1) << (octave - 2));
+}
+
+/**
+ * Finds a percentile of the phase durations in a histogram.
+ * @param histogram bin counts
+ * @param psummary phase statistics, with count, min and max up to date
+ * @param percent percentile to find
+ * @return percentile in ISR cycles, limited to the range of observed durations
+ */
+static uint32_t APP_PhaseHistogramPercentile(const uint16_t *histogram,
+                                             const APP_STARTUP_PHASE_SUMMARY *psummary,
+                                             uint16_t percent)
+{
+    const uint16_t target = __builtin_divud((uint32_t)psummary->count * percent + 99, 100);
+    uint16_t cumulative = 0;
+    uint16_t bin;
+    for (bin = 0; bin < APP_PHASE_HISTOGRAM_BINS - 1; ++bin)
+    {
+        cumulative += histogram[bin];
+        if (cumulative >= target)
+        {
+            const uint32_t end = APP_PhaseHistogramBinEnd(bin);
+            if (end > psummary->max)
+            {
+                return psummary->max;
+            }
+            return (end < psummary->min) ? psummary->min : end;
+        }
+    }
+    return psummary->max;
+}
+
+/**
+ * Records the duration of a completed startup phase.
+ * @param pstats phase statistics
+ * @param phase startup FSM state of the phase
+ * @param duration duration in ISR cycles
+ */
+static void APP_StartupPhaseRecord(APP_STARTUP_PHASE_STATS *pstats,
+                                   uint16_t phase, uint32_t duration)
+{
+    const uint16_t index = phase - SSM_CURRENT_RAMPUP;
+    APP_STARTUP_PHASE_SUMMARY *psummary = &pstats->summary[index];
+    uint16_t *histogram = pstats->histogram[index];
+    const uint16_t bin = APP_PhaseHistogramBin(duration);
+    if (histogram[bin] == UINT16_MAX || psummary->count == UINT16_MAX)
+    {
+        /* saturated: keep the existing statistics consistent */
+        return;
+    }
+    ++histogram[bin];
+    ++psummary->count;
+    if (duration < psummary->min)
+    {
+        psummary->min = duration;
+    }
+    if (duration > psummary->max)
+    {
+        psummary->max = duration;
+    }
+    psummary->p50 = APP_PhaseHistogramPercentile(histogram, psummary, 50);
+    psummary->p90 = APP_PhaseHistogramPercentile(histogram, psummary, 90);
+    psummary->p99 = APP_PhaseHistogramPercentile(histogram, psummary, 99);
+}
+
+/**
+ * Handles a startup FSM transition reported by MCAF.
+ * The startup phases always run in sequence, so a phase is timed
+ * only if the next phase follows it directly; phases cut short by
+ * a stop or fault are discarded.
+ * @param pstats phase statistics
+ * @param phase startup FSM state that was entered
+ * @param timestamp ISR count at the transition
+ */
+static void APP_StartupPhaseTransition(APP_STARTUP_PHASE_STATS *pstats,
+                                       uint16_t phase, uint32_t timestamp)
+{
+    const uint16_t previous = pstats->phase;
+    if ((previous >= SSM_CURRENT_RAMPUP) && (previous <= SSM_REF_FRAME_ALIGN)
+     && (phase == previous + 1))
+    {
+        APP_StartupPhaseRecord(pstats, previous, timestamp - pstats->phaseStart);
+    }
+    pstats->phase = phase;
+    pstats->phaseStart = timestamp;
+}
+
 void APP_StartupTestApplicationInitialize(volatile MCAPI_MOTOR_DATA *apiData, MCAF_BOARD_DATA *pboard)
 {
     STARTUP_TEST_APP_DATA *appData = &app;
@@ -71,32 +412,79 @@ void APP_StartupTestApplicationInitialize(volatile MCAPI_MOTOR_DATA *apiData, MC
     appData->testStop = false;
     appData->testStartupTimer = 0;
     
-    appData->statStartupTimeAccumulated = 0;
-    appData->statStartupTimeAverage = 0;
-    appData->statStartupTimeMax = 0;
-    appData->statStartupTimeMin = 32767;
-    appData->statTestCount = 0;
-    appData->statTestFailCount = 0;
-    appData->statTestPassCount = 0;
-    appData->statTestTimeout = 0;
+    APP_StartupTestResultsReset(appData);
+    appData->statStallCount = 0;
+    appData->statRecoveryCount = 0;
+    appData->statLastFaultCode = 0;
+    APP_StartupPhaseStatsReset(&appData->statPhase);
     
     appData->statReset = false;
 
+    APP_SweepInitialize(&appData->sweep);
+
     HAL_TMR_TICK_SetCallbackFunction(APP_TimerCallback);
 }
 
+/**
+ * Processes events posted by MCAF since the last step, so that
+ * transient conditions (e.g. a stall flag that is set and cleared
+ * within a few ISRs) are counted even though the step runs at 1 ms.
+ * @param app application data
+ */
+static void APP_StartupTestHandleEvents(STARTUP_TEST_APP_DATA *app)
+{
+    MCAF_EVENT_T event;
+    while (MCAPI_EventGet(app->apiData, &event))
+    {
+        switch (event.type)
+        {
+            case MCAF_EVENT_STALL_DETECT:
+                app->statStallCount++;
+                break;
+            case MCAF_EVENT_RECOVERY:
+                if (event.payload == MCAF_RECOVERY_FSM_RESTART_PENDING)
+                {
+                    app->statRecoveryCount++;
+                }
+                break;
+            case MCAF_EVENT_FAULT:
+                app->statLastFaultCode = event.payload;
+                break;
+            case MCAF_EVENT_STARTUP_PHASE:
+                APP_StartupPhaseTransition(&app->statPhase, event.payload, event.timestamp);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
 void APP_StartupTestApplicationStep(STARTUP_TEST_APP_DATA *app)
 {
     volatile MCAPI_MOTOR_DATA *api = app->apiData;
 
-    if (app->testEnable)
+    APP_StartupTestHandleEvents(app);
+
+    /* With remote control, the remote host owns the velocity reference
+     * and start/stop, and the tests cannot be configured because
+     * X2Cscope is not serviced; only the statistics are kept. */
+    if (app->testEnable && !MCAF_INCLUDE_REMOTE_CONTROL)
     {
-        MCAPI_MOTOR_STATE motorState = MCAPI_OperatingStatusGet(api);
-        switch (motorState)
+        /* state and velocity must come from the same ISR */
+        MCAPI_STATUS_SNAPSHOT status;
+        MCAPI_StatusSnapshotGet(api, &status);
+        switch (status.motorStatus)
         {
             case MCAPI_MOTOR_STOPPED:
             {
-                if (app->testStop || app->statTestCount >= app->configTestCount)
+                const uint16_t testCount = app->sweep.enable
+                                         ? app->sweep.runsPerPoint : app->configTestCount;
+                bool testComplete = app->testStop || app->statTestCount >= testCount;
+                if (testComplete && app->sweep.enable && !app->testStop)
+                {
+                    testComplete = !APP_SweepNextPoint(app);
+                }
+                if (testComplete)
                 {
                     if (app->statTestPassCount > 0)
                     {
@@ -104,14 +492,26 @@ void APP_StartupTestApplicationStep(STARTUP_TEST_APP_DATA *app)
                                 __builtin_divud(app->statStartupTimeAccumulated, 
                                                 app->statTestPassCount);
                     }
+                    if (app->sweep.enable)
+                    {
+                        APP_SweepFinish(app);
+                    }
 
                     app->testEnable = false;
                     app->testStop = false;
                 }
                 else
                 {
-                    /* start the motor after spin down time */
-                    if (app->testTimer >= app->configSpinDownTime)
+                    if (app->sweep.enable && !app->sweep.pointApplied)
+                    {
+                        APP_SweepApplyPoint(app);
+                    }
+                    /* start the motor when the rotor is detected at standstill
+                     * (or at the latest after spin down time) and
+                     * new startup settings have been applied */
+                    const bool spunDown = status.rotorStopped
+                                       || app->testTimer >= app->configSpinDownTime;
+                    if (spunDown && !MCAPI_StartupConfigPending(api))
                     {
                         app->testTimer = 0;
                         MCAPI_VelocityReferenceSet(api, app->configTestMotorVelocity);
@@ -150,7 +550,7 @@ void APP_StartupTestApplicationStep(STARTUP_TEST_APP_DATA *app)
                 /* stop the motor after it reaches the 
                  * preset test velocity and stays there
                  * for some time without faults */
-                app->motorVelocityMeasured = MCAPI_VelocityMeasuredGet(api);
+                app->motorVelocityMeasured = status.velocityMeasured;
                 if (app->motorVelocityMeasured >= app->configTestMotorVelocity || app->testTimer > 0)
                 {
                     if (app->testTimer >= app->configHoldTime)
@@ -196,7 +596,8 @@ void APP_StartupTestApplicationStep(STARTUP_TEST_APP_DATA *app)
                 uint16_t faultFlags = MCAPI_FaultStatusGet(api);
                 MCAPI_FaultStatusClear(api, faultFlags);
                 
-                if (app->configStopOnFail && app->testStartupTimer > 0)
+                /* failures are expected at some points of a sweep */
+                if (app->configStopOnFail && !app->sweep.enable && app->testStartupTimer > 0)
                 {
                     app->testEnable = 0;
                 }
@@ -210,6 +611,8 @@ void APP_StartupTestApplicationStep(STARTUP_TEST_APP_DATA *app)
                 break;
             }
 
+            case MCAPI_MOTOR_RUNNING_TORQUE:
+            case MCAPI_MOTOR_RUNNING_POSITION:
             case MCAPI_MOTOR_DIAGSTATE:
             {
                 /* do nothing */
@@ -220,14 +623,11 @@ void APP_StartupTestApplicationStep(STARTUP_TEST_APP_DATA *app)
     
     if (app->statReset)
     {
-        app->statStartupTimeAccumulated = 0;
-        app->statStartupTimeAverage = 0;
-        app->statStartupTimeMax = 0;
-        app->statStartupTimeMin = 32767;
-        app->statTestCount = 0;
-        app->statTestFailCount = 0;
-        app->statTestPassCount = 0;
-        app->statTestTimeout = 0;
+        APP_StartupTestResultsReset(app);
+        app->statStallCount = 0;
+        app->statRecoveryCount = 0;
+        app->statLastFaultCode = 0;
+        APP_StartupPhaseStatsReset(&app->statPhase);
         
         app->statReset = false;
     }
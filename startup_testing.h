@@ -61,6 +61,99 @@ extern "C" {
 #define APP_STARTUP_HOLD_TIME   1000     // in ms
 #define APP_STARTUP_TIMOUT      5000     // in ms
 #define APP_SPIN_DOWN_TIME      100      // in ms
+
+/** Number of grid axes for the startup parameter sweep */
+#define APP_SWEEP_AXIS_COUNT            4
+/** Maximum number of grid points in the startup parameter sweep */
+#define APP_SWEEP_MAX_POINTS            81
+/** Default number of starts per grid point */
+#define APP_SWEEP_RUNS_PER_POINT        50
+
+/** Grid axes of the startup parameter sweep */
+typedef enum tagAPP_SWEEP_AXIS_ID
+{
+    APP_SWEEP_AXIS_CURRENT  = 0,    /** startup current */
+    APP_SWEEP_AXIS_ACCEL0   = 1,    /** first open-loop acceleration */
+    APP_SWEEP_AXIS_ACCEL1   = 2,    /** second open-loop acceleration */
+    APP_SWEEP_AXIS_HOLD     = 3     /** hold time, in ISR cycles */
+} APP_SWEEP_AXIS_ID;
+
+/** One axis of the sweep grid: values start + k*step, k = 0 .. count-1 */
+typedef struct tagAPP_SWEEP_AXIS
+{
+    int32_t  start;     /** first value */
+    int32_t  step;      /** increment between values */
+    uint16_t count;     /** number of values, at least 1 */
+} APP_SWEEP_AXIS;
+
+/** Results of one grid point; the result array forms the exported table */
+typedef struct tagAPP_SWEEP_RESULT
+{
+    MCAPI_STARTUP_CONFIG config;    /** startup settings of this grid point */
+    uint16_t runs;                  /** number of starts */
+    uint16_t passes;                /** number of successful starts */
+    uint16_t successRate;           /** successful starts, in percent */
+    uint16_t startupTimeMean;       /** mean startup time of successful starts, in ms */
+    uint16_t startupTimeMax;        /** maximum startup time of successful starts, in ms */
+} APP_SWEEP_RESULT;
+
+/**
+ * Startup parameter sweep: runs the start test at each point of a grid
+ * of startup settings, with the current axis varying fastest.
+ */
+typedef struct tagAPP_SWEEP
+{
+    bool     enable;                /** run the start test as a sweep */
+    uint16_t runsPerPoint;          /** number of starts at each grid point */
+    APP_SWEEP_AXIS axis[APP_SWEEP_AXIS_COUNT]; /** grid axes, see APP_SWEEP_AXIS_ID */
+    uint16_t pointCount;            /** number of grid points, set when the sweep starts */
+    uint16_t pointIndex;            /** grid point in progress */
+    bool     pointApplied;          /** whether the settings of pointIndex were requested */
+    APP_SWEEP_RESULT result[APP_SWEEP_MAX_POINTS]; /** results, one row per grid point */
+} APP_SWEEP;
+
+/** Number of timed startup phases, SSM_CURRENT_RAMPUP to SSM_REF_FRAME_ALIGN */
+#define APP_STARTUP_PHASE_COUNT         6
+/** Phase durations below 2^N ISR cycles share the first histogram bin */
+#define APP_PHASE_HISTOGRAM_OCTAVE_MIN  4
+/**
+ * Number of octaves covered by the histogram, each split into 4 bins;
+ * at 20kHz the bins span 2^4 to 2^19 ISR cycles, about 0.8ms to 26s,
+ * and longer phases go into the overflow bin
+ */
+#define APP_PHASE_HISTOGRAM_OCTAVES     15
+/** Number of histogram bins, including the underflow and overflow bins */
+#define APP_PHASE_HISTOGRAM_BINS        (APP_PHASE_HISTOGRAM_OCTAVES*4 + 2)
+
+/**
+ * Duration statistics of one startup phase, in ISR cycles.
+ * Percentiles are the upper edge of the histogram bin that contains them,
+ * so they overestimate by at most 25%.
+ */
+typedef struct tagAPP_STARTUP_PHASE_SUMMARY
+{
+    uint16_t count;     /** number of completed phases */
+    uint32_t min;       /** shortest duration */
+    uint32_t max;       /** longest duration */
+    uint32_t p50;       /** median duration */
+    uint32_t p90;       /** 90th percentile duration */
+    uint32_t p99;       /** 99th percentile duration */
+} APP_STARTUP_PHASE_SUMMARY;
+
+/**
+ * Startup phase timing, kept in one block so it can be read at once
+ * over the diagnostics channel.
+ *
+ * The histograms have logarithmic bins, 4 per octave, so that a single
+ * layout covers phases that last from about 1ms to about 26s.
+ */
+typedef struct tagAPP_STARTUP_PHASE_STATS
+{
+    APP_STARTUP_PHASE_SUMMARY summary[APP_STARTUP_PHASE_COUNT]; /** statistics per phase */
+    uint16_t histogram[APP_STARTUP_PHASE_COUNT][APP_PHASE_HISTOGRAM_BINS]; /** bin counts per phase */
+    uint16_t phase;         /** startup FSM state of the phase in progress */
+    uint32_t phaseStart;    /** ISR count when the phase in progress started */
+} APP_STARTUP_PHASE_STATS;
     
 typedef struct tagAPPLICATION_DATA
 {
@@ -85,8 +178,14 @@ typedef struct tagAPPLICATION_DATA
     uint16_t statTestPassCount;
     uint16_t statTestFailCount;
     uint16_t statTestTimeout;
+    uint16_t statStallCount;        /** stall detections reported by MCAF */
+    uint16_t statRecoveryCount;     /** recovery restarts attempted by MCAF */
+    uint16_t statLastFaultCode;     /** error code of the most recent fault */
+    APP_STARTUP_PHASE_STATS statPhase; /** startup phase timing */
     bool statReset;
 
+    APP_SWEEP sweep;                /** startup parameter sweep */
+
     volatile MCAPI_MOTOR_DATA *apiData;
     MCAF_BOARD_DATA *pboard;
 } STARTUP_TEST_APP_DATA;
@@ -83,7 +83,11 @@ typedef enum tagMCAF_STARTUP_FSM_STATE
    SSM_REF_FRAME_ALIGN  = 6, 
    /** indicates completion of open to close loop transition */
    SSM_COMPLETE         = 7,
-   SSM_INACTIVE         = 8   /** inactive state for test modes */                   
+   SSM_INACTIVE         = 8,  /** inactive state for test modes */                   
+   /** Current is held at zero in closed-loop commutation, while the estimator
+    * measures the velocity of a rotor that may still be turning; startup then
+    * either completes at once (flying restart) or proceeds with current rampup. */
+   SSM_CATCH            = 9
 } MCAF_STARTUP_FSM_STATE;
 
 typedef enum tagMCAF_STARTUP_STATUS_T
@@ -188,6 +192,12 @@ typedef struct tagMOTOR_STARTUP_DATA
      MCAF_U_CURRENT       iNominal;
      /** open-loop state machine state */
      MCAF_STARTUP_FSM_STATE state;
+     /** Time spent in the catch state before the velocity is tested */
+     uint16_t             catchTime;
+     /** Minimum velocity magnitude for a flying restart from the catch state */
+     MCAF_U_VELOCITY_ELEC catchVelocityThreshold;
+     /** Whether the catch state precedes current rampup */
+     bool                 catchRequest;
      /** Whether open-loop startup is enabled */
      bool                 enable;
      /** Whether open-loop startup is complete */
@@ -219,6 +229,7 @@ inline static MCAF_STARTUP_STATUS_T MCAF_StartupGetStatus(const MCAF_MOTOR_START
         case SSM_ACCEL1:     return MSST_ACCEL;
         case SSM_HOLD:       return MSST_SPIN;
         case SSM_COMPLETE:   return MSST_COMPLETE;
+        case SSM_CATCH:      return MSST_ANGLE_LOCK;
         default:             return MSST_UNSPECIFIED;
     }
 }
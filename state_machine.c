@@ -46,6 +46,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "system_state.h"
 #include "foc.h"
 #include "adc_compensation.h"
@@ -69,9 +70,9 @@
 #include "test_harness.h"
 #include "current_measure.h"
 
-inline static void MCAF_SetPwmMinimalImpact(void)
+inline static void MCAF_SetPwmMinimalImpact(const MCAF_MOTOR_DATA *pmotor)
 {
-    HAL_PWM_LowerTransistorsDutyCycle_Set(HAL_PARAM_PWM_PERIOD_COUNTS, 
+    HAL_PWM_LowerTransistorsDutyCycle_SetInstance(pmotor->phal, HAL_PARAM_PWM_PERIOD_COUNTS, 
             HAL_PARAM_MIN_LOWER_DUTY_COUNTS);
 }
 
@@ -79,10 +80,10 @@ inline static void MCAF_SetPwmMinimalImpact(void)
  * Initializes PWM registers for normal operation and
  * set a default "safe" duty cycle
  */
-inline static void EnablePwmMinDuty(void)
+inline static void EnablePwmMinDuty(const MCAF_MOTOR_DATA *pmotor)
 {
-    HAL_PWM_DutyCycle_SetIdentical(HAL_PARAM_MIN_DUTY_COUNTS);
-    HAL_PWM_UpperTransistorsOverride_Disable();
+    HAL_PWM_DutyCycle_SetIdenticalInstance(pmotor->phal, HAL_PARAM_MIN_DUTY_COUNTS);
+    HAL_PWM_UpperTransistorsOverride_DisableInstance(pmotor->phal);
 }
 
 /**
@@ -145,18 +146,21 @@ inline static void MCAF_OvercurrentHWFlagAttemptClear(MCAF_MOTOR_DATA *pmotor)
         Occurs at the next PWM period
         Step 2: Enable fault mode latch and clear fault interrupt flag
     */
-    HAL_PWM_FaultStatus_Clear();
-    HAL_PWM_FaultClearEnd();
+    HAL_PWM_FaultStatus_ClearInstance(pmotor->phal);
+    HAL_PWM_FaultClearEndInstance(pmotor->phal);
 }
 
 /**
  * Executes actions on entry to the STOPPED state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnStoppedInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnStoppedInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
-    MCAF_SetPwmMinimalImpact();
+    MCAF_SetPwmMinimalImpact(pmotor);
+    MCAF_MonitorStopDetectCancelProbe(&pmotor->monitor.stopDetect);
     MCAF_ClearClosedLoopFlags(pmotor);
     MCAF_MonitorRecoveryAcknowledged(pmotor);
     MCAF_RecoverySetInputFlag(&pmotor->recovery, MCAF_RECOVERY_FSMI_STOP_COMPLETED);
@@ -172,27 +176,46 @@ inline static void MCAF_MotorControllerOnStoppedInit(MCAF_MOTOR_DATA *pmotor)
  * Executes actions in the STOPPED state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnStopped(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnStopped(MCAF_MOTOR_DATA *pmotor, bool init)
 {    
     resetRecoveryIfNotRunRequested(pmotor);
+    /* An idle drive does not probe: shorting the windings would brake
+     * a windmilling rotor. Probes resume only while a start is requested
+     * (and held off, e.g. by a pending recovery), and a probe in progress
+     * is always finished so that the lower transistors are released.
+     */
+    if (pmotor->ui.run
+        || MCAF_MonitorStopDetectIsProbing(&pmotor->monitor.stopDetect))
+    {
+        MCAF_MonitorStopDetectStep(pmotor);
+    }
 }
 
 /**
  * Executes actions on entry to STARTING state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnStartingInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnStartingInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {       
     MCAF_CommutationStartupInit(pmotor);
+    if (MCAF_RecoveryTestAndClearRetryFlag(&pmotor->recovery))
+    {
+        /* Retries after a stall do not wait for the rotor to stop */
+        MCAF_StartupRequestCatch(&pmotor->startup);
+    }
     MCAF_CurrentMeasureRestart(&pmotor->currentMeasure);
     MCAF_FocInitializeIntegrators(pmotor);
     MCAF_FluxControlStartupInit(&pmotor->fluxControl);
 #if MCAF_INCLUDE_STALL_DETECT      
     MCAF_StallDetectActivate(&pmotor->stallDetect);
 #endif
-    EnablePwmMinDuty();
+    MCAF_MonitorStopDetectReset(&pmotor->monitor.stopDetect);
+    EnablePwmMinDuty(pmotor);
     MCAF_SetClosedLoopCurrent(pmotor);
 }
 
@@ -231,13 +254,13 @@ inline static void MCAF_MotorControllerOnActiveStates(MCAF_MOTOR_DATA *pmotor)
         uint16_t pwmDutyCycle[3];
         constrainDutyCycleAsArray(pwmPhase, &pcurr->pwmDutyCycleOut.rising, HAL_PARAM_MIN_DUTY_COUNTS);
         constrainDutyCycleAsArray(pwmDutyCycle, &pcurr->pwmDutyCycleOut.falling, HAL_PARAM_MIN_DUTY_COUNTS);
-        HAL_PWM_DutyCycleDualEdge_Set(pwmPhase, pwmDutyCycle);
+        HAL_PWM_DutyCycleDualEdge_SetInstance(pmotor->phal, pwmPhase, pwmDutyCycle);
     }
 #else
     {
         uint16_t pwmDutyCycle[3];
         constrainDutyCycleAsArray(pwmDutyCycle, &pmotor->pwmDutycycle, HAL_PARAM_MIN_DUTY_COUNTS);
-        HAL_PWM_DutyCycleRegister_Set(pwmDutyCycle);
+        HAL_PWM_DutyCycleRegister_SetInstance(pmotor->phal, pwmDutyCycle);
     }
 #endif    
 }
@@ -246,8 +269,9 @@ inline static void MCAF_MotorControllerOnActiveStates(MCAF_MOTOR_DATA *pmotor)
  * Executes actions on the STARTING state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnStarting(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnStarting(MCAF_MOTOR_DATA *pmotor, bool init)
 {
     MCAF_MotorControllerOnActiveStates(pmotor);
 }
@@ -256,8 +280,10 @@ inline static void MCAF_MotorControllerOnStarting(MCAF_MOTOR_DATA *pmotor)
  * Executes actions on entry to the RUNNING state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnRunningInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnRunningInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
     if (!MCAF_IsClosedLoopVelocity(pmotor))
     {
@@ -269,20 +295,158 @@ inline static void MCAF_MotorControllerOnRunningInit(MCAF_MOTOR_DATA *pmotor)
  * Executes actions in the RUNNING state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnRunning(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnRunning(MCAF_MOTOR_DATA *pmotor, bool init)
 {
     MCAF_MotorControllerOnActiveStates(pmotor);
 }
 
+/**
+ * Computes the deceleration slew rate limit for regenerative braking.
+ * 
+ * The rate is reduced linearly from MCAF_BRAKING_SLEWRATE_LIMIT to zero
+ * as the DC link voltage rises through the window set up by
+ * MCAF_BrakingDerateInit(), so that the energy returned by the motor
+ * cannot raise the DC link voltage to the overvoltage fault threshold.
+ * 
+ * @param pmotor motor state data
+ * @return deceleration slew rate limit
+ */
+inline static int16_t MCAF_BrakingSlewRateLimit(const MCAF_MOTOR_DATA *pmotor)
+{
+    const MCAF_STOPPING_STATE *pstopping = &pmotor->stopping;
+    const int16_t derateRange = pstopping->vdcDerateEnd - pstopping->vdcDerateStart;
+    const int16_t margin = UTIL_LimitS16(pstopping->vdcDerateEnd - pmotor->vDC,
+                                         0, derateRange);
+    return __builtin_divsd(UTIL_mulss(MCAF_BRAKING_SLEWRATE_LIMIT, margin), derateRange);
+}
+
+/**
+ * Sets up the DC link voltage window for regenerative braking.
+ * 
+ * Derating starts MCAF_BRAKING_VDC_DERATE_RISE above the DC link voltage
+ * measured before the stop, and deceleration stops
+ * MCAF_BRAKING_VDC_DERATE_MARGIN below the overvoltage fault threshold.
+ * If the DC link voltage is already close to the threshold, the window
+ * is kept at least MCAF_BRAKING_VDC_DERATE_RISE wide.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void MCAF_BrakingDerateInit(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_STOPPING_STATE *pstopping = &pmotor->stopping;
+    const int16_t vdcEnd = pmotor->faultDetect.voltage.vDCOvervoltageThreshold
+                         - MCAF_BRAKING_VDC_DERATE_MARGIN;
+    const int16_t vdcStart = UTIL_SatAddS16(pmotor->vDC, MCAF_BRAKING_VDC_DERATE_RISE);
+    pstopping->vdcDerateEnd = vdcEnd;
+    pstopping->vdcDerateStart = UTIL_LimitS16(vdcStart, 0, vdcEnd - MCAF_BRAKING_VDC_DERATE_RISE);
+}
+
+/**
+ * Ends active braking; the motor coasts for the remainder 
+ * of the STOPPING state.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void MCAF_BrakingCoast(MCAF_MOTOR_DATA *pmotor)
+{
+    pmotor->omegaCmd = 0;
+    MCAF_SetPwmMinimalImpact(pmotor);
+    MCAF_ClearClosedLoopFlags(pmotor);
+    MCAF_MonitorStopDetectReset(&pmotor->monitor.stopDetect);
+    MCAF_StoppingTimerReset(pmotor);
+    pmotor->velocityControl.slewRateLimitDecel = pmotor->config.velocitySlewRateLimitDecel;
+    pmotor->stopping.braking = MCAF_BRAKING_COAST;
+}
+
+/**
+ * Shorts the motor terminals by turning on all lower transistors.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void MCAF_BrakingShortStart(MCAF_MOTOR_DATA *pmotor)
+{
+    HAL_PWM_LowerTransistorsDutyCycle_SetInstance(pmotor->phal, HAL_PARAM_PWM_PERIOD_COUNTS, 
+            HAL_PARAM_PWM_PERIOD_COUNTS);
+    MCAF_ClearClosedLoopFlags(pmotor);
+    pmotor->velocityControl.slewRateLimitDecel = pmotor->config.velocitySlewRateLimitDecel;
+    pmotor->stopping.braking = MCAF_BRAKING_SHORT;
+    pmotor->stopping.brakingTimer = 0;
+    pmotor->stopping.quietCount = 0;
+}
+
+/**
+ * Executes one step of active braking in the STOPPING state.
+ * 
+ * @param pmotor motor state data
+ */
+inline static void MCAF_BrakingStep(MCAF_MOTOR_DATA *pmotor)
+{
+    MCAF_STOPPING_STATE *pstopping = &pmotor->stopping;
+    switch (pstopping->braking)
+    {
+        case MCAF_BRAKING_REGEN:
+        {
+            pmotor->velocityControl.velocityCmd = 0;
+            pmotor->velocityControl.slewRateLimitDecel = MCAF_BrakingSlewRateLimit(pmotor);
+            MCAF_MotorControllerOnActiveStates(pmotor);
+            
+            if (UTIL_AbsLessThan(pmotor->omegaElectrical, MCAF_BRAKING_SHORT_SPEED))
+            {
+                MCAF_BrakingShortStart(pmotor);
+            }
+            else if (++pstopping->brakingTimer >= MCAF_BRAKING_TIMEOUT)
+            {
+                MCAF_BrakingCoast(pmotor);
+            }
+            break;
+        }
+        case MCAF_BRAKING_SHORT:
+        {
+            /* Release the short once the current has decayed:
+             * the rotor is then too slow for braking to have any effect.
+             */
+            const MCAF_U_CURRENT current = 
+                UTIL_SatAddS16(UTIL_Abs16(pmotor->ialphabeta.alpha),
+                               UTIL_Abs16(pmotor->ialphabeta.beta));
+            if (current > MCAF_STOP_DETECT_CURRENT_THRESHOLD)
+            {
+                pstopping->quietCount = 0;
+            }
+            else
+            {
+                ++pstopping->quietCount;
+            }
+            if ((pstopping->quietCount >= MCAF_BRAKING_SHORT_QUIET_TIME)
+                || (++pstopping->brakingTimer >= MCAF_BRAKING_TIMEOUT))
+            {
+                MCAF_BrakingCoast(pmotor);
+            }
+            break;
+        }
+        default:
+            MCAF_MonitorStopDetectStep(pmotor);
+            break;
+    }
+}
+
 /**
  * Executes actions on entry to the STOPPING state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnStoppingInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnStoppingInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
-    if (MCAF_StoppingClosedLoopCurrent())
+    /* After a stall, the recovery module times the retry;
+     * the rotor coasts in the meantime, and startup catches it if it is
+     * still turning. */
+    const bool recovery = 
+        MCAF_RecoveryTestFlag(&pmotor->recovery, MCAF_RECOVERY_FSMO_STOP_MOTOR);
+    pmotor->stopping.recovery = recovery;
+    if (MCAF_StoppingClosedLoopCurrent() && !recovery)
     {
         pmotor->velocityControl.velocityCmd = 0;
         if (!MCAF_StoppingClosedLoopVelocity())
@@ -292,12 +456,20 @@ inline static void MCAF_MotorControllerOnStoppingInit(MCAF_MOTOR_DATA *pmotor)
             MCAF_ClearClosedLoopVelocity(pmotor);
         }
     }
+    else if (MCAF_StoppingActiveBraking() && MCAF_IsClosedLoopVelocity(pmotor) && !recovery)
+    {
+        pmotor->stopping.braking = MCAF_BRAKING_REGEN;
+        pmotor->stopping.brakingTimer = 0;
+        MCAF_BrakingDerateInit(pmotor);
+    }
     else
     {
         pmotor->omegaCmd = 0;
-        MCAF_SetPwmMinimalImpact();
+        MCAF_SetPwmMinimalImpact(pmotor);
         MCAF_ClearClosedLoopFlags(pmotor);
+        pmotor->stopping.braking = MCAF_BRAKING_COAST;
     }
+    MCAF_MonitorStopDetectReset(&pmotor->monitor.stopDetect);
     MCAF_IncrementStopCount(pmotor);
     MCAF_StoppingTimerReset(pmotor);
 }
@@ -306,25 +478,47 @@ inline static void MCAF_MotorControllerOnStoppingInit(MCAF_MOTOR_DATA *pmotor)
  * Executes actions in the STOPPING state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnStopping(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnStopping(MCAF_MOTOR_DATA *pmotor, bool init)
 {
     resetRecoveryIfNotRunRequested(pmotor);
-    if (MCAF_StoppingClosedLoopCurrent())
+    if (MCAF_StoppingClosedLoopCurrent() && !pmotor->stopping.recovery)
     {
         MCAF_MotorControllerOnActiveStates(pmotor);
     }
+    else
+    {
+        MCAF_BrakingStep(pmotor);
+    }
+}
+
+/**
+ * Executes actions on exit from the STOPPING state.
+ * 
+ * @param pmotor motor state data
+ * @param next_state state we are entering
+ */
+inline static void MCAF_MotorControllerOnStoppingExit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE next_state)
+{
+    /* Active braking may have been interrupted by a fault */
+    pmotor->velocityControl.slewRateLimitDecel = pmotor->config.velocitySlewRateLimitDecel;
+    pmotor->stopping.braking = MCAF_BRAKING_COAST;
 }
 
 /**
  * Executes actions on entry to the FAULT state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnFaultInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnFaultInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
     pmotor->ui.run = false;
-    MCAF_SetPwmMinimalImpact();
+    MCAF_SetPwmMinimalImpact(pmotor);
+    MCAF_MonitorStopDetectReset(&pmotor->monitor.stopDetect);
     MCAF_ClearClosedLoopFlags(pmotor);
 }
 
@@ -332,15 +526,16 @@ inline static void MCAF_MotorControllerOnFaultInit(MCAF_MOTOR_DATA *pmotor)
  * Executes actions in the FAULT state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnFault(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnFault(MCAF_MOTOR_DATA *pmotor, bool init)
 {
     if (MCAF_OvercurrentFaultClearBegin(&pmotor->faultHandle))
     {   
         /**
          * Clear latching PWM fault and delay for at least one ISR cycle.
          */
-        HAL_PWM_FaultClearBegin();
+        HAL_PWM_FaultClearBeginInstance(pmotor->phal);
         MCAF_FocRestart(pmotor);
     } 
     else if (MCAF_OvercurrentFaultClearContinue(&pmotor->faultHandle))
@@ -353,8 +548,10 @@ inline static void MCAF_MotorControllerOnFault(MCAF_MOTOR_DATA *pmotor)
  * Executes actions on entry to the TEST_DISABLE state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnTestDisableInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnTestDisableInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
     /* do nothing */
 }
@@ -363,10 +560,11 @@ inline static void MCAF_MotorControllerOnTestDisableInit(MCAF_MOTOR_DATA *pmotor
  * Executes actions in the TEST_DISABLE state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnTestDisable(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnTestDisable(MCAF_MOTOR_DATA *pmotor, bool init)
 {
-    MCAF_SetPwmMinimalImpact();
+    MCAF_SetPwmMinimalImpact(pmotor);
 }
 
 /**
@@ -395,7 +593,7 @@ inline static void MCAF_MotorControllerOnTestRestart(MCAF_MOTOR_DATA *pmotor, bo
          */
         MCAF_BootstrapChargeInit(&pmotor->bootstrap);
         MCAF_ADCCompensationInit(&pmotor->initialization, &pmotor->currentCalibration);
-        HAL_PWM_FaultClearBegin();
+        HAL_PWM_FaultClearBeginInstance(pmotor->phal);
         MCAF_UiRestart(&pmotor->ui);
         MCAF_FocRestart(pmotor);
         
@@ -420,7 +618,7 @@ inline static void MCAF_MotorControllerOnTestRestart(MCAF_MOTOR_DATA *pmotor, bo
         if (MCAF_GateDriverReady(&pmotor->psys->board.gateDriver))
 #endif
         {
-            bool bootstrapComplete = MCAF_BootstrapChargeStepIsr(&pmotor->bootstrap);
+            bool bootstrapComplete = MCAF_BootstrapChargeStepIsr(&pmotor->bootstrap, pmotor->phal);
             if (bootstrapComplete)
             {
                 /* Tasks requiring PWM to be ready. */
@@ -438,8 +636,10 @@ inline static void MCAF_MotorControllerOnTestRestart(MCAF_MOTOR_DATA *pmotor, bo
  * Executes actions on entry to the TEST_ENABLE state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnTestEnableInit(MCAF_MOTOR_DATA *pmotor, MCAF_FSM_STATE previous_state)
+inline static void MCAF_MotorControllerOnTestEnableInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
     /* Special-case entering the enable state from the following circumstance:
      * - STARTUP_PAUSE override flag set
@@ -456,7 +656,7 @@ inline static void MCAF_MotorControllerOnTestEnableInit(MCAF_MOTOR_DATA *pmotor,
     }
     else
     {
-        EnablePwmMinDuty();
+        EnablePwmMinDuty(pmotor);
     }
 }
 
@@ -464,8 +664,9 @@ inline static void MCAF_MotorControllerOnTestEnableInit(MCAF_MOTOR_DATA *pmotor,
  * Executes actions in the TEST_ENABLE state.
  * 
  * @param pmotor motor state data
+ * @param init whether this is the first step after entry
  */
-inline static void MCAF_MotorControllerOnTestEnable(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnTestEnable(MCAF_MOTOR_DATA *pmotor, bool init)
 {
     MCAF_MotorControllerOnActiveStates(pmotor);
 }
@@ -474,8 +675,10 @@ inline static void MCAF_MotorControllerOnTestEnable(MCAF_MOTOR_DATA *pmotor)
  * Executes actions on entry to the RESTART state.
  * 
  * @param pmotor motor state data
+ * @param previous_state state we are leaving
  */
-inline static void MCAF_MotorControllerOnRestartInit(MCAF_MOTOR_DATA *pmotor)
+inline static void MCAF_MotorControllerOnRestartInit(MCAF_MOTOR_DATA *pmotor,
+        MCAF_FSM_STATE previous_state)
 {
     /* 
      * Put PWMs in a safe state to keep gate drive going.
@@ -483,7 +686,7 @@ inline static void MCAF_MotorControllerOnRestartInit(MCAF_MOTOR_DATA *pmotor)
      */
     MCAF_BootstrapChargeInit(&pmotor->bootstrap);
     MCAF_ADCCompensationInit(&pmotor->initialization, &pmotor->currentCalibration);
-    HAL_PWM_FaultClearBegin();
+    HAL_PWM_FaultClearBeginInstance(pmotor->phal);
     
     MCAF_FocRestart(pmotor);
     
@@ -552,7 +755,7 @@ inline static void MCAF_MotorControllerOnRestart(MCAF_MOTOR_DATA *pmotor, bool i
         if (MCAF_GateDriverReady(&pmotor->psys->board.gateDriver))
 #endif
         {
-            bool bootstrapComplete = MCAF_BootstrapChargeStepIsr(&pmotor->bootstrap);
+            bool bootstrapComplete = MCAF_BootstrapChargeStepIsr(&pmotor->bootstrap, pmotor->phal);
             if (bootstrapComplete)
             {
                 /* Tasks requiring PWM to be ready. */
@@ -593,6 +796,10 @@ inline static void MCAF_MotorControllerOnAllStatesLowPriority(MCAF_MOTOR_DATA *p
 
 inline static bool stopping_complete(MCAF_MOTOR_DATA *pmotor)
 {
+    if (pmotor->stopping.recovery)
+    {
+        return true;
+    }
     if (MCAF_StoppingClosedLoopCurrent())
     {
         // Reset timer if the speed is too high
@@ -603,16 +810,293 @@ inline static bool stopping_complete(MCAF_MOTOR_DATA *pmotor)
             return false;
         }
     }
+    else if (pmotor->stopping.braking != MCAF_BRAKING_COAST)
+    {
+        /* Active braking bounds its own duration and ends by coasting */
+        return false;
+    }
 
     const bool timerExpired = MCAF_StoppingTimerUpdate(pmotor);
-    const bool acceptTimerExpiration = MCAF_StoppingClosedLoopCurrent() || MCAF_MonitorIsMotorStopped(pmotor);
-    return acceptTimerExpiration && timerExpired;
+    if (MCAF_StoppingClosedLoopCurrent())
+    {
+        return timerExpired;
+    }
+    /* When coasting, the timer covers the worst-case coastdown time;
+     * finish early once the rotor is detected at standstill. */
+    return timerExpired || MCAF_MonitorIsMotorStopped(pmotor);
+}
+
+/**
+ * Transition from the RESTART state
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromRestart(uint16_t events, uint16_t *pcause)
+{
+    MCAF_FSM_STATE next_state = MCSM_RESTART;
+    if (events & MCAF_FSM_EV_RESTART_COMPLETE)
+    {
+        *pcause = MCAF_FSM_EV_RESTART_COMPLETE;
+        if (MCAF_StoppingClosedLoopCurrent() 
+                && !(events & MCAF_FSM_EV_STARTUP_COMPLETE))
+        {
+            next_state = MCSM_STOPPED;
+        }
+        else
+        {
+            next_state = MCSM_STOPPING;
+        }
+    }
+    return next_state;
+}
+
+/**
+ * Transition from the STOPPED state
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromStopped(uint16_t events, uint16_t *pcause)
+{
+    if (events & MCAF_FSM_EV_RUN)
+    {
+        *pcause = MCAF_FSM_EV_RUN;
+        return MCSM_STARTING;
+    }
+    return MCSM_STOPPED;
+}
+
+/**
+ * Transition from the STARTING state
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromStarting(uint16_t events, uint16_t *pcause)
+{
+    if (!(events & MCAF_FSM_EV_RUN))
+    {
+        *pcause = MCAF_FSM_EV_RUN;
+        return MCSM_STOPPING;
+    }
+    if (events & MCAF_FSM_EV_STARTUP_COMPLETE)
+    {
+        *pcause = MCAF_FSM_EV_STARTUP_COMPLETE;
+        return MCSM_RUNNING;
+    }
+    return MCSM_STARTING;
+}
+
+/**
+ * Transition from the RUNNING state
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromRunning(uint16_t events, uint16_t *pcause)
+{
+    if (!(events & MCAF_FSM_EV_RUN))
+    {
+        *pcause = MCAF_FSM_EV_RUN;
+        return MCSM_STOPPING;
+    }
+    return MCSM_RUNNING;
+}
+
+/**
+ * Transition from the STOPPING state
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromStopping(uint16_t events, uint16_t *pcause)
+{
+    const uint16_t resumeEvents = MCAF_FSM_EV_RUN | MCAF_FSM_EV_STARTUP_COMPLETE;
+    if (MCAF_StoppingClosedLoopCurrent() 
+            && ((events & resumeEvents) == resumeEvents))
+    {
+        *pcause = MCAF_FSM_EV_RUN;
+        return MCSM_RUNNING;
+    }
+    if (events & MCAF_FSM_EV_STOP_COMPLETE)
+    {
+        *pcause = MCAF_FSM_EV_STOP_COMPLETE;
+        return MCSM_STOPPED;
+    }
+    return MCSM_STOPPING;
+}
+
+/**
+ * Transition from the FAULT state
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromFault(uint16_t events, uint16_t *pcause)
+{
+    if (events & MCAF_FSM_EV_EXIT_FAULT)
+    {
+        *pcause = MCAF_FSM_EV_EXIT_FAULT;
+        return MCSM_RESTART;
+    }
+    return MCSM_FAULT;
+}
+
+/**
+ * Transition from any of the test states, when operating mode is normal:
+ * always go through a restart.
+ * 
+ * @param events current state machine events
+ * @param pcause event responsible for the transition
+ * @return next state
+ */
+static MCAF_FSM_STATE MCAF_FSM_TransitionFromTestState(uint16_t events, uint16_t *pcause)
+{
+    *pcause = MCAF_FSM_EV_TEST_MODE;
+    return MCSM_RESTART;
+}
+
+/**
+ * Transition handlers for one state of the top-level state machine.
+ * 
+ * These only run when the state changes or its events change; the
+ * per-step actions are dispatched by MCAF_FSM_Dispatch() with a switch
+ * so that they stay inline in the ISR.
+ */
+typedef struct tagMCAF_FSM_STATE_HANDLERS
+{
+    /** action on entry to the state */
+    void (*onEntry)(MCAF_MOTOR_DATA *pmotor, MCAF_FSM_STATE previous_state);
+    /** action on exit from the state (optional) */
+    void (*onExit)(MCAF_MOTOR_DATA *pmotor, MCAF_FSM_STATE next_state);
+    /** 
+     * Determines next state in the primary modes; must depend only
+     * on the events, so it need not be evaluated unless they change
+     */
+    MCAF_FSM_STATE (*transition)(uint16_t events, uint16_t *pcause);
+    /** events that influence the transition */
+    uint16_t eventMask;
+} MCAF_FSM_STATE_HANDLERS;
+
+/**
+ * State transition table, indexed by MCAF_FSM_STATE
+ */
+static const MCAF_FSM_STATE_HANDLERS fsmHandlers[] = 
+{
+    [MCSM_RESTART] = {
+        MCAF_MotorControllerOnRestartInit,
+        NULL,
+        MCAF_FSM_TransitionFromRestart,
+        MCAF_FSM_EV_RESTART_COMPLETE | MCAF_FSM_EV_STARTUP_COMPLETE
+    },
+    [MCSM_STOPPED] = {
+        MCAF_MotorControllerOnStoppedInit,
+        NULL,
+        MCAF_FSM_TransitionFromStopped,
+        MCAF_FSM_EV_RUN
+    },
+    [MCSM_STARTING] = {
+        MCAF_MotorControllerOnStartingInit,
+        NULL,
+        MCAF_FSM_TransitionFromStarting,
+        MCAF_FSM_EV_RUN | MCAF_FSM_EV_STARTUP_COMPLETE
+    },
+    [MCSM_RUNNING] = {
+        MCAF_MotorControllerOnRunningInit,
+        NULL,
+        MCAF_FSM_TransitionFromRunning,
+        MCAF_FSM_EV_RUN
+    },
+    [MCSM_STOPPING] = {
+        MCAF_MotorControllerOnStoppingInit,
+        MCAF_MotorControllerOnStoppingExit,
+        MCAF_FSM_TransitionFromStopping,
+        MCAF_FSM_EV_RUN | MCAF_FSM_EV_STARTUP_COMPLETE | MCAF_FSM_EV_STOP_COMPLETE
+    },
+    [MCSM_FAULT] = {
+        MCAF_MotorControllerOnFaultInit,
+        NULL,
+        MCAF_FSM_TransitionFromFault,
+        MCAF_FSM_EV_EXIT_FAULT
+    },
+    [MCSM_TEST_DISABLE] = {
+        MCAF_MotorControllerOnTestDisableInit,
+        NULL,
+        MCAF_FSM_TransitionFromTestState,
+        MCAF_FSM_EV_NONE
+    },
+    [MCSM_TEST_ENABLE] = {
+        MCAF_MotorControllerOnTestEnableInit,
+        NULL,
+        MCAF_FSM_TransitionFromTestState,
+        MCAF_FSM_EV_NONE
+    },
+    [MCSM_TEST_RESTART] = {
+        NULL,
+        NULL,
+        MCAF_FSM_TransitionFromTestState,
+        MCAF_FSM_EV_NONE
+    }
+};
+
+#define MCAF_FSM_STATE_COUNT (sizeof(fsmHandlers)/sizeof(fsmHandlers[0]))
+
+/**
+ * Gathers the events relevant to the current state.
+ * 
+ * Some events are only computed when the current state needs them,
+ * since they have side effects (e.g. stopping timer update).
+ *
+ * @param pmotor motor data
+ * @param eventMask events of interest
+ * @return event bitmask
+ */
+inline static uint16_t MCAF_FSM_GatherEvents(MCAF_MOTOR_DATA *pmotor, uint16_t eventMask)
+{
+    uint16_t events = MCAF_FSM_EV_NONE;
+    
+    const bool directionChanged = MCAF_TestAndClearDirectionChangeFlag(&pmotor->ui);
+    const bool run_requested = pmotor->ui.run && !directionChanged;
+    const bool run_permitted =
+        MCAF_MonitorIsRunPermitted(pmotor)
+     || MCAF_OverrideStallDetection(&pmotor->testing);
+    if (run_requested && run_permitted)
+    {
+        events |= MCAF_FSM_EV_RUN;
+    }
+    if (MCAF_StartupHasCompleted(&pmotor->startup))
+    {
+        events |= MCAF_FSM_EV_STARTUP_COMPLETE;
+    }
+    if (pmotor->ui.exitFaultState)
+    {
+        events |= MCAF_FSM_EV_EXIT_FAULT;
+    }
+    if ((eventMask & MCAF_FSM_EV_RESTART_COMPLETE) && restartStateComplete(pmotor))
+    {
+        events |= MCAF_FSM_EV_RESTART_COMPLETE;
+    }
+    if ((eventMask & MCAF_FSM_EV_STOP_COMPLETE) && stopping_complete(pmotor))
+    {
+        events |= MCAF_FSM_EV_STOP_COMPLETE;
+    }
+    return events & eventMask;
 }
 
 /**
  * Determines transition in state machine in the primary modes 
  * (those modes aside from test modes)
  *
+ * The transition function of the current state is only evaluated
+ * on entry to that state, or when any of its events change.
+ * 
  * Side effect: report any new error to the UI.
  * 
  * @param pmotor motor data
@@ -636,82 +1120,27 @@ inline static MCAF_FSM_STATE MCAF_FSM_DetermineNextState(MCAF_MOTOR_DATA *pmotor
     if (operating_fault_detected)
     {
         next_state = MCSM_FAULT;
+        pmotor->fsm.cause = MCAF_FSM_EV_FAULT;
         const uint16_t error_code = MCAF_GetFaultCode(pmotor);
         MCAF_UiRecordNewError(&pmotor->ui.indicatorState, error_code);
+        MCAF_EventPublish(pmotor, MCAF_EVENT_FAULT, error_code);
     }
-    else
+    else if (this_state < MCAF_FSM_STATE_COUNT)
     {
-        const bool directionChanged = MCAF_TestAndClearDirectionChangeFlag(&pmotor->ui);
-        const bool run_requested = pmotor->ui.run && !directionChanged;
-        const bool run_permitted =
-            MCAF_MonitorIsRunPermitted(pmotor)
-         || MCAF_OverrideStallDetection(&pmotor->testing);
-        const bool run = run_requested && run_permitted;
-        switch (this_state)
+        const MCAF_FSM_STATE_HANDLERS *phandlers = &fsmHandlers[this_state];
+        const uint16_t events = MCAF_FSM_GatherEvents(pmotor, phandlers->eventMask);
+        if (pmotor->fsm.reevaluate || (events != pmotor->fsm.events))
         {
-            case MCSM_RESTART:
-                {
-                    if (restartStateComplete(pmotor))
-                    {
-                        if (MCAF_StoppingClosedLoopCurrent() 
-                                && !MCAF_StartupHasCompleted(&pmotor->startup))
-                        {
-                            next_state = MCSM_STOPPED;
-                        }
-                        else
-                        {
-                            next_state = MCSM_STOPPING;
-                        }
-                    }
-                }
-                break;
-            case MCSM_STOPPED:
-                if (run) 
-                {
-                    next_state = MCSM_STARTING;
-                }
-                break;
-            case MCSM_STARTING:
-                if (!run)
-                {
-                    next_state = MCSM_STOPPING;
-                }
-                else if (MCAF_StartupHasCompleted(&pmotor->startup))
-                {
-                    next_state = MCSM_RUNNING;
-                }
-                break;
-            case MCSM_RUNNING:
-                if (!run)
-                {
-                    next_state = MCSM_STOPPING;
-                }
-                break;
-            case MCSM_STOPPING:
-                if (MCAF_StoppingClosedLoopCurrent() 
-                        && run
-                        && MCAF_StartupHasCompleted(&pmotor->startup))
-                {
-                    next_state = MCSM_RUNNING;
-                }
-                else if (stopping_complete(pmotor))
-                {
-                    next_state = MCSM_STOPPED;
-                }
-                break;
-            case MCSM_FAULT:
-                {
-                    const bool ok_to_restart = pmotor->ui.exitFaultState;
-                    if (ok_to_restart)
-                    {
-                        next_state = MCSM_RESTART;
-                    }
-                }
-                break;
-            default:
-                next_state = MCSM_RESTART;
+            pmotor->fsm.reevaluate = false;
+            pmotor->fsm.events = events;
+            next_state = phandlers->transition(events, &pmotor->fsm.cause);
         }
     }
+    else
+    {
+        next_state = MCSM_RESTART;
+        pmotor->fsm.cause = MCAF_FSM_EV_NONE;
+    }
     pmotor->ui.exitFaultState = false;   // clear any pending requests
     return next_state;
 }
@@ -735,8 +1164,10 @@ inline static MCAF_FSM_STATE MCAF_FSM_DetermineNextStateTestMode(MCAF_MOTOR_DATA
     if (test_fault_newly_detected)
     {
         next_state = MCSM_FAULT;
+        pmotor->fsm.cause = MCAF_FSM_EV_FAULT;
         const uint16_t error_code = MCAF_GetFaultCode(pmotor);
         MCAF_UiRecordNewError(&pmotor->ui.indicatorState, error_code);
+        MCAF_EventPublish(pmotor, MCAF_EVENT_FAULT, error_code);
     }
     else
     {
@@ -748,6 +1179,7 @@ inline static MCAF_FSM_STATE MCAF_FSM_DetermineNextStateTestMode(MCAF_MOTOR_DATA
                 if (ok_to_restart)
                 {
                     next_state = MCSM_TEST_RESTART;
+                    pmotor->fsm.cause = MCAF_FSM_EV_EXIT_FAULT;
                 }
             }
             break;
@@ -756,6 +1188,7 @@ inline static MCAF_FSM_STATE MCAF_FSM_DetermineNextStateTestMode(MCAF_MOTOR_DATA
                 if (restartStateComplete(pmotor))
                 {
                     next_state = MCSM_TEST_DISABLE;
+                    pmotor->fsm.cause = MCAF_FSM_EV_RESTART_COMPLETE;
                 }        
             }
             break;
@@ -776,6 +1209,7 @@ inline static MCAF_FSM_STATE MCAF_FSM_DetermineNextStateTestMode(MCAF_MOTOR_DATA
              *   goes through MCSM_TEST_RESTART first,
              *   then switches to MCSM_TEST_ENABLE
              */
+            pmotor->fsm.cause = MCAF_FSM_EV_TEST_MODE;
             if (MCAF_GetOperatingMode(&pmotor->testing) == OM_DISABLED)
             {
                 next_state = MCSM_TEST_DISABLE;
@@ -798,7 +1232,29 @@ inline static MCAF_FSM_STATE MCAF_FSM_DetermineNextStateTestMode(MCAF_MOTOR_DATA
 }
 
 /**
- * Performs actions appropriate in each state, including on-entry actions
+ * Records a state transition in the transition log.
+ * 
+ * @param pfsm state machine bookkeeping data
+ * @param from state we are leaving
+ * @param to state we are entering
+ */
+inline static void MCAF_FSM_TraceRecord(MCAF_FSM_DATA_T *pfsm,
+        MCAF_FSM_STATE from, MCAF_FSM_STATE to)
+{
+    MCAF_FSM_TRACE_T *ptrace = &pfsm->trace;
+    MCAF_FSM_TRANSITION_T *pentry = &ptrace->entry[ptrace->head];
+    pentry->timestamp = pfsm->isrCount;
+    pentry->from = from;
+    pentry->to = to;
+    pentry->cause = pfsm->cause;
+    pentry->events = pfsm->events;
+    ptrace->head = (ptrace->head + 1) & (MCAF_FSM_TRACE_LENGTH - 1);
+    ++ptrace->count;
+}
+
+/**
+ * Performs actions appropriate in each state, including on-entry 
+ * and on-exit actions
  * 
  * @param pmotor motor state data
  * @param next_state the next state of the state machine
@@ -807,68 +1263,54 @@ inline static void MCAF_FSM_Dispatch(MCAF_MOTOR_DATA *pmotor, MCAF_FSM_STATE nex
 {
     const MCAF_FSM_STATE this_state = pmotor->state;
     const bool state_changed = (next_state != this_state);
+    const MCAF_FSM_STATE_HANDLERS *phandlers = &fsmHandlers[next_state];
+    
+    if (state_changed)
+    {
+        if ((this_state < MCAF_FSM_STATE_COUNT) && fsmHandlers[this_state].onExit)
+        {
+            fsmHandlers[this_state].onExit(pmotor, next_state);
+        }
+        MCAF_FSM_TraceRecord(&pmotor->fsm, this_state, next_state);
+        MCAF_EventPublish(pmotor, MCAF_EVENT_STATE_CHANGE, 
+                          ((uint16_t)this_state << 8) | next_state);
+        pmotor->fsm.reevaluate = true;
+    }
     pmotor->state = next_state;
     
+    if (state_changed && phandlers->onEntry)
+    {
+        phandlers->onEntry(pmotor, this_state);
+    }
+    
     switch (next_state)
     {
         case MCSM_RESTART:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnRestartInit(pmotor);
-            }
             MCAF_MotorControllerOnRestart(pmotor, state_changed);
             break;
         case MCSM_STOPPED:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnStoppedInit(pmotor);
-            }
-            MCAF_MotorControllerOnStopped(pmotor);
+            MCAF_MotorControllerOnStopped(pmotor, state_changed);
             break;
         case MCSM_STARTING:
-            if (state_changed)
-            {
-               MCAF_MotorControllerOnStartingInit(pmotor);
-            }
-            MCAF_MotorControllerOnStarting(pmotor);
+            MCAF_MotorControllerOnStarting(pmotor, state_changed);
             break;
         case MCSM_RUNNING:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnRunningInit(pmotor);
-            }
-            MCAF_MotorControllerOnRunning(pmotor);
+            MCAF_MotorControllerOnRunning(pmotor, state_changed);
             break;
         case MCSM_STOPPING:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnStoppingInit(pmotor);
-            }
-            MCAF_MotorControllerOnStopping(pmotor);
+            MCAF_MotorControllerOnStopping(pmotor, state_changed);
             break;                    
         case MCSM_FAULT:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnFaultInit(pmotor);
-            }
-            MCAF_MotorControllerOnFault(pmotor);
+            MCAF_MotorControllerOnFault(pmotor, state_changed);
             break;                    
         case MCSM_TEST_DISABLE:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnTestDisableInit(pmotor);
-            }
-            MCAF_MotorControllerOnTestDisable(pmotor);
+            MCAF_MotorControllerOnTestDisable(pmotor, state_changed);
             break;                    
         case MCSM_TEST_RESTART:
             MCAF_MotorControllerOnTestRestart(pmotor, state_changed);
             break;
         case MCSM_TEST_ENABLE:
-            if (state_changed)
-            {
-                MCAF_MotorControllerOnTestEnableInit(pmotor, this_state);
-            }
-            MCAF_MotorControllerOnTestEnable(pmotor);
+            MCAF_MotorControllerOnTestEnable(pmotor, state_changed);
             break;
     }    
 }
@@ -879,6 +1321,7 @@ inline static void MCAF_FSM_Dispatch(MCAF_MOTOR_DATA *pmotor, MCAF_FSM_STATE nex
 void MCAF_SystemStateMachine_StepIsr(MCAF_MOTOR_DATA *pmotor)
 {
     MCAF_CaptureTimestamp(&pmotor->testing, MCTIMESTAMP_STATEMACH_START);
+    ++pmotor->fsm.isrCount;
 
     /* 1. Perform critical tasks that are independent of the state. */
     MCAF_MotorControllerOnAllStates(pmotor);
@@ -894,6 +1337,13 @@ void MCAF_SystemStateMachine_StepIsr(MCAF_MOTOR_DATA *pmotor)
     #else
         MCAF_FSM_DetermineNextState(pmotor);
     #endif
+#ifdef MCAF_TEST_HARNESS
+    if (pmotor->testing.operatingMode != OM_NORMAL)
+    {
+        /* Events are not tracked in test modes: start afresh on return to normal */
+        pmotor->fsm.reevaluate = true;
+    }
+#endif
 
     MCAF_CaptureTimestamp(&pmotor->testing, MCTIMESTAMP_STATEMACH_NEXT_STATE);
     
@@ -912,12 +1362,20 @@ void MCAF_SystemStateMachine_Init(MCAF_MOTOR_DATA *pmotor)
 {
     pmotor->state = MCSM_RESTART;
     pmotor->stateFlags = 0;
+    pmotor->fsm.isrCount = 0;
+    pmotor->fsm.events = MCAF_FSM_EV_NONE;
+    pmotor->fsm.cause = MCAF_FSM_EV_NONE;
+    pmotor->fsm.reevaluate = true;
+    pmotor->fsm.trace.head = 0;
+    pmotor->fsm.trace.count = 0;
     pmotor->stopping.timer.duration = MCAF_StoppingClosedLoopCurrent()
                                  ? MCAF_CLOSED_LOOP_STOPPING_TIME
                                  : VELOCITY_COASTDOWN_TIME;        
     pmotor->stopping.speedThreshold = MCAF_CLOSED_LOOP_STOPPING_SPEED;
+    pmotor->stopping.braking = MCAF_BRAKING_COAST;
+    pmotor->stopping.recovery = false;
     MCAF_TestHarness_Init(&pmotor->testing);
-    MCAF_MotorControllerOnRestartInit(pmotor);    
+    MCAF_MotorControllerOnRestartInit(pmotor, MCSM_RESTART);    
     MCAF_CommutationInit(pmotor);
     MCAF_FaultLatch_PowerupInit(&pmotor->faultHandle);
     
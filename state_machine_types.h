@@ -47,6 +47,9 @@
 #ifndef __STATE_MACHINE_TYPES_H
 #define __STATE_MACHINE_TYPES_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -67,6 +70,16 @@ typedef enum tagMCAF_FSM_STATE
     MCSM_TEST_RESTART = 8   /** test mode: clean restart prior to enable */
 } MCAF_FSM_STATE;
 
+/**
+ * Active braking phases of the STOPPING state
+ */
+typedef enum tagMCAF_BRAKING_PHASE
+{
+    MCAF_BRAKING_COAST = 0,  /** no active braking, PWM outputs in minimal-impact state */
+    MCAF_BRAKING_REGEN = 1,  /** closed-loop velocity ramp towards zero, returning energy to the DC link */
+    MCAF_BRAKING_SHORT = 2   /** motor terminals shorted by the lower transistors */
+} MCAF_BRAKING_PHASE;
+
 /**
  * Stopping timer state
  */
@@ -78,8 +91,72 @@ typedef struct tagStopping
         uint16_t rate;    /** rate at which timer decrements */
     } timer;              /** timer state */
     MCAF_U_VELOCITY_ELEC speedThreshold; /** threshold for declaring stopping is complete */
+    MCAF_BRAKING_PHASE braking; /** active braking phase */
+    uint16_t brakingTimer;      /** ISR cycles spent in the active braking phase */
+    uint16_t quietCount;        /** consecutive ISR cycles of shorted-terminal current below threshold */
+    int16_t vdcDerateStart;     /** DC link voltage above which regenerative braking is derated */
+    int16_t vdcDerateEnd;       /** DC link voltage at which regenerative braking stops decelerating */
+    bool recovery;              /** stopping for a stall recovery: coast, and complete at once */
 } MCAF_STOPPING_STATE;
 
+/**
+ * Events that determine transitions of the top-level state machine.
+ * 
+ * These are gathered once per ISR into a bitmask; each state only
+ * re-evaluates its transition when the events it cares about change.
+ */
+typedef enum tagMCAF_FSM_EVENT
+{
+    MCAF_FSM_EV_NONE             = 0x0000, /** no event */
+    MCAF_FSM_EV_FAULT            = 0x0001, /** new fault detected */
+    MCAF_FSM_EV_RUN              = 0x0002, /** run requested and permitted */
+    MCAF_FSM_EV_STARTUP_COMPLETE = 0x0004, /** open-loop startup has completed */
+    MCAF_FSM_EV_RESTART_COMPLETE = 0x0008, /** restart sequence has completed */
+    MCAF_FSM_EV_STOP_COMPLETE    = 0x0010, /** stopping criteria have been met */
+    MCAF_FSM_EV_EXIT_FAULT       = 0x0020, /** request to leave the fault state */
+    MCAF_FSM_EV_TEST_MODE        = 0x0040  /** test harness operating mode */
+} MCAF_FSM_EVENT;
+
+/** Number of entries in the state transition log (must be a power of 2) */
+#define MCAF_FSM_TRACE_LENGTH 16
+
+/**
+ * Record of a single state transition
+ */
+typedef struct tagMCAF_FSM_TRANSITION
+{
+    uint32_t timestamp; /** ISR count at the time of the transition */
+    uint8_t  from;      /** state we left (MCAF_FSM_STATE) */
+    uint8_t  to;        /** state we entered (MCAF_FSM_STATE) */
+    uint8_t  cause;     /** event that triggered the transition (MCAF_FSM_EVENT) */
+    uint8_t  events;    /** events present when the transition was evaluated */
+} MCAF_FSM_TRANSITION_T;
+
+/**
+ * State transition log, organized as a ring buffer
+ * 
+ * The time spent in any state is the difference in timestamps
+ * between consecutive entries.
+ */
+typedef struct tagMCAF_FSM_TRACE
+{
+    MCAF_FSM_TRANSITION_T entry[MCAF_FSM_TRACE_LENGTH]; /** transition records */
+    uint16_t head;      /** index of the next entry to be written */
+    uint16_t count;     /** number of transitions recorded (wraps around) */
+} MCAF_FSM_TRACE_T;
+
+/**
+ * Bookkeeping for the table-driven state machine
+ */
+typedef struct tagMCAF_FSM_DATA
+{
+    uint32_t isrCount;  /** free-running ISR count, used as a timestamp */
+    uint16_t events;    /** events seen by the last transition evaluation */
+    uint16_t cause;     /** event that caused the pending transition */
+    bool reevaluate;    /** force evaluation of the transition on the next step */
+    MCAF_FSM_TRACE_T trace; /** state transition log */
+} MCAF_FSM_DATA_T;
+
 #ifdef __cplusplus
 }
 #endif
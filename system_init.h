@@ -79,10 +79,14 @@ void MCAF_SystemStart(MCAF_SYSTEM_DATA *psys);
 inline static void MCAF_ConfigurationPwmUpdate(void)
 {
     HAL_PWM_SetPeriodIdentical(HAL_PARAM_PWM_PERIOD_COUNTS);
-    HAL_PWM_SetDeadtimeIdentical_Motor1(HAL_PARAM_DEADTIME_COUNTS);
-    HAL_PWM_SetADCTrigger();
-    HAL_PWM_DutyCycle_SetIdentical(HAL_PARAM_MIN_DUTY_COUNTS);
-    HAL_PWM_Outputs_Disable();
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        const HAL_MOTOR_MAP_T *phal = &halMotorMap[i];
+        HAL_PWM_SetDeadtimeIdenticalInstance(phal, HAL_PARAM_DEADTIME_COUNTS);
+        HAL_PWM_SetADCTriggerInstance(phal);
+        HAL_PWM_DutyCycle_SetIdenticalInstance(phal, HAL_PARAM_MIN_DUTY_COUNTS);
+        HAL_PWM_Outputs_DisableInstance(phal);
+    }
 }
 
 #ifdef __cplusplus
@@ -46,7 +46,9 @@
 
 #include "system_state.h"
 
-void MCAF_SystemStateInit(MCAF_MOTOR_DATA *pmotor, MCAF_SYSTEM_DATA *psys)
+void MCAF_SystemStateInit(MCAF_MOTOR_DATA *pmotor, MCAF_SYSTEM_DATA *psys,
+                          const HAL_MOTOR_MAP_T *phal)
 {
     pmotor->psys = psys;
+    pmotor->phal = phal;
 }
@@ -74,6 +74,10 @@
 #include "current_measure_types.h"
 #include "hal/hardware_access_functions_types.h"
 #include "mcapi_types.h"
+#include "event_queue.h"
+#include "param_id_types.h"
+#include "param_adapt_types.h"
+#include "flight_recorder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -162,6 +166,7 @@ typedef struct tagMOTOR
     MCAF_U_DUTYCYCLE_ABC pwmDutycycle;   /** PWM count */
     MCAF_FLUX_CONTROL_STATE_T fluxControl; /** flux-control state */
     MCAF_FILTER_LOW_PASS_S16_T vqFiltered; /** filtered q-axis voltage, for feedback purposes */
+    MCAF_PARAM_ADAPT_T paramAdapt;       /** online Rs/Ke adaptation state */
     MCAF_CURRENT_MEASUREMENT currentMeasure; /** current measure state */
 
     /* Angle and speed, including estimators */
@@ -176,6 +181,8 @@ typedef struct tagMOTOR
    
     MCAF_PISTATE_T      omegaCtrl;  /** controller state for the velocity loop */
     MCAF_VELOCITY_CONTROL_DATA velocityControl; /** Control inputs for the velocity loop */
+    MCAF_TORQUE_CONTROL_DATA torqueControl; /** Control inputs for torque control */
+    MCAF_POSITION_CONTROL_DATA positionControl; /** Control inputs for the position loop */
     MCAF_U_CURRENT    iqTorqueCmd;  /** output of the velocity loop */
     uint16_t          controlFlags; /** MCAF_CTRL_FLAGS bitfields */
     uint16_t          stateFlags;   /** MCAF_STATE_FLAGS bitfields */    
@@ -188,6 +195,7 @@ typedef struct tagMOTOR
     MCAF_MOTOR_STARTUP_DATA    startup;  /** State variables for the startup code */
     
     MCAF_FSM_STATE      state;           /** motor control state machine state */
+    MCAF_FSM_DATA_T     fsm;             /** state machine events and transition log */
     
     MCAF_BOOTSTRAP_STATE bootstrap;      /** Bootstrap charging routine state */
     
@@ -208,6 +216,7 @@ typedef struct tagMOTOR
     volatile MCAF_MOTOR_TEST_MANAGER testing;
     
     MCAF_SYSTEM_DATA *psys;       /** pointer to shared system state */
+    const HAL_MOTOR_MAP_T *phal;  /** peripheral resources of this motor instance */
     MCAF_SAT_DETECT_T sat;        /** saturation detection */
     MCAF_STOPPING_STATE stopping; /** Stopping timer state */
 
@@ -223,6 +232,9 @@ typedef struct tagMOTOR
          *  to match the delay of the current feedback signals
          */
         uint16_t deadTimeCompensationVoltageDelay;  
+        /** velocity command slew rate limits, applied at each restart */
+        int16_t velocitySlewRateLimitAccel;
+        int16_t velocitySlewRateLimitDecel;
     } config;
     
     /** MCAPI related shared data */
@@ -238,6 +250,12 @@ typedef struct tagMOTOR
     MCAF_U_CURRENT iDC;
     /** measured absolute voltage reference */
     uint16_t vAbsRef;
+#if MCAF_INCLUDE_PARAM_ID
+    MCAF_PARAMID_T paramId;              /** on-target parameter identification */
+#endif
+#if MCAF_INCLUDE_FLIGHT_RECORDER
+    MCAF_RECORDER_T recorder;            /** flight recorder */
+#endif
 #if MCAF_TRIGGERED_AVERAGE_EXAMPLE == 1
     MCAF_TRIGGERED_AVERAGE_T iqAverage;  /** Triggered average example implementation */
 #endif
@@ -252,24 +270,48 @@ inline static void MCAF_IncrementStopCount(MCAF_MOTOR_DATA *pmotor)
     ++pmotor->psys->debugCounters.stop;
 }
 
+/**
+ * Posts an event from the ISR to the application.
+ * 
+ * @param pmotor motor state
+ * @param type event type
+ * @param payload event-specific data
+ */
+inline static void MCAF_EventPublish(MCAF_MOTOR_DATA *pmotor, MCAF_EVENT_TYPE type, uint16_t payload)
+{
+    const uint32_t timestamp = pmotor->fsm.isrCount;
+    MCAF_EventQueuePost(&pmotor->apiData.events, type, payload, timestamp);
+#if MCAF_INCLUDE_FLIGHT_RECORDER
+    MCAF_RecorderTrigger(&pmotor->recorder, type, payload, timestamp);
+#endif
+}
+
 /**
  * Returns the upper current limit value
+ * 
+ * In torque control the velocity controller output is clamped to the 
+ * torque reference as well, so the current limit is returned instead.
+ * 
  * @param pmotor motor data
  * @return upper current limit value
  */
 static inline int16_t MCAF_CurrentLimitIqUpperGet(volatile MCAF_MOTOR_DATA *pmotor)
 {
-    return pmotor->omegaCtrl.outMax;
+    return pmotor->torqueControl.active ? pmotor->iqCmdLimit : pmotor->omegaCtrl.outMax;
 }
 
 /**
  * Returns the lower current limit value
+ * 
+ * In torque control the velocity controller output is clamped to the 
+ * torque reference as well, so the current limit is returned instead.
+ * 
  * @param pmotor motor data
  * @return lower current limit value
  */
 static inline int16_t MCAF_CurrentLimitIqLowerGet(volatile MCAF_MOTOR_DATA *pmotor)
 {
-    return pmotor->omegaCtrl.outMin;
+    return pmotor->torqueControl.active ? -pmotor->iqCmdLimit : pmotor->omegaCtrl.outMin;
 }
 
 /**
@@ -381,8 +423,10 @@ inline static void MCAF_ClearClosedLoopFlags(MCAF_MOTOR_DATA *pmotor)
  * Initialize system state.
  * @param pmotor motor state data
  * @param psys system state data
+ * @param phal peripheral resources assigned to this motor instance
  */
-void MCAF_SystemStateInit(MCAF_MOTOR_DATA *pmotor, MCAF_SYSTEM_DATA *psys);
+void MCAF_SystemStateInit(MCAF_MOTOR_DATA *pmotor, MCAF_SYSTEM_DATA *psys,
+                          const HAL_MOTOR_MAP_T *phal);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,252 @@
+/**
+ * telemetry.c
+ * 
+ * Continuous streaming of selected signals over the UART,
+ * delta-encoded with zigzag varints in framed packets
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "telemetry.h"
+#include "uart_buffer.h"
+#include "util.h"
+#include "parameters/telemetry_params.h"
+
+/** First frame sync byte */
+#define MCAF_TELEMETRY_SYNC0 0xA5
+/** Second frame sync byte */
+#define MCAF_TELEMETRY_SYNC1 0x5A
+
+void MCAF_TelemetryInit(MCAF_TELEMETRY_T *ptelemetry)
+{
+    ptelemetry->channelCount = 0;
+    ptelemetry->decimation = MCAF_TELEMETRY_DECIMATION;
+    ptelemetry->enable = MCAF_TELEMETRY_START_ENABLED;
+    ptelemetry->streaming = false;
+    ptelemetry->head = 0;
+    ptelemetry->tail = 0;
+    ptelemetry->overruns = 0;
+    ptelemetry->sequence = 0;
+}
+
+void MCAF_TelemetryChannelSet(MCAF_TELEMETRY_T *ptelemetry, uint16_t channel,
+        const volatile int16_t *psource)
+{
+    if (channel < MCAF_TELEMETRY_CHANNEL_MAX)
+    {
+        ptelemetry->source[channel] = psource;
+        if (ptelemetry->channelCount <= channel)
+        {
+            ptelemetry->channelCount = channel + 1;
+        }
+    }
+}
+
+bool MCAF_TelemetryIsActive(MCAF_TELEMETRY_T *ptelemetry)
+{
+    if (ptelemetry->streaming)
+    {
+        /* Finish transmitting the current frame before handing the UART
+         * back to X2Cscope, so the host never sees a partial frame. */
+        if (!ptelemetry->enable && !ptelemetry->sending)
+        {
+            ptelemetry->streaming = false;
+        }
+    }
+    else if (ptelemetry->enable && (ptelemetry->channelCount > 0))
+    {
+        /* The ISR leaves the queue alone while not streaming */
+        ptelemetry->tail = ptelemetry->head;
+        ptelemetry->decimationCount = 0;
+        ptelemetry->sampleIndex = 0;
+        ptelemetry->frameSamples = 0;
+        ptelemetry->sending = false;
+        ptelemetry->streaming = true;
+    }
+    return ptelemetry->streaming;
+}
+
+/**
+ * Appends a signed value to the frame as a zigzag-encoded varint.
+ * 
+ * @param ptelemetry telemetry state
+ * @param delta value to append
+ */
+inline static void MCAF_TelemetryPutVarint(MCAF_TELEMETRY_T *ptelemetry, int16_t delta)
+{
+    uint16_t zigzag = ((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15);
+    uint16_t length = ptelemetry->frameLength;
+    while (zigzag >= 0x80)
+    {
+        ptelemetry->frame[length++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    ptelemetry->frame[length++] = (uint8_t)zigzag;
+    ptelemetry->frameLength = length;
+}
+
+/**
+ * Starts a new frame.
+ * 
+ * @param ptelemetry telemetry state
+ * @param index sample index of the first sample in the frame
+ */
+static void MCAF_TelemetryFrameBegin(MCAF_TELEMETRY_T *ptelemetry, uint16_t index)
+{
+    for (uint16_t i = 0; i < ptelemetry->channelCount; ++i)
+    {
+        ptelemetry->previous[i] = 0;
+    }
+    uint8_t *pframe = ptelemetry->frame;
+    pframe[4] = (uint8_t)index;
+    pframe[5] = (uint8_t)(index >> 8);
+    ptelemetry->frameLength = MCAF_TELEMETRY_HEADER_SIZE;
+    ptelemetry->frameSamples = 0;
+    ptelemetry->nextIndex = index;
+}
+
+/**
+ * Completes the header and CRC of the current frame
+ * and starts its transmission.
+ * 
+ * @param ptelemetry telemetry state
+ */
+static void MCAF_TelemetryFrameFinish(MCAF_TELEMETRY_T *ptelemetry)
+{
+    uint8_t *pframe = ptelemetry->frame;
+    const uint16_t sequence = ptelemetry->sequence++;
+    const uint16_t payloadLength = ptelemetry->frameLength - MCAF_TELEMETRY_HEADER_SIZE;
+    pframe[0] = MCAF_TELEMETRY_SYNC0;
+    pframe[1] = MCAF_TELEMETRY_SYNC1;
+    pframe[2] = (uint8_t)sequence;
+    pframe[3] = (uint8_t)(sequence >> 8);
+    pframe[6] = (uint8_t)ptelemetry->channelCount;
+    pframe[7] = (uint8_t)ptelemetry->frameSamples;
+    pframe[8] = (uint8_t)payloadLength;
+    pframe[9] = (uint8_t)(payloadLength >> 8);
+    
+    uint16_t crc = 0xffff;
+    const uint16_t length = ptelemetry->frameLength;
+    for (uint16_t i = 2; i < length; ++i)
+    {
+        crc = UTIL_Crc16CcittUpdate(crc, pframe[i]);
+    }
+    pframe[length] = (uint8_t)crc;
+    pframe[length + 1] = (uint8_t)(crc >> 8);
+    
+    ptelemetry->frameLength = length + 2;
+    ptelemetry->txIndex = 0;
+    ptelemetry->sending = true;
+}
+
+/**
+ * Encodes queued samples into the current frame, until the frame is full,
+ * the queue is empty, or a gap in the sample index is found.
+ * 
+ * @param ptelemetry telemetry state
+ */
+static void MCAF_TelemetryEncode(MCAF_TELEMETRY_T *ptelemetry)
+{
+    const uint16_t channelCount = ptelemetry->channelCount;
+    uint16_t tail = ptelemetry->tail;
+    while (!ptelemetry->sending && (tail != ptelemetry->head))
+    {
+        const MCAF_TELEMETRY_SAMPLE_T *psample = 
+            &ptelemetry->queue[tail & (MCAF_TELEMETRY_QUEUE_LENGTH - 1)];
+        if (ptelemetry->frameSamples == 0)
+        {
+            MCAF_TelemetryFrameBegin(ptelemetry, psample->index);
+        }
+        else if (psample->index != ptelemetry->nextIndex)
+        {
+            /* Samples were dropped: each frame holds consecutive samples only */
+            MCAF_TelemetryFrameFinish(ptelemetry);
+            break;
+        }
+        
+        for (uint16_t i = 0; i < channelCount; ++i)
+        {
+            const int16_t value = psample->value[i];
+            MCAF_TelemetryPutVarint(ptelemetry, value - ptelemetry->previous[i]);
+            ptelemetry->previous[i] = value;
+        }
+        ++ptelemetry->nextIndex;
+        ptelemetry->tail = ++tail;
+        
+        if (++ptelemetry->frameSamples >= MCAF_TELEMETRY_FRAME_SAMPLES)
+        {
+            MCAF_TelemetryFrameFinish(ptelemetry);
+        }
+    }
+}
+
+void MCAF_TelemetryStepMain(MCAF_TELEMETRY_T *ptelemetry)
+{
+    while (MCAF_UartIsRxReady())
+    {
+        if (MCAF_UartRead() == MCAF_TELEMETRY_STOP_BYTE)
+        {
+            ptelemetry->enable = false;
+        }
+    }
+    
+    if (ptelemetry->enable)
+    {
+        MCAF_TelemetryEncode(ptelemetry);
+    }
+    
+    if (ptelemetry->sending)
+    {
+        uint16_t txIndex = ptelemetry->txIndex;
+        while ((txIndex < ptelemetry->frameLength) && MCAF_UartIsTxReady())
+        {
+            MCAF_UartWrite(ptelemetry->frame[txIndex++]);
+        }
+        ptelemetry->txIndex = txIndex;
+        if (txIndex >= ptelemetry->frameLength)
+        {
+            ptelemetry->sending = false;
+            ptelemetry->frameSamples = 0;
+        }
+    }
+}
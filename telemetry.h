@@ -0,0 +1,151 @@
+/**
+ * telemetry.h
+ * 
+ * Continuous streaming of selected signals over the UART,
+ * delta-encoded with zigzag varints in framed packets
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "telemetry_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes streaming telemetry with the default channels,
+ * which are set up by the caller with MCAF_TelemetryChannelSet().
+ * 
+ * @param ptelemetry telemetry state
+ */
+void MCAF_TelemetryInit(MCAF_TELEMETRY_T *ptelemetry);
+
+/**
+ * Selects the signal streamed in one channel, and extends the channel
+ * count to include it if necessary. Call only while not streaming.
+ * 
+ * @param ptelemetry telemetry state
+ * @param channel channel index, less than MCAF_TELEMETRY_CHANNEL_MAX
+ * @param psource signal to stream; must remain valid while streaming
+ */
+void MCAF_TelemetryChannelSet(MCAF_TELEMETRY_T *ptelemetry, uint16_t channel,
+        const volatile int16_t *psource);
+
+/**
+ * Captures one sample of all channels into the sample queue, 
+ * every ptelemetry->decimation ISR cycles while streaming.
+ * If the queue is full, the sample is dropped and counted;
+ * the host sees a gap in the sample index.
+ * 
+ * Executed in the ISR.
+ * 
+ * @param ptelemetry telemetry state
+ */
+inline static void MCAF_TelemetryStepIsr(MCAF_TELEMETRY_T *ptelemetry)
+{
+    if (!ptelemetry->streaming)
+    {
+        return;
+    }
+    if (++ptelemetry->decimationCount < ptelemetry->decimation)
+    {
+        return;
+    }
+    ptelemetry->decimationCount = 0;
+    
+    const uint16_t index = ptelemetry->sampleIndex++;
+    const uint16_t head = ptelemetry->head;
+    if ((uint16_t)(head - ptelemetry->tail) >= MCAF_TELEMETRY_QUEUE_LENGTH)
+    {
+        ++ptelemetry->overruns;
+        return;
+    }
+    MCAF_TELEMETRY_SAMPLE_T *psample = &ptelemetry->queue[head & (MCAF_TELEMETRY_QUEUE_LENGTH - 1)];
+    psample->index = index;
+    for (uint16_t i = 0; i < ptelemetry->channelCount; ++i)
+    {
+        psample->value[i] = *ptelemetry->source[i];
+    }
+    ptelemetry->head = head + 1;
+}
+
+/**
+ * Returns whether the UART is in use for streaming telemetry,
+ * rather than for X2Cscope.
+ * 
+ * Executed in the main loop; starts streaming on request.
+ * 
+ * @param ptelemetry telemetry state
+ * @return true if streaming
+ */
+bool MCAF_TelemetryIsActive(MCAF_TELEMETRY_T *ptelemetry);
+
+/**
+ * Encodes queued samples into frames and transmits them over the UART.
+ * 
+ * Each frame holds up to MCAF_TELEMETRY_FRAME_SAMPLES consecutive samples.
+ * The value of each channel is encoded as the difference from its value 
+ * in the previous sample of the same frame (from zero for the first sample),
+ * mapped to an unsigned integer by zigzag encoding 
+ * (0, -1, 1, -2, 2 ... => 0, 1, 2, 3, 4 ...), and written 7 bits per byte, 
+ * least significant group first, with bit 7 set on all but the last byte.
+ * The frame ends with a CRC-16-CCITT of all bytes following the sync bytes.
+ * See tools/telemetry_decode.py for a decoder.
+ * 
+ * Streaming stops when MCAF_TELEMETRY_STOP_BYTE is received.
+ * 
+ * Executed in the main loop, in place of X2Cscope communication.
+ * 
+ * @param ptelemetry telemetry state
+ */
+void MCAF_TelemetryStepMain(MCAF_TELEMETRY_T *ptelemetry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEMETRY_H */
@@ -0,0 +1,120 @@
+/**
+ * telemetry_types.h
+ * 
+ * Type definitions for streaming telemetry
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __TELEMETRY_TYPES_H
+#define __TELEMETRY_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of signals in each sample */
+#define MCAF_TELEMETRY_CHANNEL_MAX 8
+
+/** Number of entries in the sample queue; must be a power of 2 */
+#define MCAF_TELEMETRY_QUEUE_LENGTH 64
+
+/** Number of samples in each frame */
+#define MCAF_TELEMETRY_FRAME_SAMPLES 16
+
+/** Frame header: sync (2), sequence (2), sample index (2), channel count, 
+ *  sample count, payload length (2) */
+#define MCAF_TELEMETRY_HEADER_SIZE 10
+
+/** Frame size, for the worst case of 3 bytes per encoded value, plus CRC */
+#define MCAF_TELEMETRY_FRAME_SIZE (MCAF_TELEMETRY_HEADER_SIZE \
+        + 3 * MCAF_TELEMETRY_FRAME_SAMPLES * MCAF_TELEMETRY_CHANNEL_MAX + 2)
+
+/**
+ * One sample of all channels, captured in the ISR
+ */
+typedef struct tagMCAF_TELEMETRY_SAMPLE
+{
+    uint16_t index;                              /** sample count, including dropped samples */
+    int16_t value[MCAF_TELEMETRY_CHANNEL_MAX];   /** signal values */
+} MCAF_TELEMETRY_SAMPLE_T;
+
+/**
+ * Streaming telemetry state
+ */
+typedef struct tagMCAF_TELEMETRY
+{
+    /* configuration, changed only while not streaming */
+    const volatile int16_t *source[MCAF_TELEMETRY_CHANNEL_MAX]; /** signal in each channel */
+    uint16_t channelCount;          /** number of channels in use */
+    uint16_t decimation;            /** capture one sample every N ISR cycles */
+
+    /* shared between ISR and main loop */
+    volatile bool enable;           /** streaming requested, by the host or the application */
+    volatile bool streaming;        /** ISR captures samples while true, written by main loop */
+    volatile uint16_t head;         /** count of samples queued, written by ISR */
+    volatile uint16_t tail;         /** count of samples consumed, written by main loop */
+    MCAF_TELEMETRY_SAMPLE_T queue[MCAF_TELEMETRY_QUEUE_LENGTH]; /** sample queue */
+    uint16_t overruns;              /** number of samples dropped due to a full queue */
+
+    /* ISR-only state */
+    uint16_t decimationCount;       /** counter for decimated capture */
+    uint16_t sampleIndex;           /** index of the next sample */
+
+    /* main-loop-only state */
+    uint16_t sequence;              /** sequence number of the next frame */
+    uint16_t nextIndex;             /** sample index expected next in the current frame */
+    uint16_t frameSamples;          /** number of samples in the current frame */
+    uint16_t frameLength;           /** number of bytes in the current frame */
+    uint16_t txIndex;               /** next byte of the frame to transmit */
+    bool sending;                   /** frame complete, transmission in progress */
+    int16_t previous[MCAF_TELEMETRY_CHANNEL_MAX]; /** previous value of each channel, for delta encoding */
+    uint8_t frame[MCAF_TELEMETRY_FRAME_SIZE];     /** frame being encoded or transmitted */
+} MCAF_TELEMETRY_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEMETRY_TYPES_H */
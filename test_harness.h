@@ -681,6 +681,100 @@ inline static void MCAF_TestPerturbationUpdate(volatile MCAF_MOTOR_TEST_MANAGER
 #endif
 }
 
+/**
+ * Starts a square-wave perturbation of the dq-axis current command
+ * and dq-axis voltage, replacing any other perturbation that is in progress.
+ * The perturbation remains active only while the guard key is valid.
+ * 
+ * @param ptest test state
+ * @param pidq amplitude of dq-axis current perturbation
+ * @param pvdq amplitude of dq-axis voltage perturbation
+ * @param halfperiod duration of each half-cycle, in control cycles
+ */
+inline static void MCAF_TestPerturbationStart(volatile MCAF_MOTOR_TEST_MANAGER *ptest,
+                                              const MCAF_U_CURRENT_DQ *pidq,
+                                              const MCAF_U_VOLTAGE_DQ *pvdq,
+                                              uint32_t halfperiod)
+{
+#ifdef MCAF_TEST_HARNESS
+  #if MCAF_TEST_HARNESS_PERTURBATION_SYMMETRIC
+    /* Disable first: the ISR leaves the square wave alone while value == 0 */
+    ptest->sqwave.value = 0;
+    ptest->sqwave.halfperiod = halfperiod;
+    ptest->sqwave.velocity.electrical = 0;
+    ptest->sqwave.idq.d = pidq->d;
+    ptest->sqwave.idq.q = pidq->q;
+    ptest->sqwave.vdq.d = pvdq->d;
+    ptest->sqwave.vdq.q = pvdq->q;
+    ptest->sqwave.count = 0;
+    ptest->sqwave.value = 1;
+  #else // MCAF_TEST_HARNESS_PERTURBATION_SYMMETRIC == 0
+    ptest->perturb.enable = 0;
+    int i;
+    for (i = 0; i < 2; ++i)
+    {
+        volatile MCAF_TEST_PERTURB_PHASE *pphase = &ptest->perturb.phase[i];
+        pphase->duration = halfperiod;
+        pphase->velocity.electrical = 0;
+    }
+    ptest->perturb.phase[0].idq.d =  pidq->d;
+    ptest->perturb.phase[0].idq.q =  pidq->q;
+    ptest->perturb.phase[1].idq.d = -pidq->d;
+    ptest->perturb.phase[1].idq.q = -pidq->q;
+    ptest->perturb.phase[0].vdq.d =  pvdq->d;
+    ptest->perturb.phase[0].vdq.q =  pvdq->q;
+    ptest->perturb.phase[1].vdq.d = -pvdq->d;
+    ptest->perturb.phase[1].vdq.q = -pvdq->q;
+    ptest->perturb.autobalanceRatio = 0;
+    ptest->perturb.step.count = 0;
+    ptest->perturb.count = 0;
+    ptest->perturb.flags &= ~MCAF_TPF_PHASE;
+    ptest->perturb.activePhase = &ptest->perturb.phase[0];
+    ptest->perturb.enable = 1;
+  #endif // MCAF_TEST_HARNESS_PERTURBATION_SYMMETRIC
+#endif
+}
+
+/**
+ * Sets the polarity of a perturbation started with MCAF_TestPerturbationStart(),
+ * for perturbations whose timing is controlled by the caller
+ * (use a half-period that does not expire, e.g. UINT32_MAX).
+ * 
+ * @param ptest test state
+ * @param polarity +1 or -1
+ */
+inline static void MCAF_TestPerturbationPolaritySet(volatile MCAF_MOTOR_TEST_MANAGER *ptest,
+                                                    int16_t polarity)
+{
+#ifdef MCAF_TEST_HARNESS
+  #if MCAF_TEST_HARNESS_PERTURBATION_SYMMETRIC
+    ptest->sqwave.count = 0;
+    ptest->sqwave.value = polarity;
+  #else
+    const uint16_t phase = (polarity < 0) ? MCAF_TPF_PHASE : 0;
+    ptest->perturb.count = 0;
+    ptest->perturb.flags = (ptest->perturb.flags & ~MCAF_TPF_PHASE) | phase;
+    ptest->perturb.activePhase = &ptest->perturb.phase[phase];
+  #endif
+#endif
+}
+
+/**
+ * Stops any perturbation in progress.
+ * 
+ * @param ptest test state
+ */
+inline static void MCAF_TestPerturbationStop(volatile MCAF_MOTOR_TEST_MANAGER *ptest)
+{
+#ifdef MCAF_TEST_HARNESS
+  #if MCAF_TEST_HARNESS_PERTURBATION_SYMMETRIC
+    ptest->sqwave.value = 0;
+  #else
+    ptest->perturb.enable = 0;
+  #endif
+#endif
+}
+
 /**
  * Guards test state variables by resetting them to default values
  * if the specified system-wide guard key is not valid.
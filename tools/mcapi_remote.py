@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+Host client for the MCAPI remote command protocol (see mcapi_remote.h).
+
+Examples:
+    mcapi_remote.py --port COM5 ping
+    mcapi_remote.py --port COM5 start
+    mcapi_remote.py --port COM5 velocity 8000
+    mcapi_remote.py --port COM5 status
+    mcapi_remote.py --port COM5 clear
+    mcapi_remote.py --port COM5 schedule profile.csv --interpolate --start-motor --stop-motor
+    mcapi_remote.py --port COM5 telemetry      (then read it with telemetry_decode.py)
+
+A schedule file has one setpoint per line: time in milliseconds from the
+start of the schedule, and velocity in MCAPI velocity units (Q15 of
+MCAPI_FullscaleVelocityGet()), separated by a comma.
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = 0xC5
+BODY_MAX = 132
+SCHEDULE_LENGTH = 32
+
+CMD_PING = 0x00
+CMD_MOTOR_START = 0x01
+CMD_MOTOR_STOP = 0x02
+CMD_VELOCITY_SET = 0x03
+CMD_FAULT_CLEAR = 0x04
+CMD_STATUS_GET = 0x05
+CMD_TELEMETRY_START = 0x06
+CMD_SCHEDULE_LOAD = 0x10
+CMD_SCHEDULE_START = 0x11
+CMD_SCHEDULE_ABORT = 0x12
+
+LOAD_INTERPOLATE = 0x01
+START_MOTOR_START = 0x01
+START_MOTOR_STOP = 0x02
+
+STATUS_TEXT = {0: 'OK', 1: 'bad length', 2: 'unknown command', 3: 'not allowed while a schedule is running',
+               4: 'argument out of range'}
+MOTOR_STATE_TEXT = {1: 'STOPPED', 2: 'STARTING', 3: 'RUNNING', 4: 'STOPPING', 5: 'FAULT', 6: 'DIAGSTATE',
+                    7: 'RUNNING_TORQUE', 8: 'RUNNING_POSITION'}
+
+STATUS_FORMAT = '<IBBHhhhhhhB'
+STATUS_FIELDS = ('timestamp', 'motorStatus', 'flags', 'faultFlags', 'velocityMeasured', 'velocityReference',
+                 'iqFiltered', 'dcLinkVoltage', 'currentLimitIqUpper', 'currentLimitIqLower', 'scheduleIndex')
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def encode_frame(body):
+    if not 1 <= len(body) <= BODY_MAX:
+        raise ValueError('body length out of range')
+    framed = bytes([len(body)]) + bytes(body)
+    return bytes([SYNC]) + framed + struct.pack('<H', crc16_ccitt(framed))
+
+
+class RemoteError(Exception):
+    pass
+
+
+class Remote:
+    def __init__(self, link, retries=3):
+        """link must provide write(bytes) and read(n), with a read timeout."""
+        self.link = link
+        self.retries = retries
+
+    def _read_frame(self):
+        while True:
+            b = self.link.read(1)
+            if not b:
+                return None
+            if b[0] == SYNC:
+                break
+        header = self.link.read(1)
+        if not header or not 1 <= header[0] <= BODY_MAX:
+            return None
+        rest = self.link.read(header[0] + 2)
+        if len(rest) != header[0] + 2:
+            return None
+        body, crc = rest[:-2], struct.unpack('<H', rest[-2:])[0]
+        if crc16_ccitt(header + body) != crc:
+            return None
+        return body
+
+    def command(self, code, data=b''):
+        frame = encode_frame(bytes([code]) + bytes(data))
+        for _ in range(self.retries):
+            self.link.write(frame)
+            body = self._read_frame()
+            if body is None or len(body) < 2 or body[0] != (code | 0x80):
+                continue
+            if body[1] != 0:
+                raise RemoteError(STATUS_TEXT.get(body[1], 'status %d' % body[1]))
+            return body[2:]
+        raise RemoteError('no response')
+
+    def ping(self):
+        return self.command(CMD_PING)[0]
+
+    def start(self):
+        self.command(CMD_MOTOR_START)
+
+    def stop(self):
+        self.command(CMD_MOTOR_STOP)
+
+    def velocity(self, velocity):
+        self.command(CMD_VELOCITY_SET, struct.pack('<h', velocity))
+
+    def clear(self):
+        self.command(CMD_FAULT_CLEAR)
+
+    def status(self):
+        return dict(zip(STATUS_FIELDS, struct.unpack(STATUS_FORMAT, self.command(CMD_STATUS_GET))))
+
+    def telemetry_start(self):
+        """Hands the UART over to streaming telemetry (see telemetry_decode.py);
+        sending the telemetry stop byte 0x1B returns it to remote control."""
+        self.command(CMD_TELEMETRY_START)
+
+    def schedule_load(self, points, interpolate=False):
+        if not 1 <= len(points) <= SCHEDULE_LENGTH:
+            raise ValueError('a schedule has 1 to %d setpoints' % SCHEDULE_LENGTH)
+        data = bytes([LOAD_INTERPOLATE if interpolate else 0, len(points)])
+        for time, velocity in points:
+            data += struct.pack('<Hh', time, velocity)
+        self.command(CMD_SCHEDULE_LOAD, data)
+
+    def schedule_start(self, start_motor=False, stop_motor=False):
+        flags = (START_MOTOR_START if start_motor else 0) | (START_MOTOR_STOP if stop_motor else 0)
+        self.command(CMD_SCHEDULE_START, bytes([flags]))
+
+    def schedule_abort(self):
+        self.command(CMD_SCHEDULE_ABORT)
+
+
+def read_schedule(filename):
+    points = []
+    with open(filename) as f:
+        for line in f:
+            line = line.split('#')[0].strip()
+            if line:
+                time, velocity = (int(x) for x in line.split(','))
+                points.append((time, velocity))
+    return points
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--port', required=True, help='serial port (requires pyserial)')
+    parser.add_argument('--baud', type=int, default=625000, help='serial baud rate')
+    sub = parser.add_subparsers(dest='action', required=True)
+    for name in ('ping', 'start', 'stop', 'clear', 'status', 'abort', 'telemetry'):
+        sub.add_parser(name)
+    p = sub.add_parser('velocity')
+    p.add_argument('value', type=int)
+    p = sub.add_parser('schedule')
+    p.add_argument('file')
+    p.add_argument('--interpolate', action='store_true', help='ramp linearly between setpoints')
+    p.add_argument('--start-motor', action='store_true', help='start the motor with the schedule')
+    p.add_argument('--stop-motor', action='store_true', help='stop the motor after the last setpoint')
+    args = parser.parse_args()
+
+    import serial
+    remote = Remote(serial.Serial(args.port, args.baud, timeout=0.2))
+    try:
+        if args.action == 'ping':
+            print('protocol version %d' % remote.ping())
+        elif args.action == 'start':
+            remote.start()
+        elif args.action == 'stop':
+            remote.stop()
+        elif args.action == 'clear':
+            remote.clear()
+        elif args.action == 'abort':
+            remote.schedule_abort()
+        elif args.action == 'telemetry':
+            remote.telemetry_start()
+        elif args.action == 'velocity':
+            remote.velocity(args.value)
+        elif args.action == 'status':
+            status = remote.status()
+            status['motorStatus'] = MOTOR_STATE_TEXT.get(status['motorStatus'], status['motorStatus'])
+            for key, value in status.items():
+                print('%-20s %s' % (key, value))
+        elif args.action == 'schedule':
+            remote.schedule_load(read_schedule(args.file), args.interpolate)
+            remote.schedule_start(args.start_motor, args.stop_motor)
+    except RemoteError as e:
+        print('error: %s' % e, file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,554 @@
+#!/usr/bin/env python3
+"""
+Evaluation harness for the stall detectors in stall_detect.c.
+
+The detectors are those of the firmware: stall_detect.c is compiled for the
+host together with stall_detect_host/stall_detect_host.c (with the compiler
+in $CC, default cc), and MCAF_StallDetect() is called once per ISR sample of
+a stream of MCAF_STALL_DETECT_INPUT_T, dq-axis current, current saturation
+state, startup status and motor state. Detection is therefore gated on
+MSST_COMPLETE and MCSM_RUNNING as in the firmware.
+For each detector, its threshold and its timer are swept over a grid around
+the values in parameters/fault_detect_params.h, and for every point of the
+grid the harness reports:
+
+    tpr      fraction of fault runs detected after the onset of the fault
+    fpr      fraction of fault-free windows with a detection: normal runs,
+             and the part of fault runs before the onset
+    latency  time from the onset of the fault to detection (median, 95th
+             percentile, maximum), over the detected fault runs
+
+Plotting tpr against fpr for all grid points gives the ROC curve of the
+detector; the points on its upper-left boundary are marked as "pareto".
+The sweep runs in parallel on all CPU cores.
+
+Streams are either simulated or recorded:
+
+  Simulated scenarios (signal-level models, not a motor simulation),
+  all in closed-loop running, after startup:
+    normal         steady running with noise, speed steps and load steps
+                   within the torque capability; no fault
+    locked_rotor   the rotor is jammed; the estimated velocity decays
+                   slowly while the current saturates
+    sudden_load    a load step beyond the torque capability decelerates
+                   the rotor to standstill
+    loss_of_lock   the rotor keeps turning, but the estimated velocity
+                   moves away from the actual one, so the estimated frame
+                   slips against the rotor
+
+  Recorded streams are CSV files with a header row and one row per ISR,
+  with any of the columns
+      esd, esq, esdFiltered, esqFiltered, valpha, vbeta, omega, id, iq,
+      currsat, startupComplete, running, fault
+  in Q15 units as in the firmware (missing columns are zero; a missing
+  esdFiltered/esqFiltered is computed from esd/esq, and a missing
+  startupComplete or running is 1). startupComplete is 1 while the startup
+  status is MSST_COMPLETE, and running while the motor state is MCSM_RUNNING.
+  The fault column is 1 from the onset of the fault; a recording without it
+  is fault-free.
+
+Examples:
+    stall_detect_eval.py -o roc.csv
+    stall_detect_eval.py --detectors low_speed goertzel --runs 20 --points 7 -o roc.csv --plot plots
+    stall_detect_eval.py --no-sim --record stall1.csv normal1.csv -o roc.csv
+"""
+
+import argparse
+import csv
+import ctypes
+import math
+import multiprocessing
+import os
+import random
+import re
+import subprocess
+import sys
+import tempfile
+
+ISR_PERIOD = 50e-6
+
+DEFAULT_REPO = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir)
+PARAMETER_FILES = ('fault_detect_params.h', 'operating_params.h', 'motor_params.h',
+                   'sat_PI_params.h', 'atpll_params.h')
+
+
+def read_parameters(repo):
+    """Returns a dict of the integer #defines in the parameter files."""
+    pattern = re.compile(r'^\s*#define\s+(\w+)\s+([^/\r\n]+?)\s*(//.*)?$')
+    raw = {}
+    for name in PARAMETER_FILES:
+        with open(os.path.join(repo, 'parameters', name)) as f:
+            for line in f:
+                m = pattern.match(line)
+                if m:
+                    raw[m.group(1)] = m.group(2)
+    params = {}
+    for key, text in raw.items():
+        try:
+            params[key] = int(text, 0)
+        except ValueError:
+            pass
+    # a few thresholds are expressions of other parameters
+    for key, text in raw.items():
+        if key in params:
+            continue
+        expr = text.replace('(int16_t)', 'int')
+        try:
+            params[key] = int(eval(expr, {'__builtins__': {}, 'int': int}, params))
+        except Exception:
+            pass
+    return params
+
+
+# ---- 16-bit fixed-point arithmetic, as in util.h and filter.h ----
+
+def s16(x):
+    x &= 0xFFFF
+    return x - 0x10000 if x & 0x8000 else x
+
+
+def s32(x):
+    x &= 0xFFFFFFFF
+    return x - 0x100000000 if x & 0x80000000 else x
+
+
+def sat16(x):
+    return 32767 if x > 32767 else -32768 if x < -32768 else x
+
+
+class Lpf:
+    """MCAF_LPF_FILTER_X16_T, for the filtered back-emf of the torque angle detector"""
+    def __init__(self, coeff):
+        self.coeff = coeff
+        self.state = 0
+        self.output = 0
+
+    def step(self, x):
+        self.state = s32(self.state + x * self.coeff - self.output * self.coeff)
+        self.output = s16(self.state >> 15)
+        return self.output
+
+
+# ---- stall_detect.c, built for the host ----
+#
+# Each detector is evaluated by calling MCAF_StallDetect() once per sample,
+# with only that detector enabled, and the two swept parameters written into
+# its state after MCAF_StallDetectInit(); all other parameters are those
+# the firmware is built with. See stall_detect_host/stall_detect_host.c.
+
+HOST_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'stall_detect_host')
+
+# parameters swept for each detector
+DETECTORS = {
+    'overcurrent': ('THRESHOLD_OVERCURRENT_STALL_DETECT', 'TIMER_COUNTS_OVERCURRENT_DETECT'),
+    'negative_ed': ('THRESHOLD_ED_STALL_DETECT', 'ACTIVE_TIMER_THRESHOLD_NEGATIVE_ED_DETECT'),
+    'low_speed': ('THRESHOLD_UNDERSPEED_STALL_DETECT', 'ACTIVE_TIMER_THRESHOLD_LOW_SPEED_DETECT'),
+    'torque_angle': ('STALL_DETECT_TORQUE_ANGLE_K', 'ACTIVE_TIMER_THRESHOLD_TORQUE_ANGLE_DETECT'),
+    'variance': ('FILTER_HPF_VARIANCE_DETECT', 'TIMER_COUNTS_VARIANCE_DETECT'),
+    'goertzel': ('MCAF_GOERTZEL_DETECT_RATIO_THRESHOLD', 'MCAF_GOERTZEL_DETECT_BLOCK_COUNT'),
+}
+
+# parameters swept as a count rather than a scaled value
+COUNT_PARAMETERS = ('MCAF_GOERTZEL_DETECT_BLOCK_COUNT',)
+
+# STALL_DETECT_HOST_FLAG
+FLAG_CURRENT_SATURATED = 0x01
+FLAG_STARTUP_COMPLETE = 0x02
+FLAG_RUNNING = 0x04
+
+
+class HostSample(ctypes.Structure):
+    """STALL_DETECT_HOST_SAMPLE"""
+    _fields_ = [(name, ctypes.c_int16) for name in
+                ('esd', 'esq', 'esdFiltered', 'esqFiltered', 'valpha', 'vbeta', 'omega', 'id', 'iq')]
+    _fields_ += [('flags', ctypes.c_uint16)]
+
+
+def build_host_library(repo, directory):
+    """Compiles stall_detect.c of the firmware in repo as a shared library."""
+    output = os.path.join(directory, 'stall_detect_host.so')
+    command = [os.environ.get('CC', 'cc'), '-std=gnu99', '-fgnu89-inline', '-O2', '-shared', '-fPIC',
+               '-I' + HOST_DIR, '-I' + repo, '-I' + os.path.join(repo, 'library', 'mc-library'),
+               '-o', output, os.path.join(HOST_DIR, 'stall_detect_host.c'), '-lm']
+    result = subprocess.run(command, stderr=subprocess.PIPE, universal_newlines=True)
+    if result.returncode != 0:
+        sys.exit('building stall_detect.c for the host failed:\n' + result.stderr)
+    return output
+
+
+def load_host_library(path):
+    lib = ctypes.CDLL(path)
+    lib.StallDetectHostInit.argtypes = [ctypes.c_char_p]
+    lib.StallDetectHostInit.restype = ctypes.c_bool
+    lib.StallDetectHostSet.argtypes = [ctypes.c_char_p, ctypes.c_int32]
+    lib.StallDetectHostSet.restype = ctypes.c_bool
+    lib.StallDetectHostRun.argtypes = [ctypes.POINTER(HostSample), ctypes.c_uint32]
+    lib.StallDetectHostRun.restype = ctypes.c_int32
+    return lib
+
+
+# ---- input streams ----
+
+class Sample:
+    __slots__ = ('esd', 'esq', 'esdFiltered', 'esqFiltered', 'valpha', 'vbeta',
+                 'omega', 'id', 'iq', 'currsat', 'startupComplete', 'running')
+
+
+class Stream:
+    def __init__(self, name, samples, onset):
+        self.name = name          # scenario name or file name
+        self.count = len(samples)
+        self.data = bytes(host_samples(samples))
+        self.onset = onset        # index of the onset of the fault, or None if fault-free
+
+
+def host_samples(samples):
+    """Converts samples to an array of STALL_DETECT_HOST_SAMPLE."""
+    array = (HostSample * len(samples))()
+    for h, x in zip(array, samples):
+        for name in ('esd', 'esq', 'esdFiltered', 'esqFiltered', 'valpha', 'vbeta', 'omega', 'id', 'iq'):
+            setattr(h, name, getattr(x, name))
+        h.flags = ((FLAG_CURRENT_SATURATED if x.currsat else 0)
+                   | (FLAG_STARTUP_COMPLETE if x.startupComplete else 0)
+                   | (FLAG_RUNNING if x.running else 0))
+    return array
+
+
+def quantize(x):
+    return sat16(int(round(x * 32768)))
+
+
+class Simulator:
+    """
+    Signal-level models of the detector inputs, in per-unit values
+    (1.0 = Q15 full scale), for one scenario with randomized severity.
+    """
+    def __init__(self, p, rng):
+        self.p = p
+        self.rng = rng
+        self.ke = p['MCAF_MOTOR_KE'] / (1 << p['MCAF_MOTOR_KE_Q'])
+        self.rs = p['MCAF_MOTOR_RS'] / (1 << p['MCAF_MOTOR_RS_Q'])
+        self.lq = p['MCAF_MOTOR_LQ_BASE_OMEGA_E'] / (1 << p['MCAF_MOTOR_LQ_BASE_OMEGA_E_Q'])
+        self.velocity_min = p['MCAF_VELOCITY_COMMAND_MIN'] / 32768
+        self.velocity_max = p['MCAF_VELOCITY_COMMAND_MAX'] / 32768
+        self.current_limit = p['CURRENT_MAXIMUM_COMMAND'] / 32768
+        # electrical angle per ISR at full-scale velocity
+        self.dtheta = math.pi * p['ATPLL_NORM_DELTAT'] / 32768
+        self.es_noise = rng.uniform(0.002, 0.01)
+        self.i_noise = rng.uniform(0.0005, 0.002)
+        self.omega_noise = rng.uniform(0.002, 0.01)
+        self.ripple6 = rng.uniform(0.0, 0.05)
+
+    def lag(self, x, target, tau):
+        return target + (x - target) * math.exp(-ISR_PERIOD / tau) if tau > 0 else target
+
+    def run(self, kind, n_pre, n_post):
+        rng = self.rng
+        n = n_pre + n_post
+        omega0 = rng.uniform(self.velocity_min, self.velocity_max)
+        iq0 = rng.uniform(0.1, 0.6) * self.current_limit
+        omega_act = omega_est = omega_cmd = omega0
+        iq = iq0
+        phi = 0.0           # estimated angle - actual angle
+        theta = rng.uniform(0, 2 * math.pi)
+        lpf_ed = Lpf(self.p['FILTER_LPF_NEGATIVE_ED_DETECT'])
+        lpf_eq = Lpf(self.p['FILTER_LPF_NEGATIVE_ED_DETECT'])
+        dl = rng.uniform(-0.2, 0.2) * self.lq      # estimator inductance error
+        dr = rng.uniform(-0.2, 0.2) * self.rs      # estimator resistance error
+
+        # fault-free events: a speed step and a load step within capability
+        speed_step_at = rng.randrange(n) if rng.random() < 0.5 else -1
+        speed_step_to = rng.uniform(self.velocity_min, self.velocity_max)
+        accel = rng.uniform(2.0, 10.0)             # full scale per second
+        load_step_at = rng.randrange(n) if rng.random() < 0.5 else -1
+        load_step = rng.uniform(0.1, 0.3) * self.current_limit
+
+        # fault severity
+        tau_act = rng.uniform(0.002, 0.02) if kind == 'locked_rotor' else rng.uniform(0.03, 0.15)
+        tau_est = rng.uniform(0.02, 0.2)
+        residual = rng.uniform(0.0, 0.4)
+        delta = rng.choice((rng.uniform(-0.6, -0.2), rng.uniform(0.2, 1.0)))
+        wobble = rng.uniform(0.0, 0.1)
+        wobble_freq = rng.uniform(2.0, 20.0)
+
+        samples = []
+        for i in range(n):
+            fault = kind != 'normal' and i >= n_pre
+            t = i * ISR_PERIOD
+            if not fault:
+                if 0 <= speed_step_at <= i:
+                    omega_cmd = speed_step_to
+                slew = accel * ISR_PERIOD
+                error = omega_cmd - omega_act
+                omega_act += max(-slew, min(slew, error))
+                load = load_step if 0 <= load_step_at <= i else 0.0
+                iq_target = iq0 + load + (self.current_limit if abs(error) > slew else 0) * math.copysign(1, error)
+                iq_target = max(-self.current_limit, min(self.current_limit, iq_target))
+                if 0 <= load_step_at <= i < load_step_at + 400:
+                    omega_act -= 0.02 * load * ISR_PERIOD / 0.01
+                omega_est = self.lag(omega_est, omega_act, 0.002)
+                phi = self.lag(phi, 0.0, 0.005) + rng.gauss(0, 0.003)
+            elif kind == 'locked_rotor':
+                omega_act = self.lag(omega_act, 0.0, tau_act)
+                omega_est = self.lag(omega_est, residual * omega0, tau_est)
+                iq_target = self.current_limit
+            elif kind == 'sudden_load':
+                omega_act = self.lag(omega_act, 0.0, tau_act)
+                omega_est = self.lag(omega_est, omega_act, 0.01)
+                iq_target = self.current_limit
+            else:  # loss_of_lock
+                omega_est = self.lag(omega_est, omega0 * (1 + delta), tau_est)
+                iq_target = max(-self.current_limit, min(self.current_limit,
+                                                         iq0 + 2.0 * (omega_cmd - omega_est)))
+            omega_est_now = omega_est * (1 + wobble * math.sin(2 * math.pi * wobble_freq * t)) if fault else omega_est
+            if fault:
+                phi += (omega_est_now - omega_act) * self.dtheta
+            iq = self.lag(iq, iq_target, 0.001)
+            currsat = abs(iq) >= 0.98 * self.current_limit
+            theta += omega_est_now * self.dtheta
+
+            # back-emf in the estimated frame, with estimator parameter errors
+            e = self.ke * omega_act
+            ripple = self.ripple6 * e * math.cos(6 * theta)
+            esd = -e * math.sin(phi) - omega_est_now * dl * iq + rng.gauss(0, self.es_noise)
+            esq = e * math.cos(phi) + dr * iq + ripple + rng.gauss(0, self.es_noise)
+            vd = -omega_est_now * self.lq * iq
+            vq = self.rs * iq + e * math.cos(phi)
+            vs = math.hypot(vd, vq)
+
+            x = Sample()
+            x.esd = quantize(esd)
+            x.esq = quantize(esq)
+            x.esdFiltered = lpf_ed.step(x.esd)
+            x.esqFiltered = lpf_eq.step(x.esq)
+            x.valpha = quantize(vs * math.cos(theta))
+            x.vbeta = quantize(vs * math.sin(theta))
+            x.omega = quantize(omega_est_now + rng.gauss(0, self.omega_noise))
+            x.id = quantize(rng.gauss(0, self.i_noise))
+            x.iq = quantize(iq + rng.gauss(0, self.i_noise))
+            x.currsat = currsat
+            x.startupComplete = True
+            x.running = True
+            samples.append(x)
+        return samples
+
+
+SCENARIOS = ('normal', 'locked_rotor', 'sudden_load', 'loss_of_lock')
+
+
+def simulate(p, kind, seed, pre_time, post_time):
+    n_pre = int(pre_time / ISR_PERIOD)
+    n_post = int(post_time / ISR_PERIOD)
+    samples = Simulator(p, random.Random(seed)).run(kind, n_pre, n_post)
+    return Stream(kind, samples, None if kind == 'normal' else n_pre)
+
+
+def read_recording(p, filename):
+    samples = []
+    onset = None
+    lpf_ed = Lpf(p['FILTER_LPF_NEGATIVE_ED_DETECT'])
+    lpf_eq = Lpf(p['FILTER_LPF_NEGATIVE_ED_DETECT'])
+    with open(filename, newline='') as f:
+        for i, row in enumerate(csv.DictReader(f)):
+            get = lambda name: int(float(row.get(name) or 0))
+            x = Sample()
+            for name in ('esd', 'esq', 'valpha', 'vbeta', 'omega', 'id', 'iq'):
+                setattr(x, name, s16(get(name)))
+            x.currsat = bool(get('currsat'))
+            x.startupComplete = bool(get('startupComplete')) if 'startupComplete' in row else True
+            x.running = bool(get('running')) if 'running' in row else True
+            x.esdFiltered = s16(get('esdFiltered')) if 'esdFiltered' in row else lpf_ed.step(x.esd)
+            x.esqFiltered = s16(get('esqFiltered')) if 'esqFiltered' in row else lpf_eq.step(x.esq)
+            if onset is None and get('fault'):
+                onset = i
+            samples.append(x)
+    return Stream(os.path.basename(filename), samples, onset)
+
+
+# ---- sweep ----
+
+_lib = None
+_streams = None
+
+
+def _init_worker(library, streams):
+    global _lib, _streams
+    _lib = load_host_library(library)
+    _streams = [(HostSample * s.count).from_buffer_copy(s.data) for s in streams]
+
+
+def _evaluate(task):
+    """Returns the index of the first detection in each stream, or None."""
+    name, values = task
+    detections = []
+    for samples in _streams:
+        _lib.StallDetectHostInit(name.encode())
+        for parameter, value in values.items():
+            _lib.StallDetectHostSet(parameter.encode(), value)
+        index = _lib.StallDetectHostRun(samples, len(samples))
+        detections.append(index if index >= 0 else None)
+    return detections
+
+
+def sweep_values(name, nominal, points, span):
+    if name in COUNT_PARAMETERS:
+        first = max(1, nominal - (points - 1) // 2)
+        return list(range(first, first + points))
+    if points == 1:
+        return [nominal]
+    values = set()
+    for k in range(points):
+        factor = span ** (2.0 * k / (points - 1) - 1.0)
+        value = int(round(nominal * factor))
+        values.add(max(1, min(32767, value)) if nominal > 0 else value)
+    return sorted(values)
+
+
+def percentile(values, fraction):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(math.ceil(fraction * len(values))) - 1)]
+
+
+def summarize(streams, detections):
+    negatives = 0
+    false_positives = 0
+    positives = {}
+    latencies = []
+    for stream, detected in zip(streams, detections):
+        negatives += 1
+        false_positive = detected is not None and (stream.onset is None or detected < stream.onset)
+        false_positives += false_positive
+        if stream.onset is not None:
+            total, hits = positives.get(stream.name, (0, 0))
+            hit = detected is not None and not false_positive
+            positives[stream.name] = (total + 1, hits + hit)
+            if hit:
+                latencies.append((detected - stream.onset) * ISR_PERIOD * 1000)
+    total = sum(t for t, _ in positives.values())
+    hits = sum(h for _, h in positives.values())
+    result = {
+        'tpr': hits / total if total else float('nan'),
+        'fpr': false_positives / negatives if negatives else float('nan'),
+        'latency_median_ms': percentile(latencies, 0.5) if latencies else '',
+        'latency_p95_ms': percentile(latencies, 0.95) if latencies else '',
+        'latency_max_ms': max(latencies) if latencies else '',
+    }
+    for name, (t, h) in positives.items():
+        result['tpr_' + name] = h / t
+    return result
+
+
+def mark_pareto(rows):
+    """Marks the points that no other point beats in both tpr and fpr."""
+    for row in rows:
+        row['pareto'] = int(not any(
+            other['tpr'] >= row['tpr'] and other['fpr'] <= row['fpr']
+            and (other['tpr'] > row['tpr'] or other['fpr'] < row['fpr'])
+            for other in rows))
+
+
+def plot(rows, directory):
+    import matplotlib
+    matplotlib.use('Agg')
+    import matplotlib.pyplot as plt
+    os.makedirs(directory, exist_ok=True)
+    for name in DETECTORS:
+        points = [r for r in rows if r['detector'] == name]
+        if not points:
+            continue
+        fig, ax = plt.subplots(figsize=(6, 5))
+        latency = [r['latency_median_ms'] if r['latency_median_ms'] != '' else float('nan') for r in points]
+        sc = ax.scatter([r['fpr'] for r in points], [r['tpr'] for r in points], c=latency, cmap='viridis')
+        front = sorted((r for r in points if r['pareto']), key=lambda r: r['fpr'])
+        ax.plot([r['fpr'] for r in front], [r['tpr'] for r in front], 'k-', linewidth=0.8)
+        fig.colorbar(sc, ax=ax, label='median detection latency [ms]')
+        ax.set_xlabel('false positive rate')
+        ax.set_ylabel('true positive rate')
+        ax.set_xlim(-0.02, 1.02)
+        ax.set_ylim(-0.02, 1.02)
+        ax.set_title('%s: %s x %s' % (name, points[0]['param_a'], points[0]['param_b']), fontsize=8)
+        fig.tight_layout()
+        fig.savefig(os.path.join(directory, 'roc_%s.png' % name))
+        plt.close(fig)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--repo', default=DEFAULT_REPO, help='firmware source directory (default: %(default)s)')
+    parser.add_argument('--detectors', nargs='+', choices=sorted(DETECTORS), default=list(DETECTORS),
+                        help='detectors to evaluate (default: all)')
+    parser.add_argument('--runs', type=int, default=8, help='simulated runs per scenario (default: %(default)s)')
+    parser.add_argument('--points', type=int, default=5, help='grid points per swept parameter (default: %(default)s)')
+    parser.add_argument('--span', type=float, default=4.0,
+                        help='sweep from nominal/span to nominal*span (default: %(default)s)')
+    parser.add_argument('--pre', type=float, default=0.3, help='seconds before the fault onset (default: %(default)s)')
+    parser.add_argument('--post', type=float, default=1.2, help='seconds after the fault onset (default: %(default)s)')
+    parser.add_argument('--seed', type=int, default=1, help='random seed of the simulated runs')
+    parser.add_argument('--record', nargs='+', default=[], help='recorded streams (CSV)')
+    parser.add_argument('--no-sim', action='store_true', help='use only the recorded streams')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='worker processes (default: all CPU cores)')
+    parser.add_argument('-o', '--output', help='CSV output file (default: stdout)')
+    parser.add_argument('--plot', metavar='DIR', help='write ROC curves as PNG files to DIR (requires matplotlib)')
+    args = parser.parse_args()
+    if args.plot:
+        try:
+            import matplotlib
+        except ImportError:
+            parser.error('--plot requires matplotlib')
+
+    p = read_parameters(args.repo)
+    streams = [read_recording(p, f) for f in args.record]
+    if not args.no_sim:
+        for k, kind in enumerate(SCENARIOS):
+            for run in range(args.runs):
+                streams.append(simulate(p, kind, args.seed * 1000003 + k * 1009 + run, args.pre, args.post))
+    if not streams:
+        parser.error('no streams to evaluate')
+
+    tasks = []
+    for name in args.detectors:
+        a, b = DETECTORS[name]
+        for va in sweep_values(a, p[a], args.points, args.span):
+            for vb in sweep_values(b, p[b], args.points, args.span):
+                tasks.append((name, {a: va, b: vb}))
+    print('%d streams, %d grid points, %d jobs' % (len(streams), len(tasks), args.jobs), file=sys.stderr)
+
+    with tempfile.TemporaryDirectory() as directory:
+        library = build_host_library(os.path.abspath(args.repo), directory)
+        lib = load_host_library(library)
+        for name in args.detectors:
+            if not lib.StallDetectHostInit(name.encode()):
+                sys.exit('stall_detect_host.c does not know detector ' + name)
+            for parameter in DETECTORS[name]:
+                if not lib.StallDetectHostSet(parameter.encode(), p[parameter]):
+                    sys.exit('stall_detect_host.c cannot set ' + parameter)
+        with multiprocessing.Pool(args.jobs, initializer=_init_worker, initargs=(library, streams)) as pool:
+            detections = pool.map(_evaluate, tasks, chunksize=1)
+
+    rows = []
+    for (name, values), detected in zip(tasks, detections):
+        a, b = DETECTORS[name]
+        row = {'detector': name, 'param_a': a, 'value_a': values[a], 'param_b': b, 'value_b': values[b],
+               'nominal': int(values[a] == p[a] and values[b] == p[b])}
+        row.update(summarize(streams, detected))
+        rows.append(row)
+    for name in args.detectors:
+        mark_pareto([r for r in rows if r['detector'] == name])
+
+    fields = ['detector', 'param_a', 'value_a', 'param_b', 'value_b', 'nominal', 'pareto', 'tpr', 'fpr',
+              'latency_median_ms', 'latency_p95_ms', 'latency_max_ms']
+    fields += sorted({k for r in rows for k in r if k.startswith('tpr_')})
+    out = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.DictWriter(out, fieldnames=fields, restval='')
+    writer.writeheader()
+    for row in rows:
+        writer.writerow({k: ('%.4g' % v if isinstance(v, float) else v) for k, v in row.items()})
+    if out is not sys.stdout:
+        out.close()
+    if args.plot:
+        plot(rows, args.plot)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,252 @@
+/**
+ * stall_detect_host.c
+ *
+ * Host build of stall_detect.c for tools/stall_detect_eval.py.
+ *
+ * The firmware source is compiled unmodified, and MCAF_StallDetect() is
+ * called once per ISR sample with a motor state built from the sample, so
+ * the harness evaluates the same arithmetic and the same gating on the
+ * startup status and motor state as the firmware. Only the detector enable
+ * functions of options.h are replaced, so that any one detector can be
+ * evaluated regardless of which ones the firmware enables.
+ *
+ * Build (the harness does this itself):
+ *   cc -std=gnu99 -fgnu89-inline -O2 -shared -fPIC -Itools/stall_detect_host
+ *      -I. -Ilibrary/mc-library -o stall_detect_host.so tools/stall_detect_host/stall_detect_host.c
+ */
+
+#include "xc.h"
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+
+/* The detector enable functions of options.h are renamed as they are
+ * defined, and replaced by the detector selected in StallDetectHostInit(). */
+#define MCAF_OvercurrentDetectEnabled   MCAF_OvercurrentDetectEnabledFirmware
+#define MCAF_NegativeEdDetectEnabled    MCAF_NegativeEdDetectEnabledFirmware
+#define MCAF_LowSpeedDetectEnabled      MCAF_LowSpeedDetectEnabledFirmware
+#define MCAF_TorqueAngleDetectEnabled   MCAF_TorqueAngleDetectEnabledFirmware
+#define MCAF_VarianceDetectEnabled      MCAF_VarianceDetectEnabledFirmware
+#define MCAF_GoertzelDetectEnabled      MCAF_GoertzelDetectEnabledFirmware
+#include "parameters/options.h"
+#undef MCAF_OvercurrentDetectEnabled
+#undef MCAF_NegativeEdDetectEnabled
+#undef MCAF_LowSpeedDetectEnabled
+#undef MCAF_TorqueAngleDetectEnabled
+#undef MCAF_VarianceDetectEnabled
+#undef MCAF_GoertzelDetectEnabled
+
+typedef enum
+{
+    HOST_OVERCURRENT,
+    HOST_NEGATIVE_ED,
+    HOST_LOW_SPEED,
+    HOST_TORQUE_ANGLE,
+    HOST_VARIANCE,
+    HOST_GOERTZEL,
+    HOST_DETECTOR_COUNT
+} HOST_DETECTOR;
+
+static HOST_DETECTOR hostDetector;
+
+#define MCAF_OvercurrentDetectEnabled() (hostDetector == HOST_OVERCURRENT)
+#define MCAF_NegativeEdDetectEnabled()  (hostDetector == HOST_NEGATIVE_ED)
+#define MCAF_LowSpeedDetectEnabled()    (hostDetector == HOST_LOW_SPEED)
+#define MCAF_TorqueAngleDetectEnabled() (hostDetector == HOST_TORQUE_ANGLE)
+#define MCAF_VarianceDetectEnabled()    (hostDetector == HOST_VARIANCE)
+#define MCAF_GoertzelDetectEnabled()    (hostDetector == HOST_GOERTZEL)
+
+#include "stall_detect.c"
+
+/* The sine table of the motor control library is in its binary archive;
+ * this one is computed, and may differ from it in the last bit. */
+uint16_t MC_SineTableInRam[128];
+
+/**
+ * Host version of MC_CalculateSineCosine_InlineC_Ram()
+ * from motor_control_inline_dspic.h
+ */
+static inline uint16_t MC_CalculateSineCosine_InlineC_Ram(int16_t angle, MC_SINCOS_T *sincos)
+{
+    const uint32_t result = __builtin_muluu(128, angle);
+    const uint16_t index = result >> 16;
+    const uint16_t remainder = (uint16_t)result;
+    uint16_t y0 = MC_SineTableInRam[index];
+    uint16_t y1 = MC_SineTableInRam[(index + 1) & 127];
+    sincos->sin = y0 + (__builtin_mulus(remainder, (uint16_t)(y1 - y0)) >> 16);
+    y0 = MC_SineTableInRam[(index + 32) & 127];
+    y1 = MC_SineTableInRam[(index + 33) & 127];
+    sincos->cos = y0 + (__builtin_mulus(remainder, (uint16_t)(y1 - y0)) >> 16);
+    return remainder == 0;
+}
+
+/**
+ * One ISR sample of the detector inputs, in firmware units
+ */
+typedef struct tagStallDetectHostSample
+{
+    int16_t esd;
+    int16_t esq;
+    int16_t esdFiltered;
+    int16_t esqFiltered;
+    int16_t valpha;
+    int16_t vbeta;
+    int16_t omega;
+    int16_t id;
+    int16_t iq;
+    uint16_t flags;     /** STALL_DETECT_HOST_FLAG */
+} STALL_DETECT_HOST_SAMPLE;
+
+typedef enum
+{
+    HOST_SAMPLE_CURRENT_SATURATED = 0x01,   /** sat.state == MCAF_SAT_CURRENT */
+    HOST_SAMPLE_STARTUP_COMPLETE  = 0x02,   /** startup status is MSST_COMPLETE */
+    HOST_SAMPLE_RUNNING           = 0x04    /** motor state is MCSM_RUNNING */
+} STALL_DETECT_HOST_FLAG;
+
+static const char *const hostDetectorNames[HOST_DETECTOR_COUNT] = {
+    "overcurrent", "negative_ed", "low_speed", "torque_angle", "variance", "goertzel"
+};
+
+static const uint16_t hostDetectorFlags[HOST_DETECTOR_COUNT] = {
+    MCAF_OVERCURRENT_STALL_DETECT,
+    MCAF_NEGATIVE_ED_STALL_DETECT,
+    MCAF_LOW_SPEED_STALL_DETECT,
+    MCAF_TORQUE_ANGLE_STALL_DETECT,
+    MCAF_LOSS_OF_LOCK_STALL_DETECT,
+    MCAF_LOSS_OF_LOCK_STALL_DETECT
+};
+
+static MCAF_MOTOR_DATA motor;
+
+/**
+ * Selects the detector to evaluate, and initializes the stall detect state
+ * from the parameters the firmware is built with.
+ * @param name detector name, as in stall_detect_eval.py
+ * @return whether the name is valid
+ */
+bool StallDetectHostInit(const char *name)
+{
+    if (MC_SineTableInRam[32] == 0)
+    {
+        for (int i = 0; i < 128; ++i)
+        {
+            MC_SineTableInRam[i] = (uint16_t)(int16_t)lround(32767.0 * sin(2.0 * M_PI * i / 128));
+        }
+    }
+    for (int i = 0; i < HOST_DETECTOR_COUNT; ++i)
+    {
+        if (strcmp(name, hostDetectorNames[i]) == 0)
+        {
+            hostDetector = (HOST_DETECTOR)i;
+            memset(&motor, 0, sizeof(motor));
+            MCAF_StallDetectInit(&motor.stallDetect);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Replaces the value of a parameter in the stall detect state.
+ * @param name parameter name, as in parameters/fault_detect_params.h
+ * @param value new value
+ * @return whether the parameter can be set
+ */
+bool StallDetectHostSet(const char *name, int32_t value)
+{
+    MCAF_STALL_DETECT_T *p = &motor.stallDetect;
+    if (strcmp(name, "THRESHOLD_OVERCURRENT_STALL_DETECT") == 0)
+    {
+        p->overcurrentDetect.overcurrentThreshold = value;
+    }
+    else if (strcmp(name, "TIMER_COUNTS_OVERCURRENT_DETECT") == 0)
+    {
+        p->overcurrentDetect.timerThreshold = value;
+    }
+    else if (strcmp(name, "THRESHOLD_ED_STALL_DETECT") == 0)
+    {
+        p->negativeEdDetect.edThreshold = value;
+    }
+    else if (strcmp(name, "ACTIVE_TIMER_THRESHOLD_NEGATIVE_ED_DETECT") == 0)
+    {
+        p->negativeEdDetect.timeActiveThreshold = value;
+    }
+    else if (strcmp(name, "THRESHOLD_UNDERSPEED_STALL_DETECT") == 0)
+    {
+        p->lowSpeedDetect.lowSpeedThreshold = value;
+    }
+    else if (strcmp(name, "ACTIVE_TIMER_THRESHOLD_LOW_SPEED_DETECT") == 0)
+    {
+        p->lowSpeedDetect.timerActiveThreshold = value;
+    }
+    else if (strcmp(name, "STALL_DETECT_TORQUE_ANGLE_K") == 0)
+    {
+        p->torqueAngleDetect.k = value;
+    }
+    else if (strcmp(name, "ACTIVE_TIMER_THRESHOLD_TORQUE_ANGLE_DETECT") == 0)
+    {
+        p->torqueAngleDetect.timerActiveThreshold = value;
+    }
+    else if (strcmp(name, "FILTER_HPF_VARIANCE_DETECT") == 0)
+    {
+        p->varianceDetect.hpfEd.coeff = value;
+        p->varianceDetect.hpfEq.coeff = value;
+    }
+    else if (strcmp(name, "TIMER_COUNTS_VARIANCE_DETECT") == 0)
+    {
+        p->varianceDetect.timerThreshold = value;
+    }
+    else if (strcmp(name, "MCAF_GOERTZEL_DETECT_RATIO_THRESHOLD") == 0)
+    {
+        p->goertzelDetect.ratioThreshold = value;
+    }
+    else if (strcmp(name, "MCAF_GOERTZEL_DETECT_BLOCK_COUNT") == 0)
+    {
+        p->goertzelDetect.blockCountThreshold = value;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Runs MCAF_StallDetect() over a stream of samples, one call per sample.
+ * The stall detect flag mask is not applied, so that detectors which the
+ * firmware masks off (torque angle) can be evaluated as well.
+ * @param samples input samples
+ * @param count number of samples
+ * @return index of the first sample at which the selected detector
+ *         sets its flag, or -1 if it never does
+ */
+int32_t StallDetectHostRun(const STALL_DETECT_HOST_SAMPLE *samples, uint32_t count)
+{
+    MCAF_STALL_DETECT_INPUT_T *pinputs = &motor.stallDetect.inputs;
+    const uint16_t flag = hostDetectorFlags[hostDetector];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const STALL_DETECT_HOST_SAMPLE *x = &samples[i];
+        pinputs->esdq.d = x->esd;
+        pinputs->esdq.q = x->esq;
+        pinputs->esdqFiltered.d = x->esdFiltered;
+        pinputs->esdqFiltered.q = x->esqFiltered;
+        pinputs->valphabeta.alpha = x->valpha;
+        pinputs->valphabeta.beta = x->vbeta;
+        pinputs->omegaElectrical = x->omega;
+        motor.omegaElectrical = x->omega;
+        motor.idq.d = x->id;
+        motor.idq.q = x->iq;
+        motor.sat.state = (x->flags & HOST_SAMPLE_CURRENT_SATURATED) ? MCAF_SAT_CURRENT : MCAF_SAT_NONE;
+        motor.startup.state = (x->flags & HOST_SAMPLE_STARTUP_COMPLETE) ? SSM_COMPLETE : SSM_HOLD;
+        motor.state = (x->flags & HOST_SAMPLE_RUNNING) ? MCSM_RUNNING : MCSM_STARTING;
+
+        MCAF_StallDetect(&motor.stallDetect, &motor);
+        if (motor.stallDetect.stallDetectFlag & flag)
+        {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,35 @@
+/**
+ * xc.h
+ *
+ * Host replacement for the XC16 device header, used to build stall_detect.c
+ * with a host C compiler for tools/stall_detect_eval.py.
+ *
+ * It provides the XC16 builtins used by util.h and filter.h, with the
+ * operand types of the dsPIC instructions, and keeps the hardware access
+ * functions (which need the device and MCC driver headers) out of the build.
+ */
+
+#ifndef __STALL_DETECT_HOST_XC_H
+#define __STALL_DETECT_HOST_XC_H
+
+#include <stdint.h>
+
+/* 16x16 multiply: MUL.SS, MUL.SU, MUL.US, MUL.UU */
+#define __builtin_mulss(a, b) ((int32_t)(int16_t)(a) * (int32_t)(int16_t)(b))
+#define __builtin_mulsu(a, b) ((int32_t)(int16_t)(a) * (int32_t)(uint16_t)(b))
+#define __builtin_mulus(a, b) ((int32_t)(uint16_t)(a) * (int32_t)(int16_t)(b))
+#define __builtin_muluu(a, b) ((uint32_t)(uint16_t)(a) * (uint32_t)(uint16_t)(b))
+
+/* 32/16 divide: DIV.SD, DIV.UD, DIVF */
+#define __builtin_divsd(a, b) ((int16_t)((int32_t)(a) / (int16_t)(b)))
+#define __builtin_divud(a, b) ((uint16_t)((uint32_t)(a) / (uint16_t)(b)))
+#define __builtin_divf(a, b)  ((int16_t)(((int32_t)(int16_t)(a) << 15) / (int16_t)(b)))
+
+#define __builtin_nop()
+
+/* hal/hardware_access_functions.h is not included; test_harness.h only
+ * needs the profiling counter from it. */
+#define __HAF_H
+static inline uint16_t HAL_ProfilingCounter_Get(void) { return 0; }
+
+#endif /* __STALL_DETECT_HOST_XC_H */
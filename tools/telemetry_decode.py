@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+Decoder for the MCAF streaming telemetry format (see telemetry.h).
+
+Reads frames from a serial port or a capture file and writes one CSV row
+per sample: the sample index (unwrapped to a running count) followed by
+the value of each channel as a signed 16-bit integer.
+
+Frame layout, little-endian:
+    0xA5 0x5A             sync
+    uint16 sequence       frame sequence number
+    uint16 index          sample index of the first sample
+    uint8  channelCount
+    uint8  sampleCount
+    uint16 payloadLength
+    payload               zigzag varint deltas, sample by sample
+    uint16 crc            CRC-16-CCITT (init 0xFFFF) of bytes from sequence to end of payload
+
+Examples:
+    telemetry_decode.py --port COM5 --baud 625000 -o trace.csv
+    telemetry_decode.py capture.bin -o trace.csv
+"""
+
+import argparse
+import csv
+import sys
+
+SYNC = b'\xa5\x5a'
+HEADER_SIZE = 10
+# limits from telemetry_types.h; a varint-coded 16-bit delta takes 1 to 3 bytes
+CHANNEL_MAX = 8
+FRAME_SAMPLES = 16
+PAYLOAD_MAX = 3 * CHANNEL_MAX * FRAME_SAMPLES
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def to_s16(x):
+    x &= 0xFFFF
+    return x - 0x10000 if x & 0x8000 else x
+
+
+def decode_payload(payload, channel_count, sample_count):
+    samples = []
+    previous = [0] * channel_count
+    pos = 0
+    for _ in range(sample_count):
+        sample = []
+        for ch in range(channel_count):
+            zigzag = 0
+            shift = 0
+            while True:
+                if pos >= len(payload):
+                    raise ValueError('truncated payload')
+                byte = payload[pos]
+                pos += 1
+                zigzag |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            delta = (zigzag >> 1) ^ -(zigzag & 1)
+            previous[ch] = to_s16(previous[ch] + delta)
+            sample.append(previous[ch])
+        samples.append(sample)
+    if pos != len(payload):
+        raise ValueError('payload length mismatch')
+    return samples
+
+
+class FrameDecoder:
+    """Incremental decoder: feed() bytes, get back a list of decoded frames."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.crc_errors = 0
+        self.sync_errors = 0
+        self.lost_frames = 0
+        self.lost_samples = 0
+        self.last_sequence = None
+        self.next_index = None
+        self.absolute_index = 0
+
+    def feed(self, data):
+        """Returns a list of (first sample count, samples) tuples."""
+        frames = []
+        self.buffer.extend(data)
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                del self.buffer[:-1]
+                return frames
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER_SIZE:
+                return frames
+            channel_count = self.buffer[6]
+            sample_count = self.buffer[7]
+            payload_length = self.buffer[8] | (self.buffer[9] << 8)
+            if not (0 < channel_count <= CHANNEL_MAX
+                    and 0 < sample_count <= FRAME_SAMPLES
+                    and channel_count * sample_count <= payload_length
+                    <= min(3 * channel_count * sample_count, PAYLOAD_MAX)):
+                # a false sync in the data: do not wait for a frame that
+                # cannot exist, resynchronize after this sync instead
+                self.sync_errors += 1
+                del self.buffer[:1]
+                continue
+            frame_length = HEADER_SIZE + payload_length + 2
+            if len(self.buffer) < frame_length:
+                return frames
+            frame = bytes(self.buffer[:frame_length])
+            crc = frame[-2] | (frame[-1] << 8)
+            if crc16_ccitt(frame[2:-2]) != crc:
+                # not a frame, or a corrupted one: resynchronize after this sync
+                self.crc_errors += 1
+                del self.buffer[:1]
+                continue
+            del self.buffer[:frame_length]
+            decoded = self._decode(frame)
+            if decoded is not None:
+                frames.append(decoded)
+
+    def _decode(self, frame):
+        sequence = frame[2] | (frame[3] << 8)
+        index = frame[4] | (frame[5] << 8)
+        channel_count = frame[6]
+        sample_count = frame[7]
+        try:
+            samples = decode_payload(frame[HEADER_SIZE:-2], channel_count, sample_count)
+        except ValueError:
+            self.crc_errors += 1
+            return None
+        if self.last_sequence is not None:
+            self.lost_frames += (sequence - self.last_sequence - 1) & 0xFFFF
+        self.last_sequence = sequence
+        # unwrap the 16-bit sample index into a running count
+        if self.next_index is not None:
+            gap = (index - self.next_index) & 0xFFFF
+            self.lost_samples += gap
+            self.absolute_index += gap
+        first = self.absolute_index
+        self.absolute_index += sample_count
+        self.next_index = (index + sample_count) & 0xFFFF
+        return first, samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('file', nargs='?', help='capture file (raw bytes from the UART)')
+    parser.add_argument('--port', help='serial port to read from (requires pyserial)')
+    parser.add_argument('--baud', type=int, default=625000, help='serial baud rate')
+    parser.add_argument('-o', '--output', help='CSV output file (default: stdout)')
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        source = serial.Serial(args.port, args.baud, timeout=0.1)
+        read = lambda: source.read(4096)
+    elif args.file:
+        source = open(args.file, 'rb')
+        read = lambda: source.read(4096) or None
+    else:
+        parser.error('either a capture file or --port is required')
+
+    out = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.writer(out)
+    decoder = FrameDecoder()
+    try:
+        while True:
+            data = read()
+            if data is None:
+                break
+            for first, samples in decoder.feed(data):
+                for i, sample in enumerate(samples):
+                    writer.writerow([first + i] + sample)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    print('lost frames: %d, lost samples: %d, CRC errors: %d, false syncs: %d'
+          % (decoder.lost_frames, decoder.lost_samples, decoder.crc_errors,
+             decoder.sync_errors), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
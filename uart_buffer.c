@@ -0,0 +1,156 @@
+/**
+ * uart_buffer.c
+ * 
+ * Interrupt-driven diagnostics UART with transmit and receive ring buffers
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart_buffer.h"
+#include "hal.h"
+
+#if MCAF_INCLUDE_BUFFERED_UART
+
+/** Buffered UART state, shared with the UART interrupts */
+static MCAF_UART_BUFFER_T uartBuffer;
+
+void MCAF_UartInit(void)
+{
+    uartBuffer.txHead = 0;
+    uartBuffer.txTail = 0;
+    uartBuffer.rxHead = 0;
+    uartBuffer.rxTail = 0;
+    uartBuffer.txOverruns = 0;
+    uartBuffer.rxOverruns = 0;
+    
+    HAL_UART_TxInterrupt_Disable();
+    HAL_UART_InterruptInitialize();
+    HAL_UART_RxInterrupt_Enable();
+}
+
+bool MCAF_UartIsTxReady(void)
+{
+    return (uint16_t)(uartBuffer.txHead - uartBuffer.txTail) < MCAF_UART_TX_BUFFER_SIZE;
+}
+
+void MCAF_UartWrite(uint8_t data)
+{
+    const uint16_t head = uartBuffer.txHead;
+    if ((uint16_t)(head - uartBuffer.txTail) >= MCAF_UART_TX_BUFFER_SIZE)
+    {
+        ++uartBuffer.txOverruns;
+        return;
+    }
+    uartBuffer.tx[head & (MCAF_UART_TX_BUFFER_SIZE - 1)] = data;
+    uartBuffer.txHead = head + 1;
+    
+    /* The ISR disables its own interrupt once the buffer is empty.
+     * It has higher priority than the main loop, so it cannot
+     * do so between the update of txHead and this point. */
+    HAL_UART_TxInterrupt_Enable();
+}
+
+bool MCAF_UartIsRxReady(void)
+{
+    return uartBuffer.rxHead != uartBuffer.rxTail;
+}
+
+uint8_t MCAF_UartRead(void)
+{
+    const uint16_t tail = uartBuffer.rxTail;
+    if (tail == uartBuffer.rxHead)
+    {
+        return 0;
+    }
+    const uint8_t data = uartBuffer.rx[tail & (MCAF_UART_RX_BUFFER_SIZE - 1)];
+    uartBuffer.rxTail = tail + 1;
+    return data;
+}
+
+/**
+ * Moves received bytes from the UART into the receive buffer.
+ * The flag is cleared before the FIFO is drained, so that a byte arriving
+ * during the drain sets it again rather than being left without an interrupt.
+ */
+void __attribute__((interrupt, auto_psv)) HAL_UART_RX_ISR(void)
+{
+    HAL_UART_RxInterruptFlag_Clear();
+    uint16_t head = uartBuffer.rxHead;
+    while (HAL_UART_IsRxReady())
+    {
+        const uint8_t data = HAL_UART_Read();
+        if ((uint16_t)(head - uartBuffer.rxTail) >= MCAF_UART_RX_BUFFER_SIZE)
+        {
+            ++uartBuffer.rxOverruns;
+        }
+        else
+        {
+            uartBuffer.rx[head & (MCAF_UART_RX_BUFFER_SIZE - 1)] = data;
+            ++head;
+        }
+    }
+    uartBuffer.rxHead = head;
+}
+
+/**
+ * Moves queued bytes from the transmit buffer into the UART,
+ * until either the UART is full or the buffer is empty.
+ */
+void __attribute__((interrupt, auto_psv)) HAL_UART_TX_ISR(void)
+{
+    HAL_UART_TxInterruptFlag_Clear();
+    uint16_t tail = uartBuffer.txTail;
+    const uint16_t head = uartBuffer.txHead;
+    while ((tail != head) && HAL_UART_IsTxReady())
+    {
+        HAL_UART_Write(uartBuffer.tx[tail & (MCAF_UART_TX_BUFFER_SIZE - 1)]);
+        ++tail;
+    }
+    uartBuffer.txTail = tail;
+    if (tail == head)
+    {
+        HAL_UART_TxInterrupt_Disable();
+    }
+}
+
+#endif
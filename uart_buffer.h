@@ -0,0 +1,124 @@
+/**
+ * uart_buffer.h
+ * 
+ * Interrupt-driven diagnostics UART with transmit and receive ring buffers
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __UART_BUFFER_H
+#define __UART_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "parameters/options.h"
+#include "uart_buffer_types.h"
+#if !MCAF_INCLUDE_BUFFERED_UART
+#include "hal.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Diagnostic protocols (X2Cscope, streaming telemetry) use these functions
+ * rather than the HAL_UART functions, so that they never wait on the UART.
+ * Bytes are moved between the ring buffers and the UART in its
+ * interrupts, at line rate, independent of the main loop.
+ * 
+ * All functions except MCAF_UartInit() are executed in the main loop only.
+ * 
+ * With MCAF_INCLUDE_BUFFERED_UART disabled, they fall back
+ * to polling the UART directly.
+ * 
+ * With MCAF_INCLUDE_BUFFERED_UART enabled, MCAF owns the UART interrupts,
+ * so the UART driver must be generated in polled mode (interrupts disabled).
+ */
+
+#if MCAF_INCLUDE_BUFFERED_UART
+
+/**
+ * Initializes the ring buffers and enables the UART receive interrupt.
+ * The UART must have been initialized already.
+ */
+void MCAF_UartInit(void);
+
+/**
+ * Returns whether there is room to queue another byte for transmission.
+ * @return true if MCAF_UartWrite() will accept a byte
+ */
+bool MCAF_UartIsTxReady(void);
+
+/**
+ * Queues one byte for transmission.
+ * If the transmit buffer is full, the byte is dropped and counted.
+ * @param data byte to transmit
+ */
+void MCAF_UartWrite(uint8_t data);
+
+/**
+ * Returns whether any received bytes are waiting to be read.
+ * @return true if MCAF_UartRead() will return a received byte
+ */
+bool MCAF_UartIsRxReady(void);
+
+/**
+ * Reads one received byte.
+ * @return oldest received byte, or 0 if none are waiting
+ */
+uint8_t MCAF_UartRead(void);
+
+#else
+
+inline static void MCAF_UartInit(void) {}
+inline static bool MCAF_UartIsTxReady(void) { return HAL_UART_IsTxReady(); }
+inline static void MCAF_UartWrite(uint8_t data) { HAL_UART_Write(data); }
+inline static bool MCAF_UartIsRxReady(void) { return HAL_UART_IsRxReady(); }
+inline static uint8_t MCAF_UartRead(void) { return HAL_UART_Read(); }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_BUFFER_H */
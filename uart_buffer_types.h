@@ -0,0 +1,84 @@
+/**
+ * uart_buffer_types.h
+ * 
+ * Ring buffers for the interrupt-driven diagnostics UART
+ * 
+ * Component: diagnostics
+ */
+
+/* *********************************************************************
+ *
+ * Motor Control Application Framework
+ * R8/RC38 (commit 128946, build on 2025 Apr 09)
+ *
+ * (c) 2017 - 2023 Microchip Technology Inc. and its subsidiaries. You may use
+ * this software and any derivatives exclusively with Microchip products.
+ *
+ * This software and any accompanying information is for suggestion only.
+ * It does not modify Microchip's standard warranty for its products.
+ * You agree that you are solely responsible for testing the software and
+ * determining its suitability.  Microchip has no obligation to modify,
+ * test, certify, or support the software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE, OR ITS INTERACTION WITH
+ * MICROCHIP PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY
+ * APPLICATION.
+ *
+ * IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL,
+ * PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF
+ * ANY KIND WHATSOEVER RELATED TO THE USE OF THIS SOFTWARE, THE
+ * motorBench(R) DEVELOPMENT SUITE TOOL, PARAMETERS AND GENERATED CODE,
+ * HOWEVER CAUSED, BY END USERS, WHETHER MICROCHIP'S CUSTOMERS OR
+ * CUSTOMER'S CUSTOMERS, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES OR THE DAMAGES ARE FORESEEABLE. TO THE
+ * FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL
+ * CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+ * OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS
+ * SOFTWARE.
+ *
+ * MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+ * THESE TERMS.
+ *
+ * *****************************************************************************/
+
+#ifndef __UART_BUFFER_TYPES_H
+#define __UART_BUFFER_TYPES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Size of the transmit ring buffer in bytes; must be a power of 2 */
+#define MCAF_UART_TX_BUFFER_SIZE 256
+
+/** Size of the receive ring buffer in bytes; must be a power of 2 */
+#define MCAF_UART_RX_BUFFER_SIZE 64
+
+/**
+ * State of the buffered UART
+ * 
+ * Each ring buffer has a single producer and a single consumer;
+ * head and tail are free-running counts, masked when indexing.
+ */
+typedef struct tagMCAF_UART_BUFFER
+{
+    volatile uint16_t txHead;       /** count of bytes queued, written by main loop */
+    volatile uint16_t txTail;       /** count of bytes transmitted, written by ISR */
+    volatile uint16_t rxHead;       /** count of bytes received, written by ISR */
+    volatile uint16_t rxTail;       /** count of bytes consumed, written by main loop */
+    uint16_t txOverruns;            /** number of bytes dropped due to a full tx buffer */
+    uint16_t rxOverruns;            /** number of bytes dropped due to a full rx buffer */
+    uint8_t tx[MCAF_UART_TX_BUFFER_SIZE];   /** transmit ring buffer */
+    uint8_t rx[MCAF_UART_RX_BUFFER_SIZE];   /** receive ring buffer */
+} MCAF_UART_BUFFER_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_BUFFER_TYPES_H */
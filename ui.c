@@ -247,7 +247,10 @@ void __attribute__((naked, noreturn)) MCAF_UiFlashErrorCodeForever(uint16_t code
 {    
     __builtin_disable_interrupts();
     MCAF_UiSetupFlashErrorCode(&errorIndicatorState, code);
-    HAL_PWM_Outputs_Disable();
+    for (uint16_t i = 0; i < MCAF_MOTOR_COUNT; ++i)
+    {
+        HAL_PWM_Outputs_DisableInstance(&halMotorMap[i]);
+    }
     
     MCAF_CareForWatchdog();
 
@@ -54,6 +54,12 @@
 extern "C" {
 #endif
 
+/*
+ * Functions implemented in dsPIC assembly have an equivalent in C
+ * for builds with a host compiler, where __XC16__ is not defined
+ * (tools/stall_detect_eval.py runs stall_detect.c on the host).
+ */
+
 /**
  * Limit the slew rate of an output signal to within positive and negative limits.
  * This is intended to be called at a constant rate delta_t, in which case
@@ -578,6 +584,7 @@ inline static bool UTIL_DirectedLessThanEqual(int16_t a, int16_t b, int16_t dir)
  */
 inline static int16_t UTIL_Abs16(int16_t x)
 {
+#ifdef __XC16__
     asm volatile (
         "   ;UTIL_Abs16\n"
         "   btsc %[x], #15\n"
@@ -587,6 +594,9 @@ inline static int16_t UTIL_Abs16(int16_t x)
         : [x]"+r"(x)
     );
     return x;
+#else
+    return (x >= 0) ? x : (x == INT16_MIN) ? INT16_MAX : -x;
+#endif
 }
 
 /**
@@ -616,6 +626,7 @@ inline static int16_t UTIL_SatAddS16(int16_t x, int16_t y)
      * In either case, if overflow occurs, 
      *    we can use either x or y's most significant bit to decide the result
      */
+#ifdef __XC16__
     int16_t saturated_sum;
     asm volatile (
         "   ;UTIL_SatAddS16\n"
@@ -629,6 +640,10 @@ inline static int16_t UTIL_SatAddS16(int16_t x, int16_t y)
         : [y]"r"(y)
     );
     return x;
+#else
+    const int32_t sum = (int32_t)x + y;
+    return (sum > INT16_MAX) ? INT16_MAX : (sum < INT16_MIN) ? INT16_MIN : sum;
+#endif
 }
 
 /**
@@ -651,6 +666,7 @@ inline static int16_t UTIL_SatSubS16(int16_t x, int16_t y)
      * In either case, if overflow occurs, 
      *    we can use either x or y's most significant bit to decide the result
      */
+#ifdef __XC16__
     int16_t saturated_difference;
     asm volatile (
         "   ;UTIL_SatSubS16\n"
@@ -664,6 +680,10 @@ inline static int16_t UTIL_SatSubS16(int16_t x, int16_t y)
         : [y]"r"(y)
     );
     return x;
+#else
+    const int32_t difference = (int32_t)x - y;
+    return (difference > INT16_MAX) ? INT16_MAX : (difference < INT16_MIN) ? INT16_MIN : difference;
+#endif
 }
 
 /**
@@ -681,6 +701,7 @@ inline static int16_t UTIL_SatSubS16(int16_t x, int16_t y)
  */
 inline static int16_t UTIL_Abs16Approx(int16_t x)
 {
+#ifdef __XC16__
     asm volatile (
         "   ;UTIL_Abs16Approx\n"
         "   btsc %[x], #15\n"
@@ -688,6 +709,9 @@ inline static int16_t UTIL_Abs16Approx(int16_t x)
         : [x]"+r"(x)
     );
     return x;
+#else
+    return (x < 0) ? ~x : x;
+#endif
 }
 
 /**
@@ -746,6 +770,7 @@ inline static int16_t UTIL_DivQ15(int16_t num, int16_t den)
  */
 inline static int16_t UTIL_DivQ15SatPos(int16_t num, int16_t den)
 {
+#ifdef __XC16__
     int16_t quotient;
     int16_t remainder;  // unused, but part of DIVF operation
     
@@ -760,6 +785,10 @@ inline static int16_t UTIL_DivQ15SatPos(int16_t num, int16_t den)
         : "cc", "RCOUNT"
     );
     return quotient;
+#else
+    const int32_t quotient = ((int32_t)num << 15) / den;
+    return ((quotient > INT16_MAX) || (quotient < INT16_MIN)) ? INT16_MAX : quotient;
+#endif
 }
 
 /* ----------------------------------------------------------------------------
@@ -824,18 +853,37 @@ inline static bool UTIL_AbsGreaterThanEqual(int16_t x, int16_t limit)
     return (x <= -limit) || (x >= limit);
 }
 
+/**
+ * Updates a CRC-16-CCITT (polynomial 0x1021, MSB first) with one byte,
+ * without the use of a lookup table.
+ * 
+ * @param crc CRC of the preceding bytes; 0xFFFF before the first byte
+ * @param data next byte
+ * @return updated CRC
+ */
+inline static uint16_t UTIL_Crc16CcittUpdate(uint16_t crc, uint8_t data)
+{
+    uint16_t x = ((crc >> 8) ^ data) & 0xff;
+    x ^= x >> 4;
+    return (crc << 8) ^ (x << 12) ^ (x << 5) ^ x;
+}
+
 /**
  * Repeat NOP (n+1) times
  * @param n argument to the REPEAT instruction
  */
 inline static void UTIL_RepeatNop(uint16_t n)
 {
+#ifdef __XC16__
     asm volatile (
         " ;UTIL_RepeatNop\n"
         "   repeat %[n]\n"
         "   nop"
         :: [n]"r"(n) : "memory"
     );
+#else
+    (void)n;
+#endif
 }
 
 /**
@@ -845,12 +893,16 @@ inline static void UTIL_RepeatNop(uint16_t n)
  */
 inline static uint16_t UTIL_ToggleBit15(uint16_t x)
 {
+#ifdef __XC16__
     asm (
         "    ;UTIL_ToggleBit15\n"
         "    btg %[x], #15\n"
         : [x]"+r"(x)
     );
     return x;    
+#else
+    return x ^ 0x8000;
+#endif
 }
 
 /**
@@ -911,6 +963,7 @@ inline static int16_t UTIL_SatShrS16(int32_t x, uint16_t q)
  */
 inline static uint16_t UTIL_AverageU16(uint16_t a, uint16_t b)
 {
+#ifdef __XC16__
     uint16_t c;
     
     asm (
@@ -921,6 +974,9 @@ inline static uint16_t UTIL_AverageU16(uint16_t a, uint16_t b)
         : [a]"r"(a), [b]"r"(b)
     );
     return c;
+#else
+    return (uint16_t)(((uint32_t)a + b) >> 1);
+#endif
 }
 
 /**
@@ -963,6 +1019,7 @@ inline static int16_t UTIL_AverageS16_asm(int16_t a, int16_t b)
 inline static minmax16_t UTIL_MinMax3_S16(int16_t a, int16_t b, int16_t c)
 {
     /* Sort a,b,c */
+#ifdef __XC16__
     asm (
         "    ;UTIL_MinMax3_S16\n"
         "    cpslt   %[a], %[b]\n"
@@ -975,6 +1032,11 @@ inline static minmax16_t UTIL_MinMax3_S16(int16_t a, int16_t b, int16_t c)
           [b]"+r"(b),
           [c]"+r"(c)
     );
+#else
+    if (a > b) { const int16_t t = a; a = b; b = t; }
+    if (a > c) { const int16_t t = a; a = c; c = t; }
+    if (b > c) { const int16_t t = b; b = c; c = t; }
+#endif
     /* Now a <= b <= c */
 
     minmax16_t result;
@@ -1004,6 +1066,7 @@ inline static int16_t UTIL_ScaleAndClip(int16_t x, int16_t k)
     // sat = intmax - s:  -32768 for negative m, +32767 for positive m
     // if m is either 0 or -1, then m == s
 
+#ifdef __XC16__
     asm volatile (
         ";UTIL_ScaleAndClip\n"
         "   rlc     %[result], %[m]\n"
@@ -1015,6 +1078,11 @@ inline static int16_t UTIL_ScaleAndClip(int16_t x, int16_t k)
         : [intmax]"r"(intmax)
     );
     return result;
+#else
+    (void)m;
+    (void)s;
+    return (result > intmax) ? intmax : (result < INT16_MIN) ? INT16_MIN : result;
+#endif
 }
 
 /**
@@ -1044,6 +1112,7 @@ inline static int16_t UTIL_BidirectionalShiftLeft(int16_t x, int16_t q)
  */
 inline static int16_t UTIL_ApplySign(uint16_t state, int16_t x)
 {
+#ifdef __XC16__
     asm (
         "; UTIL_ApplySign\n"
         "   btss  %[state], #0\n"   // skip if bit 0 set
@@ -1052,6 +1121,9 @@ inline static int16_t UTIL_ApplySign(uint16_t state, int16_t x)
         : [state]"r"(state)
     );
     return x;   
+#else
+    return (state & 1) ? x : (int16_t)-x;
+#endif
 }
 
 /**
@@ -1062,6 +1134,7 @@ inline static int16_t UTIL_ApplySign(uint16_t state, int16_t x)
  */
 inline static int16_t UTIL_CopySign(int16_t sign_source, int16_t x)
 {
+#ifdef __XC16__
     asm (
         "; UTIL_CopySign\n"
         "   btsc  %[src], #15\n"   // skip if bit 15 is clear
@@ -1070,6 +1143,9 @@ inline static int16_t UTIL_CopySign(int16_t sign_source, int16_t x)
         : [src]"r"(sign_source)
     );
     return x;   
+#else
+    return (sign_source < 0) ? (int16_t)-x : x;
+#endif
 }
 
 /**
@@ -1082,6 +1158,7 @@ inline static int16_t UTIL_CopySign(int16_t sign_source, int16_t x)
 inline static minmedmax16_t UTIL_Sort3_S16(int16_t a, int16_t b, int16_t c)
 {
     /* Sort a,b,c */
+#ifdef __XC16__
     asm (
         "    ;UTIL_Sort3_S16\n"
         "    cpslt   %[a], %[b]\n"
@@ -1094,6 +1171,11 @@ inline static minmedmax16_t UTIL_Sort3_S16(int16_t a, int16_t b, int16_t c)
           [b]"+r"(b),
           [c]"+r"(c)
     );
+#else
+    if (a > b) { const int16_t t = a; a = b; b = t; }
+    if (a > c) { const int16_t t = a; a = c; c = t; }
+    if (b > c) { const int16_t t = b; b = c; c = t; }
+#endif
     /* Now a <= b <= c */
 
     minmedmax16_t result;